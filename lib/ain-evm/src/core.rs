@@ -154,10 +154,10 @@ impl EVMCoreService {
     ///
     pub unsafe fn validate_raw_tx(
         &self,
-        tx: &str,
+        tx: &[u8],
         template: &BlockTemplate,
     ) -> Result<ValidateTxInfo> {
-        trace!("[validate_raw_tx] raw transaction : {:#?}", tx);
+        trace!("[validate_raw_tx] raw transaction : {}", hex::encode(tx));
 
         let ValidateTxInfo {
             signed_tx,
@@ -198,7 +198,7 @@ impl EVMCoreService {
             trace!("[validate_raw_tx] max_prepay_fee : {:x?}", max_prepay_fee);
 
             self.tx_cache.set_stateless(
-                String::from(tx),
+                tx.to_vec(),
                 ValidateTxInfo {
                     signed_tx,
                     max_prepay_fee,
@@ -289,13 +289,13 @@ impl EVMCoreService {
     ///
     pub unsafe fn validate_raw_transferdomain_tx(
         &self,
-        tx: &str,
+        tx: &[u8],
         template: &BlockTemplate,
         context: TransferDomainTxInfo,
     ) -> Result<ValidateTxInfo> {
         trace!(
-            "[validate_raw_transferdomain_tx] raw transaction : {:#?}",
-            tx
+            "[validate_raw_transferdomain_tx] raw transaction : {}",
+            hex::encode(tx)
         );
 
         let ValidateTxInfo {
@@ -463,7 +463,7 @@ impl FilterService {
             .iter()
             .flat_map(|pool_tx| {
                 self.tx_cache
-                    .try_get_or_create(pool_tx.data.as_str())
+                    .try_get_or_create_from_hex(pool_tx.data.as_str())
                     .map(|tx| tx.hash())
             })
             .collect();
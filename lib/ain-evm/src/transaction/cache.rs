@@ -2,10 +2,14 @@ use std::num::NonZeroUsize;
 
 use ethereum::{EnvelopedEncodable, TransactionV2};
 use ethereum_types::U256;
+use hex::FromHex;
 use log::trace;
 use lru::LruCache;
 
-use crate::{transaction::SignedTx, Result};
+use crate::{
+    transaction::{SignedTx, TransactionError},
+    Result,
+};
 
 #[derive(Debug, Default)]
 pub struct TransactionCache {
@@ -22,23 +26,28 @@ impl TransactionCache {
     }
 }
 
-/// Signed transactions cache methods
+/// Signed transactions cache methods, keyed by the raw tx bytes
 impl TransactionCache {
-    pub fn try_get_or_create(&self, key: &str) -> Result<SignedTx> {
+    pub fn try_get_or_create(&self, raw_tx: &[u8]) -> Result<SignedTx> {
         let mut guard = self.signed_tx_cache.inner.lock();
-        trace!("[signed-tx-cache]::get: {}", key);
-        let res = guard.try_get_or_insert(key.to_string(), || {
-            trace!("[signed-tx-cache]::create {}", key);
-            SignedTx::try_from(key)
+        trace!("[signed-tx-cache]::get: {}", hex::encode(raw_tx));
+        let res = guard.try_get_or_insert(raw_tx.to_vec(), || {
+            trace!("[signed-tx-cache]::create");
+            SignedTx::try_from(raw_tx)
         })?;
         Ok(res.clone())
     }
 
-    pub fn pre_populate(&self, key: &str, signed_tx: SignedTx) -> Result<()> {
+    pub fn try_get_or_create_from_hex(&self, raw_tx: &str) -> Result<SignedTx> {
+        let raw_tx = <Vec<u8>>::from_hex(raw_tx).map_err(TransactionError::from)?;
+        self.try_get_or_create(&raw_tx)
+    }
+
+    pub fn pre_populate(&self, raw_tx: &[u8], signed_tx: SignedTx) -> Result<()> {
         let mut guard = self.signed_tx_cache.inner.lock();
-        trace!("[signed-tx-cache]::pre_populate: {}", key);
-        let _ = guard.get_or_insert(key.to_string(), move || {
-            trace!("[signed-tx-cache]::pre_populate:: create {}", key);
+        trace!("[signed-tx-cache]::pre_populate: {}", hex::encode(raw_tx));
+        let _ = guard.get_or_insert(raw_tx.to_vec(), move || {
+            trace!("[signed-tx-cache]::pre_populate:: create");
             signed_tx
         });
 
@@ -47,12 +56,11 @@ impl TransactionCache {
 
     pub fn try_get_or_create_from_tx(&self, tx: &TransactionV2) -> Result<SignedTx> {
         let data = EnvelopedEncodable::encode(tx);
-        let key = hex::encode(&data);
         let mut guard = self.signed_tx_cache.inner.lock();
-        trace!("[signed-tx-cache]::get from tx: {}", &key);
-        let res = guard.try_get_or_insert(key.clone(), || {
-            trace!("[signed-tx-cache]::create from tx {}", &key);
-            SignedTx::try_from(key.as_str())
+        trace!("[signed-tx-cache]::get from tx: {}", hex::encode(&data));
+        let res = guard.try_get_or_insert(data.to_vec(), || {
+            trace!("[signed-tx-cache]::create from tx");
+            SignedTx::try_from(&data[..])
         })?;
         Ok(res.clone())
     }
@@ -60,11 +68,11 @@ impl TransactionCache {
 
 /// Transaction validation cache methods
 impl TransactionCache {
-    pub fn get_stateless(&self, key: &str) -> Option<ValidateTxInfo> {
+    pub fn get_stateless(&self, key: &[u8]) -> Option<ValidateTxInfo> {
         self.tx_validation_cache.stateless.lock().get(key).cloned()
     }
 
-    pub fn set_stateless(&self, key: String, value: ValidateTxInfo) -> ValidateTxInfo {
+    pub fn set_stateless(&self, key: Vec<u8>, value: ValidateTxInfo) -> ValidateTxInfo {
         let mut cache = self.tx_validation_cache.stateless.lock();
         cache.put(key, value.clone());
         value
@@ -73,7 +81,7 @@ impl TransactionCache {
 
 #[derive(Debug)]
 pub struct SignedTxCache {
-    inner: spin::Mutex<LruCache<String, SignedTx>>,
+    inner: spin::Mutex<LruCache<Vec<u8>, SignedTx>>,
 }
 
 impl Default for SignedTxCache {
@@ -98,7 +106,7 @@ pub struct ValidateTxInfo {
 
 #[derive(Debug)]
 pub struct TxValidationCache {
-    stateless: spin::Mutex<LruCache<String, ValidateTxInfo>>,
+    stateless: spin::Mutex<LruCache<Vec<u8>, ValidateTxInfo>>,
 }
 
 impl Default for TxValidationCache {
@@ -198,7 +198,15 @@ impl TryFrom<&str> for SignedTx {
 
     fn try_from(src: &str) -> Result<Self, Self::Error> {
         let buffer = <Vec<u8>>::from_hex(src)?;
-        let tx: TransactionV2 = ethereum::EnvelopedDecodable::decode(&buffer)?;
+        Self::try_from(buffer.as_slice())
+    }
+}
+
+impl TryFrom<&[u8]> for SignedTx {
+    type Error = TransactionError;
+
+    fn try_from(src: &[u8]) -> Result<Self, Self::Error> {
+        let tx: TransactionV2 = ethereum::EnvelopedDecodable::decode(src)?;
 
         tx.try_into()
     }
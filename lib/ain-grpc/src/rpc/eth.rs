@@ -711,7 +711,7 @@ impl MetachainRPCServer for MetachainRPCModule {
                 .handler
                 .core
                 .tx_cache
-                .try_get_or_create(raw_tx)
+                .try_get_or_create_from_hex(raw_tx)
                 .map_err(RPCError::EvmError)?;
 
             trace!(target:"rpc",
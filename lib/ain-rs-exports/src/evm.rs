@@ -275,7 +275,7 @@ fn evm_try_unsafe_remove_txs_above_hash_in_template(
 #[ffi_fallible]
 fn evm_try_unsafe_add_balance_in_template(
     template: &mut BlockTemplateWrapper,
-    raw_tx: &str,
+    raw_tx: &[u8],
     native_hash: XHash,
 ) -> Result<()> {
     let signed_tx = SERVICES.evm.core.tx_cache.try_get_or_create(raw_tx)?;
@@ -301,7 +301,7 @@ fn evm_try_unsafe_add_balance_in_template(
 #[ffi_fallible]
 fn evm_try_unsafe_sub_balance_in_template(
     template: &mut BlockTemplateWrapper,
-    raw_tx: &str,
+    raw_tx: &[u8],
     native_hash: XHash,
 ) -> Result<bool> {
     let signed_tx = SERVICES.evm.core.tx_cache.try_get_or_create(raw_tx)?;
@@ -324,7 +324,7 @@ fn evm_try_unsafe_sub_balance_in_template(
 ///
 /// * `result` - Result object
 /// * `template` - The EVM BlockTemplate
-/// * `tx` - The raw transaction string.
+/// * `tx` - The raw transaction bytes.
 ///
 /// # Errors
 ///
@@ -344,7 +344,7 @@ fn evm_try_unsafe_sub_balance_in_template(
 #[ffi_fallible]
 fn evm_try_unsafe_validate_raw_tx_in_template(
     template: &BlockTemplateWrapper,
-    raw_tx: &str,
+    raw_tx: &[u8],
 ) -> Result<()> {
     trace!("[unsafe_validate_raw_tx_in_template]");
     unsafe {
@@ -362,7 +362,7 @@ fn evm_try_unsafe_validate_raw_tx_in_template(
 ///
 /// * `result` - Result object
 /// * `template` - The EVM BlockTemplate
-/// * `tx` - The raw transaction string.
+/// * `tx` - The raw transaction bytes.
 ///
 /// # Errors
 ///
@@ -381,7 +381,7 @@ fn evm_try_unsafe_validate_raw_tx_in_template(
 #[ffi_fallible]
 fn evm_try_unsafe_validate_transferdomain_tx_in_template(
     template: &BlockTemplateWrapper,
-    raw_tx: &str,
+    raw_tx: &[u8],
     context: ffi::TransferDomainInfo,
 ) -> Result<()> {
     trace!("[unsafe_validate_transferdomain_tx_in_template]");
@@ -479,7 +479,7 @@ fn evm_try_unsafe_remove_template(template: &mut BlockTemplateWrapper) -> Result
 /// # Arguments
 ///
 /// * `template` - The EVM BlockTemplate.
-/// * `raw_tx` - The raw transaction string.
+/// * `raw_tx` - The raw transaction bytes.
 /// * `hash` - The native transaction hash.
 ///
 /// # Errors
@@ -491,7 +491,7 @@ fn evm_try_unsafe_remove_template(template: &mut BlockTemplateWrapper) -> Result
 #[ffi_fallible]
 fn evm_try_unsafe_push_tx_in_template(
     template: &mut BlockTemplateWrapper,
-    raw_tx: &str,
+    raw_tx: &[u8],
     native_hash: XHash,
 ) -> Result<ffi::ValidateTxCompletion> {
     unsafe {
@@ -746,7 +746,7 @@ fn evm_try_unsafe_create_dst20(
 #[ffi_fallible]
 fn evm_try_unsafe_bridge_dst20(
     template: &mut BlockTemplateWrapper,
-    raw_tx: &str,
+    raw_tx: &[u8],
     native_hash: XHash,
     token_id: u64,
     out: bool,
@@ -769,25 +769,25 @@ fn evm_try_unsafe_bridge_dst20(
 /// Retrieves a raw tx's transaction hash
 /// # Arguments
 ///
-/// * `raw_tx` - The transaction as raw hex
+/// * `raw_tx` - The raw transaction bytes
 ///
 /// # Returns
 ///
 /// Returns the transaction's hash
 #[ffi_fallible]
-fn evm_try_get_tx_hash(raw_tx: &str) -> Result<XHash> {
+fn evm_try_get_tx_hash(raw_tx: &[u8]) -> Result<XHash> {
     let signed_tx = SERVICES.evm.core.tx_cache.try_get_or_create(raw_tx)?;
     Ok(signed_tx.hash().to_fixed_bytes())
 }
 
 #[ffi_fallible]
-fn evm_try_unsafe_make_signed_tx(raw_tx: &str) -> Result<usize> {
+fn evm_try_unsafe_make_signed_tx(raw_tx: &[u8]) -> Result<usize> {
     let ptr = Box::leak(Box::new(SignedTx::try_from(raw_tx)?));
     Ok(ptr as *const SignedTx as usize)
 }
 
 #[ffi_fallible]
-fn evm_try_unsafe_cache_signed_tx(raw_tx: &str, instance: usize) -> Result<()> {
+fn evm_try_unsafe_cache_signed_tx(raw_tx: &[u8], instance: usize) -> Result<()> {
     let signed_tx = unsafe { Box::from_raw(instance as *mut SignedTx) };
     SERVICES
         .evm
@@ -820,7 +820,7 @@ fn evm_try_unsafe_is_smart_contract_in_template(
 }
 
 #[ffi_fallible]
-fn evm_try_get_tx_miner_info_from_raw_tx(raw_tx: &str, mnview_ptr: usize) -> Result<TxMinerInfo> {
+fn evm_try_get_tx_miner_info_from_raw_tx(raw_tx: &[u8], mnview_ptr: usize) -> Result<TxMinerInfo> {
     let evm_services = &SERVICES.evm;
 
     let signed_tx = evm_services.core.tx_cache.try_get_or_create(raw_tx)?;
@@ -846,7 +846,7 @@ fn evm_try_get_tx_miner_info_from_raw_tx(raw_tx: &str, mnview_ptr: usize) -> Res
 }
 
 #[ffi_fallible]
-fn evm_try_dispatch_pending_transactions_event(raw_tx: &str) -> Result<()> {
+fn evm_try_dispatch_pending_transactions_event(raw_tx: &[u8]) -> Result<()> {
     let signed_tx = SERVICES.evm.core.tx_cache.try_get_or_create(raw_tx)?;
     SERVICES
         .evm
@@ -212,34 +212,34 @@ pub mod ffi {
         fn evm_try_unsafe_add_balance_in_template(
             result: &mut CrossBoundaryResult,
             block_template: &mut BlockTemplateWrapper,
-            raw_tx: &str,
+            raw_tx: &[u8],
             native_hash: [u8; 32],
         );
 
         fn evm_try_unsafe_sub_balance_in_template(
             result: &mut CrossBoundaryResult,
             block_template: &mut BlockTemplateWrapper,
-            raw_tx: &str,
+            raw_tx: &[u8],
             native_hash: [u8; 32],
         ) -> bool;
 
         fn evm_try_unsafe_validate_raw_tx_in_template(
             result: &mut CrossBoundaryResult,
             block_template: &BlockTemplateWrapper,
-            raw_tx: &str,
+            raw_tx: &[u8],
         );
 
         fn evm_try_unsafe_validate_transferdomain_tx_in_template(
             result: &mut CrossBoundaryResult,
             block_template: &BlockTemplateWrapper,
-            raw_tx: &str,
+            raw_tx: &[u8],
             context: TransferDomainInfo,
         );
 
         fn evm_try_unsafe_push_tx_in_template(
             result: &mut CrossBoundaryResult,
             block_template: &mut BlockTemplateWrapper,
-            raw_tx: &str,
+            raw_tx: &[u8],
             native_hash: [u8; 32],
         ) -> ValidateTxCompletion;
 
@@ -299,13 +299,13 @@ pub mod ffi {
             tx_hash: [u8; 32],
         ) -> EVMTransaction;
 
-        fn evm_try_get_tx_hash(result: &mut CrossBoundaryResult, raw_tx: &str) -> [u8; 32];
+        fn evm_try_get_tx_hash(result: &mut CrossBoundaryResult, raw_tx: &[u8]) -> [u8; 32];
 
-        fn evm_try_unsafe_make_signed_tx(result: &mut CrossBoundaryResult, raw_tx: &str) -> usize;
+        fn evm_try_unsafe_make_signed_tx(result: &mut CrossBoundaryResult, raw_tx: &[u8]) -> usize;
 
         fn evm_try_unsafe_cache_signed_tx(
             result: &mut CrossBoundaryResult,
-            raw_tx: &str,
+            raw_tx: &[u8],
             instance: usize,
         );
 
@@ -319,7 +319,7 @@ pub mod ffi {
         fn evm_try_unsafe_bridge_dst20(
             result: &mut CrossBoundaryResult,
             block_template: &mut BlockTemplateWrapper,
-            raw_tx: &str,
+            raw_tx: &[u8],
             native_hash: [u8; 32],
             token_id: u64,
             out: bool,
@@ -333,13 +333,13 @@ pub mod ffi {
 
         fn evm_try_get_tx_miner_info_from_raw_tx(
             result: &mut CrossBoundaryResult,
-            raw_tx: &str,
+            raw_tx: &[u8],
             mnview_ptr: usize,
         ) -> TxMinerInfo;
 
         fn evm_try_dispatch_pending_transactions_event(
             result: &mut CrossBoundaryResult,
-            raw_tx: &str,
+            raw_tx: &[u8],
         );
 
         fn evm_try_flush_db(result: &mut CrossBoundaryResult);
@@ -0,0 +1,163 @@
+// Copyright (c) DeFi Blockchain Developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <bench/dfi_util.h>
+#include <chainparams.h>
+#include <coins.h>
+#include <dfi/mn_checks.h>
+#include <validation.h>
+
+static constexpr uint32_t BENCH_HEIGHT{1000};
+static constexpr uint64_t BENCH_TIME{1600000000};
+
+// Every run applies the transaction on a fresh child of the prepared state,
+// so balances never drain and each run does the same amount of work.
+static void RunApplyCustomTx(benchmark::State &state,
+                             CCustomCSView &base,
+                             const CCoinsViewCache &coins,
+                             const CTransaction &tx) {
+    while (state.KeepRunning()) {
+        CCustomCSView view(base);
+        BlockContext blockCtx{BENCH_HEIGHT, BENCH_TIME, Params().GetConsensus(), &view, false};
+        TransactionContext txCtx{coins, tx, blockCtx};
+        const auto res = ApplyCustomTx(blockCtx, txCtx);
+        assert(res);
+    }
+}
+
+struct CustomTxBenchState {
+    CScript owner{BenchOwner(0)};
+    DCT_ID dfi{0}, btc, eth, btcPool, ethPool;
+    CCustomCSView view{*pcustomcsview};
+    CCoinsViewCache coins{&::ChainstateActive().CoinsTip()};
+    COutPoint auth{AddBenchAuthCoin(coins, owner)};
+
+    CustomTxBenchState() {
+        btc = CreateBenchToken(view, "BTC");
+        eth = CreateBenchToken(view, "ETH");
+        btcPool = CreateBenchPool(view, btc, dfi, 1000 * COIN, 10000000 * COIN);
+        ethPool = CreateBenchPool(view, eth, dfi, 50000 * COIN, 10000000 * COIN);
+
+        auto res = view.AddBalance(owner, {dfi, 100000 * COIN});
+        assert(res);
+        res = view.AddBalance(owner, {btc, 100 * COIN});
+        assert(res);
+    }
+};
+
+static void ApplyCustomTxAccountToAccount(benchmark::State &state) {
+    DeFiForksScope forks;
+    LOCK(cs_main);
+    CustomTxBenchState s;
+
+    CAccountToAccountMessage msg{};
+    msg.from = s.owner;
+    for (uint32_t i = 1; i <= 10; ++i) {
+        msg.to.emplace(BenchOwner(i), CBalances{{{s.dfi, COIN}}});
+    }
+    const auto tx = CreateBenchCustomTx(CustomTxType::AccountToAccount, msg, s.auth, s.owner);
+
+    RunApplyCustomTx(state, s.view, s.coins, tx);
+}
+
+static void ApplyCustomTxPoolSwap(benchmark::State &state) {
+    DeFiForksScope forks;
+    LOCK(cs_main);
+    CustomTxBenchState s;
+
+    CPoolSwapMessage msg{};
+    msg.from = msg.to = s.owner;
+    msg.idTokenFrom = s.btc;
+    msg.idTokenTo = s.dfi;
+    msg.amountFrom = COIN / 10;
+    msg.maxPrice = PoolPrice::getMaxValid();
+    const auto tx = CreateBenchCustomTx(CustomTxType::PoolSwap, msg, s.auth, s.owner);
+
+    RunApplyCustomTx(state, s.view, s.coins, tx);
+}
+
+static void ApplyCustomTxCompositeSwap(benchmark::State &state) {
+    DeFiForksScope forks;
+    LOCK(cs_main);
+    CustomTxBenchState s;
+
+    CPoolSwapMessageV2 msg{};
+    msg.swapInfo.from = msg.swapInfo.to = s.owner;
+    msg.swapInfo.idTokenFrom = s.btc;
+    msg.swapInfo.idTokenTo = s.eth;
+    msg.swapInfo.amountFrom = COIN / 10;
+    msg.swapInfo.maxPrice = PoolPrice::getMaxValid();
+    msg.poolIDs = {s.btcPool, s.ethPool};
+    const auto tx = CreateBenchCustomTx(CustomTxType::PoolSwapV2, msg, s.auth, s.owner);
+
+    RunApplyCustomTx(state, s.view, s.coins, tx);
+}
+
+struct VaultBenchState : CustomTxBenchState {
+    DCT_ID tsla;
+    CVaultId vaultId{uint256S("0xfa017")};
+
+    VaultBenchState() {
+        tsla = CreateBenchToken(view, "TSLA");
+        SetBenchCollateralToken(view, dfi, "DFI");
+        SetBenchLoanToken(view, tsla, "TSLA", COIN / 20);
+        SetBenchPrice(view, "DFI", 2 * COIN);
+        SetBenchPrice(view, "TSLA", 200 * COIN);
+
+        CLoanSchemeMessage scheme{};
+        scheme.identifier = "BENCH";
+        scheme.ratio = 150;
+        scheme.rate = COIN / 100;
+        auto res = view.StoreLoanScheme(scheme);
+        assert(res);
+
+        CVaultData vault{};
+        vault.ownerAddress = owner;
+        vault.schemeId = scheme.identifier;
+        res = view.StoreVault(vaultId, vault);
+        assert(res);
+
+        // existing position, new loans go through the interest update path
+        res = view.AddVaultCollateral(vaultId, {dfi, 10000 * COIN});
+        assert(res);
+        res = view.AddLoanToken(vaultId, {tsla, 10 * COIN});
+        assert(res);
+        res = view.IncreaseInterest(1, vaultId, scheme.identifier, tsla, COIN / 20, 10 * COIN);
+        assert(res);
+    }
+};
+
+static void ApplyCustomTxDepositToVault(benchmark::State &state) {
+    DeFiForksScope forks;
+    LOCK(cs_main);
+    VaultBenchState s;
+
+    CDepositToVaultMessage msg{};
+    msg.vaultId = s.vaultId;
+    msg.from = s.owner;
+    msg.amount = {s.dfi, 10 * COIN};
+    const auto tx = CreateBenchCustomTx(CustomTxType::DepositToVault, msg, s.auth, s.owner);
+
+    RunApplyCustomTx(state, s.view, s.coins, tx);
+}
+
+static void ApplyCustomTxTakeLoan(benchmark::State &state) {
+    DeFiForksScope forks;
+    LOCK(cs_main);
+    VaultBenchState s;
+
+    CLoanTakeLoanMessage msg{};
+    msg.vaultId = s.vaultId;
+    msg.amounts = CBalances{{{s.tsla, COIN}}};
+    const auto tx = CreateBenchCustomTx(CustomTxType::TakeLoan, msg, s.auth, s.owner);
+
+    RunApplyCustomTx(state, s.view, s.coins, tx);
+}
+
+BENCHMARK(ApplyCustomTxAccountToAccount, 2000);
+BENCHMARK(ApplyCustomTxPoolSwap, 1000);
+BENCHMARK(ApplyCustomTxCompositeSwap, 500);
+BENCHMARK(ApplyCustomTxDepositToVault, 1000);
+BENCHMARK(ApplyCustomTxTakeLoan, 500);
@@ -0,0 +1,87 @@
+// Copyright (c) DeFi Blockchain Developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#include <arith_uint256.h>
+#include <bench/bench.h>
+#include <bench/dfi_util.h>
+#include <validation.h>
+
+static constexpr uint32_t ENTRIES{10000};
+
+// Iterations merge a large pending layer with a sparse layer of updates on top,
+// the shape of a transaction cache over a block cache.
+static void CustomViewIterateBalances(benchmark::State &state) {
+    LOCK(cs_main);
+    CCustomCSView base(*pcustomcsview);
+    for (uint32_t i = 0; i < ENTRIES; ++i) {
+        const auto res = base.AddBalance(BenchOwner(i), {DCT_ID{i % 4}, COIN});
+        assert(res);
+    }
+    CCustomCSView view(base);
+    for (uint32_t i = 0; i < ENTRIES; i += 10) {
+        const auto res = view.AddBalance(BenchOwner(i), {DCT_ID{i % 4}, COIN});
+        assert(res);
+    }
+
+    while (state.KeepRunning()) {
+        uint32_t count{};
+        view.ForEachBalance([&](const CScript &, const CTokenAmount &) {
+            ++count;
+            return true;
+        });
+        assert(count == ENTRIES);
+    }
+}
+
+static void CustomViewIterateVaults(benchmark::State &state) {
+    LOCK(cs_main);
+    CCustomCSView base(*pcustomcsview);
+    for (uint32_t i = 0; i < ENTRIES; ++i) {
+        CVaultData vault{};
+        vault.ownerAddress = BenchOwner(i);
+        vault.schemeId = "BENCH";
+        const auto res = base.StoreVault(ArithToUint256(arith_uint256(i + 1)), vault);
+        assert(res);
+    }
+    CCustomCSView view(base);
+    for (uint32_t i = 0; i < ENTRIES; i += 10) {
+        const auto res = view.AddVaultCollateral(ArithToUint256(arith_uint256(i + 1)), {DCT_ID{0}, COIN});
+        assert(res);
+    }
+
+    while (state.KeepRunning()) {
+        CAmount collateral{};
+        view.ForEachVault([&](const CVaultId &vaultId, const CVaultData &) {
+            if (const auto amounts = view.GetVaultCollaterals(vaultId)) {
+                collateral += amounts->balances.at(DCT_ID{0});
+            }
+            return true;
+        });
+        assert(collateral == ENTRIES / 10 * COIN);
+    }
+}
+
+static void CustomViewIteratePoolPairs(benchmark::State &state) {
+    DeFiForksScope forks;
+    LOCK(cs_main);
+    CCustomCSView view(*pcustomcsview);
+    const DCT_ID dfi{0};
+    for (uint32_t i = 0; i < 200; ++i) {
+        const auto token = CreateBenchToken(view, "T" + std::to_string(i));
+        CreateBenchPool(view, token, dfi, 1000 * COIN, 1000 * COIN);
+    }
+
+    while (state.KeepRunning()) {
+        CAmount reserves{};
+        view.ForEachPoolPair([&](const DCT_ID &, const CPoolPair &pool) {
+            reserves += pool.reserveA;
+            return true;
+        });
+        assert(reserves == 200 * 1000 * COIN);
+    }
+}
+
+BENCHMARK(CustomViewIterateBalances, 20);
+BENCHMARK(CustomViewIterateVaults, 20);
+BENCHMARK(CustomViewIteratePoolPairs, 100);
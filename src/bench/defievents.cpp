@@ -0,0 +1,167 @@
+// Copyright (c) DeFi Blockchain Developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#include <arith_uint256.h>
+#include <bench/bench.h>
+#include <bench/dfi_util.h>
+#include <chainparams.h>
+#include <coins.h>
+#include <dfi/govvariables/attributes.h>
+#include <dfi/mn_checks.h>
+#include <dfi/threadpool.h>
+#include <dfi/validation.h>
+#include <primitives/block.h>
+#include <validation.h>
+
+static constexpr uint64_t BENCH_TIME{1600000000};
+
+// The subsystems of ProcessDeFiEvent are gated on the block height, each bench
+// seeds the state of one subsystem and picks a height at which it runs.
+static void RunDeFiEvent(benchmark::State &state, CCustomCSView &base, uint32_t height) {
+    if (!DfTxTaskPool) {
+        InitDfTxGlobalTaskPool();
+    }
+
+    BenchBlockIndex block(height, BENCH_TIME);
+    CCoinsViewCache coins(&::ChainstateActive().CoinsTip());
+    const CBlock emptyBlock;
+    const CreationTxs creationTxs;
+
+    while (state.KeepRunning()) {
+        CCustomCSView view(base);
+        BlockContext blockCtx{height, BENCH_TIME, Params().GetConsensus(), &view, false};
+        ProcessDeFiEvent(emptyBlock, &block.index, coins, creationTxs, blockCtx);
+    }
+}
+
+static void DeFiEventPoolRewards(benchmark::State &state) {
+    DeFiForksScope forks;
+    LOCK(cs_main);
+    CCustomCSView view(*pcustomcsview);
+
+    constexpr uint32_t pools{50};
+    const DCT_ID dfi{0};
+    for (uint32_t i = 0; i < pools; ++i) {
+        const auto token = CreateBenchToken(view, "T" + std::to_string(i));
+        const auto pool = CreateBenchPool(view, token, dfi, 1000 * COIN, 100000 * COIN);
+        const auto res = view.SetRewardPct(pool, 1, COIN / pools);
+        assert(res);
+    }
+    const auto res = view.AddCommunityBalance(CommunityAccountType::IncentiveFunding, 1000000 * COIN);
+    assert(res);
+
+    // off the loan and oracle intervals
+    RunDeFiEvent(state, view, 1001);
+}
+
+static void DeFiEventLoans(benchmark::State &state) {
+    DeFiForksScope forks;
+    LOCK(cs_main);
+    CCustomCSView view(*pcustomcsview);
+
+    const DCT_ID dfi{0};
+    const auto tsla = CreateBenchToken(view, "TSLA");
+    SetBenchCollateralToken(view, dfi, "DFI");
+    SetBenchLoanToken(view, tsla, "TSLA", COIN / 20);
+    SetBenchPrice(view, "DFI", 2 * COIN);
+    SetBenchPrice(view, "TSLA", 200 * COIN);
+
+    CLoanSchemeMessage scheme{};
+    scheme.identifier = "BENCH";
+    scheme.ratio = 150;
+    scheme.rate = COIN / 100;
+    auto res = view.StoreLoanScheme(scheme);
+    assert(res);
+
+    // healthy vaults, every one of them gets its collateral ratio checked
+    for (uint32_t i = 0; i < 500; ++i) {
+        const CVaultId vaultId{ArithToUint256(arith_uint256(i + 1))};
+        CVaultData vault{};
+        vault.ownerAddress = BenchOwner(i);
+        vault.schemeId = scheme.identifier;
+        res = view.StoreVault(vaultId, vault);
+        assert(res);
+        res = view.AddVaultCollateral(vaultId, {dfi, 10000 * COIN});
+        assert(res);
+        res = view.AddLoanToken(vaultId, {tsla, 10 * COIN});
+        assert(res);
+        res = view.IncreaseInterest(1, vaultId, scheme.identifier, tsla, COIN / 20, 10 * COIN);
+        assert(res);
+    }
+
+    const auto interval = Params().GetConsensus().blocksCollateralizationRatioCalculation();
+    RunDeFiEvent(state, view, interval * 41);
+}
+
+static void DeFiEventOracles(benchmark::State &state) {
+    DeFiForksScope forks;
+    LOCK(cs_main);
+    CCustomCSView view(*pcustomcsview);
+
+    constexpr uint32_t tokens{20};
+    std::set<CTokenCurrencyPair> pairs;
+    for (uint32_t i = 0; i < tokens; ++i) {
+        const auto symbol = "T" + std::to_string(i);
+        pairs.emplace(symbol, "USD");
+        SetBenchPrice(view, symbol, COIN);
+    }
+
+    for (uint32_t i = 0; i < 20; ++i) {
+        COracle oracle{};
+        oracle.oracleAddress = BenchOwner(i);
+        oracle.weightage = 10;
+        oracle.availablePairs = pairs;
+        for (const auto &[token, currency] : pairs) {
+            const auto res = oracle.SetTokenPrice(token, currency, COIN + i, BENCH_TIME);
+            assert(res);
+        }
+        const auto res = view.AppointOracle(ArithToUint256(arith_uint256(i + 1)), oracle);
+        assert(res);
+    }
+
+    RunDeFiEvent(state, view, view.GetIntervalBlock() * 10);
+}
+
+static void DeFiEventFutures(benchmark::State &state) {
+    DeFiForksScope forks;
+    LOCK(cs_main);
+    CCustomCSView view(*pcustomcsview);
+
+    const auto dusd = CreateBenchToken(view, "DUSD");
+    const auto tsla = CreateBenchToken(view, "TSLA");
+    SetBenchLoanToken(view, dusd, "DUSD", 0);
+    SetBenchLoanToken(view, tsla, "TSLA", 0);
+    SetBenchPrice(view, "DUSD", COIN);
+    SetBenchPrice(view, "TSLA", 200 * COIN);
+
+    auto attributes = view.GetMutableAttributes();
+    attributes->SetValue(CDataStructureV0{AttributeTypes::Param, ParamIDs::DFIP2203, DFIPKeys::Active}, true);
+    attributes->SetValue(CDataStructureV0{AttributeTypes::Param, ParamIDs::DFIP2203, DFIPKeys::BlockPeriod},
+                         CAmount{10});
+    attributes->SetValue(CDataStructureV0{AttributeTypes::Param, ParamIDs::DFIP2203, DFIPKeys::RewardPct},
+                         COIN / 20);
+    auto res = view.SetVariable(*attributes);
+    assert(res);
+
+    // settlement block, off the loan and oracle intervals
+    constexpr uint32_t height{1010};
+    for (uint32_t i = 0; i < 1000; ++i) {
+        CFuturesUserValue futures{};
+        if (i % 2) {
+            futures.source = {dusd, 200 * COIN};
+            futures.destination = tsla.v;
+        } else {
+            futures.source = {tsla, COIN};
+        }
+        res = view.StoreFuturesUserValues({height - 1, BenchOwner(i), i}, futures);
+        assert(res);
+    }
+
+    RunDeFiEvent(state, view, height);
+}
+
+BENCHMARK(DeFiEventPoolRewards, 50);
+BENCHMARK(DeFiEventLoans, 20);
+BENCHMARK(DeFiEventOracles, 50);
+BENCHMARK(DeFiEventFutures, 20);
@@ -0,0 +1,139 @@
+// Copyright (c) DeFi Blockchain Developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/dfi_util.h>
+
+#include <arith_uint256.h>
+#include <chainparams.h>
+#include <coins.h>
+#include <crypto/common.h>
+#include <dfi/govvariables/attributes.h>
+#include <dfi/mn_checks.h>
+#include <script/standard.h>
+
+#include <cassert>
+
+static Consensus::Params &MutableConsensus() {
+    return const_cast<Consensus::Params &>(Params().GetConsensus());
+}
+
+DeFiForksScope::DeFiForksScope()
+    : saved(Params().GetConsensus()) {
+    auto &consensus = MutableConsensus();
+    for (auto height : {&consensus.DF1AMKHeight,
+                        &consensus.DF2BayfrontHeight,
+                        &consensus.DF3BayfrontMarinaHeight,
+                        &consensus.DF4BayfrontGardensHeight,
+                        &consensus.DF5ClarkeQuayHeight,
+                        &consensus.DF6DakotaHeight,
+                        &consensus.DF7DakotaCrescentHeight,
+                        &consensus.DF8EunosHeight,
+                        &consensus.DF9EunosKampungHeight,
+                        &consensus.DF10EunosPayaHeight,
+                        &consensus.DF11FortCanningHeight,
+                        &consensus.DF12FortCanningMuseumHeight,
+                        &consensus.DF13FortCanningParkHeight,
+                        &consensus.DF14FortCanningHillHeight,
+                        &consensus.DF15FortCanningRoadHeight,
+                        &consensus.DF16FortCanningCrunchHeight,
+                        &consensus.DF17FortCanningSpringHeight,
+                        &consensus.DF18FortCanningGreatWorldHeight,
+                        &consensus.DF19FortCanningEpilogueHeight,
+                        &consensus.DF20GrandCentralHeight,
+                        &consensus.DF21GrandCentralEpilogueHeight}) {
+        *height = 1;
+    }
+}
+
+DeFiForksScope::~DeFiForksScope() {
+    MutableConsensus() = saved;
+}
+
+BenchBlockIndex::BenchBlockIndex(int height, uint32_t time)
+    : hash(uint256S("0xbe7c4")) {
+    index.phashBlock = &hash;
+    index.nHeight = height;
+    index.nTime = time;
+}
+
+CScript BenchOwner(uint32_t n) {
+    uint160 hash;
+    WriteLE32(hash.begin(), n + 1);
+    return GetScriptForDestination(PKHash(hash));
+}
+
+DCT_ID CreateBenchToken(CCustomCSView &view, const std::string &symbol) {
+    static uint32_t txs_counter{1};
+
+    CTokenImplementation token;
+    token.symbol = symbol;
+    token.name = symbol;
+    token.creationTx = ArithToUint256(arith_uint256(txs_counter++) << 128);
+    token.flags = static_cast<uint8_t>(CToken::TokenFlags::Default) | static_cast<uint8_t>(CToken::TokenFlags::DAT);
+
+    BlockContext blockCtx{std::numeric_limits<uint32_t>::max(), {}, Params().GetConsensus(), &view, false};
+    const auto res = view.CreateToken(token, blockCtx);
+    assert(res);
+    return *res.val;
+}
+
+DCT_ID CreateBenchPool(CCustomCSView &view, DCT_ID idA, DCT_ID idB, CAmount reserveA, CAmount reserveB) {
+    const auto tokenA = view.GetToken(idA);
+    const auto tokenB = view.GetToken(idB);
+    assert(tokenA && tokenB);
+    const auto idPool = CreateBenchToken(view, tokenA->symbol + "-" + tokenB->symbol);
+
+    CPoolPair pool{};
+    pool.idTokenA = idA;
+    pool.idTokenB = idB;
+    pool.commission = COIN / 500;
+    pool.status = true;
+    auto res = view.SetPoolPair(idPool, 1, pool);
+    assert(res);
+
+    // second write records reserves and liquidity at height 1
+    pool.reserveA = reserveA;
+    pool.reserveB = reserveB;
+    pool.totalLiquidity = CPoolPair::MINIMUM_LIQUIDITY + std::min(reserveA, reserveB);
+    res = view.SetPoolPair(idPool, 1, pool);
+    assert(res);
+    return idPool;
+}
+
+void SetBenchPrice(CCustomCSView &view, const std::string &symbol, CAmount price) {
+    CFixedIntervalPrice fixedIntervalPrice{};
+    fixedIntervalPrice.priceFeedId = {symbol, "USD"};
+    fixedIntervalPrice.priceRecord[0] = price;
+    fixedIntervalPrice.priceRecord[1] = price;
+    const auto res = view.SetFixedIntervalPrice(fixedIntervalPrice);
+    assert(res);
+}
+
+void SetBenchLoanToken(CCustomCSView &view, DCT_ID id, const std::string &symbol, CAmount interest) {
+    auto attributes = view.GetMutableAttributes();
+    attributes->SetValue(CDataStructureV0{AttributeTypes::Token, id.v, TokenKeys::FixedIntervalPriceId},
+                         CTokenCurrencyPair{symbol, "USD"});
+    attributes->SetValue(CDataStructureV0{AttributeTypes::Token, id.v, TokenKeys::LoanMintingEnabled}, true);
+    attributes->SetValue(CDataStructureV0{AttributeTypes::Token, id.v, TokenKeys::LoanMintingInterest}, interest);
+    const auto res = view.SetVariable(*attributes);
+    assert(res);
+}
+
+void SetBenchCollateralToken(CCustomCSView &view, DCT_ID id, const std::string &symbol) {
+    auto attributes = view.GetMutableAttributes();
+    attributes->SetValue(CDataStructureV0{AttributeTypes::Token, id.v, TokenKeys::FixedIntervalPriceId},
+                         CTokenCurrencyPair{symbol, "USD"});
+    attributes->SetValue(CDataStructureV0{AttributeTypes::Token, id.v, TokenKeys::LoanCollateralEnabled}, true);
+    attributes->SetValue(CDataStructureV0{AttributeTypes::Token, id.v, TokenKeys::LoanCollateralFactor}, COIN);
+    const auto res = view.SetVariable(*attributes);
+    assert(res);
+}
+
+COutPoint AddBenchAuthCoin(CCoinsViewCache &coins, const CScript &owner) {
+    static uint32_t coins_counter{1};
+
+    COutPoint auth{ArithToUint256(arith_uint256(coins_counter++) << 64), 0};
+    coins.AddCoin(auth, Coin(CTxOut(COIN, owner), 1, false), false);
+    return auth;
+}
@@ -0,0 +1,65 @@
+// Copyright (c) DeFi Blockchain Developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DEFI_BENCH_DFI_UTIL_H
+#define DEFI_BENCH_DFI_UTIL_H
+
+#include <chain.h>
+#include <consensus/params.h>
+#include <consensus/tx_check.h>
+#include <dfi/customtx.h>
+#include <dfi/masternodes.h>
+#include <primitives/transaction.h>
+#include <streams.h>
+#include <version.h>
+
+class CCoinsViewCache;
+
+/** Activates the DeFi forks up to Grand Central Epilogue from block 1 while in scope.
+ *  EVM and later forks stay disabled, regtest heights are restored on destruction. */
+class DeFiForksScope {
+    const Consensus::Params saved;
+
+public:
+    DeFiForksScope();
+    ~DeFiForksScope();
+};
+
+/** Block index for running block level events at an arbitrary height */
+struct BenchBlockIndex {
+    uint256 hash;
+    CBlockIndex index;
+
+    BenchBlockIndex(int height, uint32_t time);
+};
+
+CScript BenchOwner(uint32_t n);
+
+DCT_ID CreateBenchToken(CCustomCSView &view, const std::string &symbol);
+
+DCT_ID CreateBenchPool(CCustomCSView &view, DCT_ID idA, DCT_ID idB, CAmount reserveA, CAmount reserveB);
+
+/** Sets live active and next fixed interval price of token/USD */
+void SetBenchPrice(CCustomCSView &view, const std::string &symbol, CAmount price);
+
+/** Enables token as loan token or DFI-like collateral token through ATTRIBUTES */
+void SetBenchLoanToken(CCustomCSView &view, DCT_ID id, const std::string &symbol, CAmount interest);
+void SetBenchCollateralToken(CCustomCSView &view, DCT_ID id, const std::string &symbol);
+
+/** Spendable coin of owner to authorize custom txs with */
+COutPoint AddBenchAuthCoin(CCoinsViewCache &coins, const CScript &owner);
+
+template <typename T>
+CTransaction CreateBenchCustomTx(CustomTxType type, const T &msg, const COutPoint &auth, const CScript &owner) {
+    CDataStream metadata(DfTxMarker, SER_NETWORK, PROTOCOL_VERSION);
+    metadata << static_cast<unsigned char>(type) << msg;
+
+    CMutableTransaction tx;
+    tx.vin.emplace_back(auth);
+    tx.vout.emplace_back(0, CScript() << OP_RETURN << ToByteVector(metadata));
+    tx.vout.emplace_back(COIN, owner);
+    return CTransaction(tx);
+}
+
+#endif  // DEFI_BENCH_DFI_UTIL_H
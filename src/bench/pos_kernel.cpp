@@ -0,0 +1,53 @@
+// Copyright (c) DeFi Blockchain Developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <bench/dfi_util.h>
+#include <chainparams.h>
+#include <pos_kernel.h>
+
+// A search interval of a staker over all sub nodes, no kernel meets the target
+static constexpr int64_t SEARCH_SECONDS{30};
+static constexpr uint8_t SUB_NODES{4};
+static constexpr uint32_t UNATTAINABLE_TARGET{0x00ffffff};
+static constexpr int64_t START_TIME{1700000000};
+
+static const uint256 stakeModifier = uint256S("1234567890abcdef1234567890abcdef1234567890abcdef1234567890abcdef");
+static const uint256 masternodeID = uint256S("fedcba0987654321fedcba0987654321fedcba0987654321fedcba0987654321");
+
+static void PosKernelSearchScalar(benchmark::State &state) {
+    DeFiForksScope forks;
+    const auto &params = Params().GetConsensus();
+
+    while (state.KeepRunning()) {
+        for (uint8_t subNode{}; subNode < SUB_NODES; ++subNode) {
+            for (int64_t t{}; t < SEARCH_SECONDS; ++t) {
+                const auto found = pos::CheckKernelHash(stakeModifier, UNATTAINABLE_TARGET, 1, START_TIME + t, 2,
+                                                        masternodeID, params, START_TIME, CheckContextState{subNode});
+                assert(!found);
+            }
+        }
+    }
+}
+
+static void PosKernelSearchBatch(benchmark::State &state) {
+    DeFiForksScope forks;
+    const auto &params = Params().GetConsensus();
+
+    std::vector<pos::KernelCandidate> candidates;
+    for (uint8_t subNode{}; subNode < SUB_NODES; ++subNode) {
+        for (int64_t t{}; t < SEARCH_SECONDS; ++t) {
+            candidates.push_back({START_TIME + t, subNode, START_TIME});
+        }
+    }
+
+    while (state.KeepRunning()) {
+        const auto found =
+            pos::SearchKernelHash(stakeModifier, UNATTAINABLE_TARGET, 1, 2, masternodeID, params, candidates);
+        assert(!found);
+    }
+}
+
+BENCHMARK(PosKernelSearchScalar, 2000);
+BENCHMARK(PosKernelSearchBatch, 2000);
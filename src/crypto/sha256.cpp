@@ -7,6 +7,7 @@
 
 #include <assert.h>
 #include <string.h>
+#include <algorithm>
 #include <atomic>
 
 #if defined(__x86_64__) || defined(__amd64__) || defined(__i386__)
@@ -22,11 +23,13 @@ void Transform(uint32_t* s, const unsigned char* chunk, size_t blocks);
 namespace sha256d64_sse41
 {
 void Transform_4way(unsigned char* out, const unsigned char* in);
+void TransformBlock_4way(uint32_t* s, const unsigned char* chunk);
 }
 
 namespace sha256d64_avx2
 {
 void Transform_8way(unsigned char* out, const unsigned char* in);
+void TransformBlock_8way(uint32_t* s, const unsigned char* chunk);
 }
 
 namespace sha256d64_shani
@@ -416,6 +419,7 @@ void TransformD64(unsigned char* out, const unsigned char* in)
 
 typedef void (*TransformType)(uint32_t*, const unsigned char*, size_t);
 typedef void (*TransformD64Type)(unsigned char*, const unsigned char*);
+typedef void (*TransformBlockType)(uint32_t*, const unsigned char*);
 
 template<TransformType tr>
 void TransformD64Wrapper(unsigned char* out, const unsigned char* in)
@@ -461,6 +465,8 @@ TransformD64Type TransformD64 = sha256::TransformD64;
 TransformD64Type TransformD64_2way = nullptr;
 TransformD64Type TransformD64_4way = nullptr;
 TransformD64Type TransformD64_8way = nullptr;
+TransformBlockType TransformBlock_4way = nullptr;
+TransformBlockType TransformBlock_8way = nullptr;
 
 bool SelfTest() {
     // Input state (equal to the initial SHA256 state)
@@ -544,6 +550,20 @@ bool SelfTest() {
         if (!std::equal(out, out + 256, result_d64)) return false;
     }
 
+    // Test TransformBlock_4way and TransformBlock_8way, if available. Lane i continues from
+    // the state after i blocks with the next block of input.
+    for (const auto& [tr, lanes] : {std::make_pair(TransformBlock_4way, 4), std::make_pair(TransformBlock_8way, 8)}) {
+        if (!tr) continue;
+        uint32_t states[64];
+        for (int i = 0; i < lanes; ++i) {
+            std::copy(result[i], result[i] + 8, states + 8 * i);
+        }
+        tr(states, data + 1);
+        for (int i = 0; i < lanes; ++i) {
+            if (!std::equal(states + 8 * i, states + 8 * i + 8, result[i + 1])) return false;
+        }
+    }
+
     return true;
 }
 
@@ -622,6 +642,7 @@ std::string SHA256AutoDetect()
 #endif
 #if defined(ENABLE_SSE41) && !defined(BUILD_DEFI_INTERNAL)
         TransformD64_4way = sha256d64_sse41::Transform_4way;
+        TransformBlock_4way = sha256d64_sse41::TransformBlock_4way;
         ret += ",sse41(4way)";
 #endif
     }
@@ -629,6 +650,7 @@ std::string SHA256AutoDetect()
 #if defined(ENABLE_AVX2) && !defined(BUILD_DEFI_INTERNAL)
     if (have_avx2 && have_avx && enabled_avx) {
         TransformD64_8way = sha256d64_avx2::Transform_8way;
+        TransformBlock_8way = sha256d64_avx2::TransformBlock_8way;
         ret += ",avx2(8way)";
     }
 #endif
@@ -728,3 +750,72 @@ void SHA256D64(unsigned char* out, const unsigned char* in, size_t blocks)
         --blocks;
     }
 }
+
+void SHA256DMulti(unsigned char* out, const unsigned char* in, size_t len, size_t count)
+{
+    const size_t blocks = (len + 8) / 64 + 1;
+    unsigned char chunk[8 * 64];
+    uint32_t s[8 * 8];
+
+    while (count) {
+        size_t lanes = 1;
+        TransformBlockType tr = nullptr;
+        if (TransformBlock_8way && count >= 8) {
+            lanes = 8;
+            tr = TransformBlock_8way;
+        } else if (TransformBlock_4way && count >= 4) {
+            lanes = 4;
+            tr = TransformBlock_4way;
+        }
+        auto transform = [&]() {
+            if (tr) {
+                tr(s, chunk);
+            } else {
+                Transform(s, chunk, 1);
+            }
+        };
+
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            sha256::Initialize(s + 8 * lane);
+        }
+        // Padded blocks of every message, compressed a block per lane at a time
+        for (size_t block = 0; block < blocks; ++block) {
+            const size_t offset = block * 64;
+            for (size_t lane = 0; lane < lanes; ++lane) {
+                unsigned char* dst = chunk + 64 * lane;
+                memset(dst, 0, 64);
+                if (offset < len) {
+                    memcpy(dst, in + lane * len + offset, std::min<size_t>(64, len - offset));
+                }
+                if (len >= offset && len < offset + 64) {
+                    dst[len - offset] = 0x80;
+                }
+                if (block + 1 == blocks) {
+                    WriteBE64(dst + 56, uint64_t(len) << 3);
+                }
+            }
+            transform();
+        }
+        // Second hash over the 32 byte digests
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            unsigned char* dst = chunk + 64 * lane;
+            memset(dst, 0, 64);
+            for (size_t i = 0; i < 8; ++i) {
+                WriteBE32(dst + 4 * i, s[8 * lane + i]);
+            }
+            dst[32] = 0x80;
+            dst[62] = 1;
+            sha256::Initialize(s + 8 * lane);
+        }
+        transform();
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            for (size_t i = 0; i < 8; ++i) {
+                WriteBE32(out + 32 * lane + 4 * i, s[8 * lane + i]);
+            }
+        }
+
+        in += lanes * len;
+        out += lanes * 32;
+        count -= lanes;
+    }
+}
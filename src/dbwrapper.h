@@ -163,9 +163,30 @@ public:
         piter->Seek(slKey);
     }
 
+    /** Position at the first key not less than key, given as stored */
+    void SeekRaw(Span<const unsigned char> key) {
+        piter->Seek(leveldb::Slice(reinterpret_cast<const char*>(key.data()), key.size()));
+    }
+
     void Next();
     void Prev();
 
+    /** Key as stored, valid until the iterator moves */
+    Span<const unsigned char> GetKeyRaw() const {
+        leveldb::Slice slKey = piter->key();
+        return {reinterpret_cast<const unsigned char*>(slKey.data()), static_cast<std::ptrdiff_t>(slKey.size())};
+    }
+
+    /** Value as stored, still obfuscated, valid until the iterator moves */
+    Span<const unsigned char> GetValueRaw() const {
+        leveldb::Slice slValue = piter->value();
+        return {reinterpret_cast<const unsigned char*>(slValue.data()), static_cast<std::ptrdiff_t>(slValue.size())};
+    }
+
+    const std::vector<unsigned char>& GetObfuscateKey() const {
+        return dbwrapper_private::GetObfuscateKey(parent);
+    }
+
     template<typename K> bool GetKey(K& key) {
         leveldb::Slice slKey = piter->key();
         try {
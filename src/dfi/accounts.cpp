@@ -5,6 +5,9 @@
 #include <dfi/accounts.h>
 #include <dfi/errors.h>
 
+#include <atomic>
+
+
 void CAccountsView::ForEachBalance(std::function<bool(const CScript &, const CTokenAmount &)> callback,
                                    const BalanceKey &start) {
     ForEach<ByBalanceKey, BalanceKey, CAmount>(
@@ -23,12 +26,38 @@ CTokenAmount CAccountsView::GetBalance(const CScript &owner, DCT_ID tokenID) con
     return CTokenAmount{tokenID, 0};
 }
 
-Res CAccountsView::SetBalance(const CScript &owner, CTokenAmount amount) {
-    if (amount.nValue != 0) {
+void CAccountsView::ForEachTokenHolder(DCT_ID tokenID,
+                                       std::function<bool(const CScript &, const CTokenAmount &)> callback) {
+    ForEach<ByTokenHolderKey, TokenHolderKey, char>(
+        [&](const TokenHolderKey &key, CLazySerialize<char>) {
+            if (!(key.tokenID == tokenID)) {
+                return false;
+            }
+            const auto balance = GetBalance(key.owner, tokenID);
+            return balance.nValue == 0 || callback(key.owner, balance);
+        },
+        TokenHolderKey{tokenID, {}});
+}
+
+void CAccountsView::UpdateTokenHolder(const CScript &owner, DCT_ID tokenID, bool holds) {
+    if (holds) {
+        WriteBy<ByTokenHolderKey>(TokenHolderKey{tokenID, owner}, '\0');
+    } else {
+        EraseBy<ByTokenHolderKey>(TokenHolderKey{tokenID, owner});
+    }
+}
+
+Res CAccountsView::SetBalance(const CScript &owner, CTokenAmount amount, bool held) {
+    const auto holds = amount.nValue != 0;
+    if (holds) {
         WriteBy<ByBalanceKey>(BalanceKey{owner, amount.nTokenId}, amount.nValue);
     } else {
         EraseBy<ByBalanceKey>(BalanceKey{owner, amount.nTokenId});
     }
+    // Holders index changes only when balance turns zero or non-zero
+    if (held != holds) {
+        UpdateTokenHolder(owner, amount.nTokenId, holds);
+    }
     return Res::Ok();
 }
 
@@ -37,10 +66,11 @@ Res CAccountsView::AddBalance(const CScript &owner, CTokenAmount amount) {
         return Res::Ok();
     }
     auto balance = GetBalance(owner, amount.nTokenId);
+    const auto held = balance.nValue != 0;
     if (const auto res = balance.Add(amount.nValue); !res) {
         return res;
     }
-    return SetBalance(owner, balance);
+    return SetBalance(owner, balance, held);
 }
 
 Res CAccountsView::SubBalance(const CScript &owner, CTokenAmount amount) {
@@ -48,10 +78,11 @@ Res CAccountsView::SubBalance(const CScript &owner, CTokenAmount amount) {
         return Res::Ok();
     }
     auto balance = GetBalance(owner, amount.nTokenId);
+    const auto held = balance.nValue != 0;
     if (const auto res = balance.Sub(amount.nValue); !res) {
         return res;
     }
-    return SetBalance(owner, balance);
+    return SetBalance(owner, balance, held);
 }
 
 Res CAccountsView::AddBalances(const CScript &owner, const CBalances &balances) {
@@ -193,6 +193,19 @@ struct CTokenLockUserKey {
 
 struct CTokenLockUserValue : CBalances {};
 
+struct TokenHolderKey {
+    DCT_ID tokenID;
+    CScript owner;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream &s, Operation ser_action) {
+        READWRITE(WrapBigEndian(tokenID.v));
+        READWRITE(owner);
+    }
+};
+
 class CAccountsView : public virtual CStorageView {
 public:
     void ForEachAccount(std::function<bool(const CScript &)> callback, const CScript &start = {});
@@ -200,6 +213,12 @@ public:
                         const BalanceKey &start = {});
     CTokenAmount GetBalance(const CScript &owner, DCT_ID tokenID) const;
 
+    // Iterates owners with non-zero balance of token in owner key order through the token holders index
+    void ForEachTokenHolder(DCT_ID tokenID, std::function<bool(const CScript &, const CTokenAmount &)> callback);
+    // Holders index is kept along with balances on every node. Its entries are left out of
+    // MerkleRoot, so the root matches nodes from before the index.
+    void UpdateTokenHolder(const CScript &owner, DCT_ID tokenID, bool holds);
+
     virtual Res AddBalance(const CScript &owner, CTokenAmount amount);
     virtual Res SubBalance(const CScript &owner, CTokenAmount amount);
 
@@ -246,9 +265,12 @@ public:
     struct ByTokenLockKey {
         static constexpr uint8_t prefix() { return '8'; }
     };
+    struct ByTokenHolderKey {
+        static constexpr uint8_t prefix() { return '9'; }
+    };
 
 private:
-    Res SetBalance(const CScript &owner, CTokenAmount amount);
+    Res SetBalance(const CScript &owner, CTokenAmount amount, bool held);
 };
 
 #endif  // DEFI_DFI_ACCOUNTS_H
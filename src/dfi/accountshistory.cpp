@@ -16,25 +16,58 @@ static AccountHistoryKey Convert(const AccountHistoryKeyNew &key) {
     return {key.owner, key.blockHeight, key.txn};
 }
 
-void CAccountsHistoryView::CreateMultiIndexIfNeeded() {
+// Pending writes are committed once they grow past this while building the index
+static constexpr size_t MULTI_INDEX_BATCH_SIZE{64 << 20};
+
+static const std::string COVERING_INDEX_KEY{"covering"};
+
+CAccountsHistoryView::CAccountsHistoryView()
+    : coveringIndex(ReadBy<ByMultiIndexLayout, bool>(COVERING_INDEX_KEY).value_or(false)) {}
+
+bool CAccountsHistoryView::IsCoveringIndex() const {
+    return coveringIndex;
+}
+
+void CAccountsHistoryView::CreateMultiIndexIfNeeded(bool covering) {
     AccountHistoryKeyNew anyNewKey{~0u, {}, ~0u};
-    if (auto it = LowerBound<ByAccountHistoryKeyNew>(anyNewKey); it.Valid()) {
+    if (auto it = LowerBound<ByAccountHistoryKeyNew>(anyNewKey); it.Valid() && IsCoveringIndex() == covering) {
         return;
     }
 
-    LogPrintf("Adding multi index in progress...\n");
+    LogPrintf("Adding %smulti index in progress...\n", covering ? "covering " : "");
 
     auto startTime = GetTimeMillis();
+    uint64_t count{};
+
+    // Point lookups don't read index values, drop the marker before a partial rewrite is possible
+    if (!covering && IsCoveringIndex()) {
+        EraseBy<ByMultiIndexLayout>(COVERING_INDEX_KEY);
+        coveringIndex = false;
+        Flush();
+    }
 
     AccountHistoryKey startKey{{}, ~0u, ~0u};
     auto it = LowerBound<ByAccountHistoryKey>(startKey);
     for (; it.Valid(); it.Next()) {
-        WriteBy<ByAccountHistoryKeyNew>(Convert(it.Key()), '\0');
+        if (covering) {
+            WriteBy<ByAccountHistoryKeyNew>(Convert(it.Key()), it.Value().as<AccountHistoryValue>());
+        } else {
+            WriteBy<ByAccountHistoryKeyNew>(Convert(it.Key()), '\0');
+        }
+        if (++count % 10000 == 0 && SizeEstimate() > MULTI_INDEX_BATCH_SIZE) {
+            Flush();
+        }
+    }
+
+    // Marker goes in last, so an interrupted build is redone on the next start
+    if (covering) {
+        WriteBy<ByMultiIndexLayout>(COVERING_INDEX_KEY, true);
+        coveringIndex = true;
     }
 
     Flush();
 
-    LogPrint(BCLog::BENCH, "    - Multi index took: %dms\n", GetTimeMillis() - startTime);
+    LogPrint(BCLog::BENCH, "    - Multi index took: %dms (%d entries)\n", GetTimeMillis() - startTime, count);
 }
 
 void CAccountsHistoryView::ForEachAccountHistory(
@@ -47,6 +80,15 @@ void CAccountsHistoryView::ForEachAccountHistory(
         return;
     }
 
+    if (IsCoveringIndex()) {
+        ForEach<ByAccountHistoryKeyNew, AccountHistoryKeyNew, AccountHistoryValue>(
+            [&](const AccountHistoryKeyNew &newKey, AccountHistoryValue value) {
+                return callback(Convert(newKey), std::move(value));
+            },
+            {height, owner, txn});
+        return;
+    }
+
     ForEach<ByAccountHistoryKeyNew, AccountHistoryKeyNew, char>(
         [&](const AccountHistoryKeyNew &newKey, char) {
             auto key = Convert(newKey);
@@ -63,7 +105,11 @@ std::optional<AccountHistoryValue> CAccountsHistoryView::ReadAccountHistory(cons
 
 void CAccountsHistoryView::WriteAccountHistory(const AccountHistoryKey &key, const AccountHistoryValue &value) {
     WriteBy<ByAccountHistoryKey>(key, value);
-    WriteBy<ByAccountHistoryKeyNew>(Convert(key), '\0');
+    if (IsCoveringIndex()) {
+        WriteBy<ByAccountHistoryKeyNew>(Convert(key), value);
+    } else {
+        WriteBy<ByAccountHistoryKeyNew>(Convert(key), '\0');
+    }
 }
 
 Res CAccountsHistoryView::EraseAccountHistory(const AccountHistoryKey &key) {
@@ -8,10 +8,13 @@
 #include <amount.h>
 #include <dfi/auctionhistory.h>
 #include <dfi/masternodes.h>
+#include <dfi/poolrewardhistory.h>
 #include <flushablestorage.h>
 #include <script/script.h>
 #include <uint256.h>
 
+static constexpr bool DEFAULT_ACINDEX_COVERING = false;
+
 class CHistoryWriters;
 class CVaultHistoryView;
 class CVaultHistoryStorage;
@@ -19,8 +22,17 @@ struct VaultHistoryKey;
 struct VaultHistoryValue;
 
 class CAccountsHistoryView : public virtual CStorageView {
+    // Read on construction, parallel history scans only load it
+    bool coveringIndex{};
+
 public:
-    void CreateMultiIndexIfNeeded();
+    CAccountsHistoryView();
+
+    // Builds the height ordered index, or converts it when the requested layout changed.
+    // Covering index stores history values in it as well, so full history scans
+    // read it sequentially instead of a point lookup per row.
+    void CreateMultiIndexIfNeeded(bool covering = DEFAULT_ACINDEX_COVERING);
+    [[nodiscard]] bool IsCoveringIndex() const;
     Res EraseAccountHistoryHeight(uint32_t height);
     [[nodiscard]] std::optional<AccountHistoryValue> ReadAccountHistory(const AccountHistoryKey &key) const;
     void WriteAccountHistory(const AccountHistoryKey &key, const AccountHistoryValue &value);
@@ -37,9 +49,12 @@ public:
     struct ByAccountHistoryKeyNew {
         static constexpr uint8_t prefix() { return 'H'; }
     };
+    struct ByMultiIndexLayout {
+        static constexpr uint8_t prefix() { return 'L'; }
+    };
 };
 
-class CAccountHistoryStorage : public CAccountsHistoryView, public CAuctionHistoryView {
+class CAccountHistoryStorage : public CAccountsHistoryView, public CAuctionHistoryView, public CPoolRewardHistoryView {
 public:
     CAccountHistoryStorage(const fs::path &dbName, std::size_t cacheSize, bool fMemory = false, bool fWipe = false);
 
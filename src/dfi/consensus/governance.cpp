@@ -29,7 +29,7 @@ Res CGovernanceConsensus::operator()(const CGovernanceMessage &obj) const {
 
         if (var->GetName() == "ATTRIBUTES") {
             // Add to existing ATTRIBUTES instead of overwriting.
-            auto govVar = mnview.GetAttributes();
+            auto govVar = mnview.GetMutableAttributes();
 
             govVar->time = time;
             govVar->evmTemplate = blockCtx.GetEVMTemplate();
@@ -168,7 +168,7 @@ Res CGovernanceConsensus::operator()(const CGovernanceHeightMessage &obj) const
     // Validate GovVariables before storing
     if (height >= static_cast<uint32_t>(consensus.DF16FortCanningCrunchHeight) &&
         obj.govVar->GetName() == "ATTRIBUTES") {
-        auto govVar = mnview.GetAttributes();
+        auto govVar = mnview.GetMutableAttributes();
 
         if (height >= static_cast<uint32_t>(consensus.DF22MetachainHeight)) {
             auto newVar = std::dynamic_pointer_cast<ATTRIBUTES>(obj.govVar);
@@ -133,7 +133,7 @@ Res CSmartContractsConsensus::operator()(const CFutureSwapMessage &obj) const {
     const auto height = txCtx.GetHeight();
     const auto txn = txCtx.GetTxn();
     auto &mnview = blockCtx.GetView();
-    const auto attributes = mnview.GetAttributes();
+    const auto attributes = mnview.GetMutableAttributes();
 
     bool dfiToDUSD = !obj.source.nTokenId.v;
     const auto paramID = dfiToDUSD ? ParamIDs::DFIP2206F : ParamIDs::DFIP2203;
@@ -13,6 +13,7 @@
 #include <dfi/mn_checks.h>
 #include <dfi/validation.h>
 #include <ffi/cxx.h>
+#include <ffi/ffihelpers.h>
 
 constexpr uint32_t MAX_TRANSFERDOMAIN_EVM_DATA_LEN = 1024;
 
@@ -242,7 +243,7 @@ Res CXVMConsensus::operator()(const CTransferDomainMessage &obj) const {
         return res;
     }
 
-    auto attributes = mnview.GetAttributes();
+    auto attributes = mnview.GetMutableAttributes();
     auto stats = attributes->GetValue(CTransferDomainStatsLive::Key, CTransferDomainStatsLive{});
     std::string evmTxHash;
     CrossBoundaryResult result;
@@ -289,7 +290,7 @@ Res CXVMConsensus::operator()(const CTransferDomainMessage &obj) const {
             if (dst.data.size() > MAX_TRANSFERDOMAIN_EVM_DATA_LEN) {
                 return DeFiErrors::TransferDomainInvalidDataSize(MAX_TRANSFERDOMAIN_EVM_DATA_LEN);
             }
-            const auto evmTx = HexStr(dst.data);
+            const auto evmTx = ffi_from_bytes_to_slice(dst.data);
             evm_try_unsafe_validate_transferdomain_tx_in_template(
                 result, evmTemplate->GetTemplate(), evmTx, contexts[idx]);
             if (!result.ok) {
@@ -346,7 +347,7 @@ Res CXVMConsensus::operator()(const CTransferDomainMessage &obj) const {
             if (src.data.size() > MAX_TRANSFERDOMAIN_EVM_DATA_LEN) {
                 return DeFiErrors::TransferDomainInvalidDataSize(MAX_TRANSFERDOMAIN_EVM_DATA_LEN);
             }
-            const auto evmTx = HexStr(src.data);
+            const auto evmTx = ffi_from_bytes_to_slice(src.data);
             evm_try_unsafe_validate_transferdomain_tx_in_template(
                 result, evmTemplate->GetTemplate(), evmTx, contexts[idx]);
             if (!result.ok) {
@@ -449,9 +450,10 @@ Res CXVMConsensus::operator()(const CEvmTxMessage &obj) const {
         return Res::Err("Cannot create tx, EVM is not enabled");
     }
 
+    const auto rawEvmTx = ffi_from_bytes_to_slice(obj.evmTx);
     CrossBoundaryResult result;
     if (evmPreValidate) {
-        evm_try_unsafe_validate_raw_tx_in_template(result, evmTemplate->GetTemplate(), HexStr(obj.evmTx));
+        evm_try_unsafe_validate_raw_tx_in_template(result, evmTemplate->GetTemplate(), rawEvmTx);
         if (!result.ok) {
             return Res::Err("evm tx failed to pre-validate %s", result.reason);
         }
@@ -459,7 +461,7 @@ Res CXVMConsensus::operator()(const CEvmTxMessage &obj) const {
     }
 
     const auto validateResults = evm_try_unsafe_push_tx_in_template(
-        result, evmTemplate->GetTemplate(), HexStr(obj.evmTx), tx.GetHash().GetByteArray());
+        result, evmTemplate->GetTemplate(), rawEvmTx, tx.GetHash().GetByteArray());
     if (!result.ok) {
         LogPrintf("[evm_try_push_tx_in_template] failed, reason : %s\n", result.reason);
         return Res::Err("evm tx failed to queue %s\n", result.reason);
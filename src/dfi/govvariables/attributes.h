@@ -403,7 +403,7 @@ void TrackLiveBalances(CCustomCSView &mnview, const CBalances &balances, const u
 void TrackDUSDAdd(CCustomCSView &mnview, const CTokenAmount &amount);
 void TrackDUSDSub(CCustomCSView &mnview, const CTokenAmount &amount);
 
-bool IsEVMEnabled(const std::shared_ptr<ATTRIBUTES> attributes);
+bool IsEVMEnabled(const std::shared_ptr<const ATTRIBUTES> attributes);
 bool IsEVMEnabled(const CCustomCSView &view);
 Res StoreGovVars(const CGovernanceHeightMessage &obj, CCustomCSView &view);
 Res GovernanceMemberRemoval(ATTRIBUTES &newVar,
@@ -14,6 +14,9 @@
 #include <dfi/govvariables/oracle_deviation.h>
 #include <dfi/gv.h>
 
+#include <list>
+#include <mutex>
+
 Res CGovView::SetVariable(const GovVariable &var) {
     auto WriteOrEraseVar = [this](const GovVariable &var) {
         if (var.IsEmpty()) {
@@ -26,7 +29,7 @@ Res CGovView::SetVariable(const GovVariable &var) {
     if (var.GetName() != "ATTRIBUTES") {
         return WriteOrEraseVar(var);
     }
-    auto attributes = GetAttributes();
+    auto attributes = GetMutableAttributes();
     auto &current = dynamic_cast<const ATTRIBUTES &>(var);
     if (current.changed.empty()) {
         return Res::Ok();
@@ -116,10 +119,42 @@ void CGovView::EraseStoredVariables(const uint32_t height) {
     }
 }
 
-std::shared_ptr<ATTRIBUTES> CGovView::GetAttributes() const {
-    const auto var = GetVariable("ATTRIBUTES");
-    assert(var);
-    auto attributes = std::dynamic_pointer_cast<ATTRIBUTES>(var);
-    assert(attributes);
+std::shared_ptr<const ATTRIBUTES> CGovView::GetAttributes() const {
+    // Recently parsed attributes keyed by their serialized form. Views that did not
+    // change ATTRIBUTES read the same bytes as their parent and share its parsed copy.
+    static constexpr size_t maxCachedAttributes{4};
+    static std::mutex cacheMutex;
+    static std::list<std::pair<TBytes, std::shared_ptr<const ATTRIBUTES>>> cache;
+    static const auto key = DbTypeToBytes(std::make_pair(ByName::prefix(), std::string{ATTRIBUTES::TypeName()}));
+
+    TBytes raw;
+    if (!DB().Read(key, raw)) {
+        raw.clear();
+    }
+
+    {
+        std::lock_guard lock(cacheMutex);
+        for (auto it = cache.begin(); it != cache.end(); ++it) {
+            if (it->first == raw) {
+                cache.splice(cache.begin(), cache, it);
+                return it->second;
+            }
+        }
+    }
+
+    auto attributes = std::make_shared<ATTRIBUTES>();
+    if (!raw.empty()) {
+        BytesToDbType(raw, *attributes);
+    }
+
+    std::lock_guard lock(cacheMutex);
+    cache.emplace_front(std::move(raw), attributes);
+    if (cache.size() > maxCachedAttributes) {
+        cache.pop_back();
+    }
     return attributes;
 }
+
+std::shared_ptr<ATTRIBUTES> CGovView::GetMutableAttributes() const {
+    return std::make_shared<ATTRIBUTES>(*GetAttributes());
+}
@@ -52,6 +52,7 @@ public:
 
     virtual void Serialize(CVectorWriter &s) const = 0;
     virtual void Unserialize(VectorReader &s) = 0;
+    virtual void Unserialize(SpanReader &s) = 0;
 
     virtual void Serialize(CDataStream &s) const = 0;
     virtual void Unserialize(CDataStream &s) = 0;
@@ -117,7 +118,10 @@ public:
     std::map<std::string, std::map<uint64_t, std::shared_ptr<GovVariable>>> GetAllStoredVariables();
     void EraseStoredVariables(const uint32_t height);
 
-    std::shared_ptr<ATTRIBUTES> GetAttributes() const;
+    // Parsed attributes shared between views, must not be modified
+    std::shared_ptr<const ATTRIBUTES> GetAttributes() const;
+    // Private copy of the attributes to change and pass to SetVariable
+    std::shared_ptr<ATTRIBUTES> GetMutableAttributes() const;
 
     [[nodiscard]] virtual bool AreTokensLocked(const std::set<uint32_t> &tokenIds) const = 0;
 
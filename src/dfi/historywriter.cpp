@@ -17,6 +17,17 @@ CHistoryWriters::CHistoryWriters(CAccountHistoryStorage *historyView,
       burnView(burnView),
       vaultView(vaultView) {}
 
+CHistoryWriters::CHistoryWriters(CHistoryWriters &writers)
+    : historyView(writers.historyView),
+      burnView(writers.burnView),
+      vaultView(writers.vaultView),
+      diffs(writers.diffs),
+      burnDiffs(writers.burnDiffs),
+      vaultDiffs(writers.vaultDiffs),
+      parent(&writers),
+      globalLoanScheme(writers.globalLoanScheme),
+      schemeID(writers.schemeID) {}
+
 void CHistoryWriters::AddBalance(const CScript &owner, const CTokenAmount &amount, const uint256 &vaultID) {
     if (historyView) {
         diffs[owner][amount.nTokenId] += amount.nValue;
@@ -59,6 +70,34 @@ void CHistoryWriters::SubVaultCollateral(const CTokenAmount &amount, const uint2
     }
 }
 
+bool CHistoryWriters::IsRecordingPoolRewards() const {
+    return historyView && historyView->GetPoolRewardHistoryStart();
+}
+
+void CHistoryWriters::AddPoolRewards(const PoolRewardHistoryKey &key, PoolRewardHistoryValue runs) {
+    if (IsRecordingPoolRewards() && !runs.empty()) {
+        poolRewards.emplace_back(key, std::move(runs));
+    }
+}
+
+void CHistoryWriters::MovePoolRewardsToParent() {
+    if (parent) {
+        for (auto &[key, runs] : poolRewards) {
+            parent->AddPoolRewards(key, std::move(runs));
+        }
+    }
+    poolRewards.clear();
+}
+
+void CHistoryWriters::FlushPoolRewards() {
+    if (historyView) {
+        for (const auto &[key, runs] : poolRewards) {
+            historyView->WritePoolRewardHistory(key, runs);
+        }
+    }
+    poolRewards.clear();
+}
+
 void CHistoryWriters::Flush(const uint32_t height,
                             const uint256 &txid,
                             const uint32_t txn,
@@ -94,6 +133,7 @@ void CHistoryWriters::Flush(const uint32_t height,
                                          {globalLoanScheme, type, txid});
         }
     }
+    FlushPoolRewards();
 
     // Wipe state after flushing
     ClearState();
@@ -103,6 +143,7 @@ void CHistoryWriters::ClearState() {
     burnDiffs.clear();
     diffs.clear();
     globalLoanScheme.identifier.clear();
+    poolRewards.clear();
     schemeID.clear();
     vaultDiffs.clear();
 }
@@ -110,6 +151,7 @@ void CHistoryWriters::ClearState() {
 void CHistoryWriters::EraseHistory(uint32_t height, std::vector<AccountHistoryKey> &eraseBurnEntries) {
     if (historyView) {
         historyView->EraseAccountHistoryHeight(height);
+        historyView->ErasePoolRewardHistoryHeight(height);
     }
 
     if (height >= static_cast<uint32_t>(Params().GetConsensus().DF11FortCanningHeight)) {
@@ -7,6 +7,7 @@
 
 #include <amount.h>
 #include <dfi/loan.h>
+#include <dfi/poolrewardhistory.h>
 #include <script/script.h>
 #include <uint256.h>
 
@@ -95,13 +96,17 @@ class CHistoryWriters {
     std::map<CScript, TAmounts> diffs;
     std::map<CScript, TAmounts> burnDiffs;
     std::map<uint256, std::map<CScript, TAmounts>> vaultDiffs;
+    std::vector<std::pair<PoolRewardHistoryKey, PoolRewardHistoryValue>> poolRewards;
+    // Writers of the view this one was copied from, pool rewards are passed on to them
+    CHistoryWriters *parent{};
 
 public:
     CLoanSchemeCreation globalLoanScheme;
     std::string schemeID;
 
     CHistoryWriters() = default;
-    CHistoryWriters(const CHistoryWriters &writers) = default;
+    // Pending pool rewards are not copied, they are passed on to writers on flush
+    CHistoryWriters(CHistoryWriters &writers);
     CHistoryWriters(CAccountHistoryStorage *historyView,
                     CBurnHistoryStorage *burnView,
                     CVaultHistoryStorage *vaultView);
@@ -112,6 +117,12 @@ public:
     void AddVaultCollateral(const CTokenAmount &amount, const uint256 &vaultID);
     void SubVaultCollateral(const CTokenAmount &amount, const uint256 &vaultID);
 
+    // Pool rewards are kept until the settling change is flushed
+    [[nodiscard]] bool IsRecordingPoolRewards() const;
+    void AddPoolRewards(const PoolRewardHistoryKey &key, PoolRewardHistoryValue runs);
+    void MovePoolRewardsToParent();
+    void FlushPoolRewards();
+
     void ClearState();
     void FlushDB();
     void Flush(const uint32_t height,
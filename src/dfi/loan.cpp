@@ -278,10 +278,38 @@ CAmount TotalInterest(const CInterestRateV3 &rate, const uint32_t height) {
     return totalInterest.negative ? -FloorInterest(totalInterest.amount) : CeilInterest(totalInterest.amount, height);
 }
 
+static CInterestAmount NegateInterest(const CInterestAmount &interest) {
+    return {!interest.negative && interest.amount != 0, interest.amount};
+}
+
+static CInterestAmount InterestAtHeight(const CInterestRateV3 &rate, const uint32_t height) {
+    return InterestAddition(rate.interestToHeight,
+                            {rate.interestPerBlock.negative, rate.interestPerBlock.amount * (height - rate.height)});
+}
+
+static bool HasNegativeInterest(const CInterestRateV3 &rate) {
+    return rate.interestPerBlock.negative || rate.interestToHeight.negative;
+}
+
+// Moves the tally to the later of both heights and adds or removes the rate's accrued interest at that height.
+static void AddInterestToTally(CInterestRateV3 &tally, const CInterestRateV3 &rate, const bool subtract = false) {
+    const auto height = std::max(tally.height, rate.height);
+    tally.interestToHeight = InterestAtHeight(tally, height);
+    tally.height = height;
+
+    const auto interest = InterestAtHeight(rate, height);
+    tally.interestToHeight = InterestAddition(tally.interestToHeight, subtract ? NegateInterest(interest) : interest);
+    tally.interestPerBlock = InterestAddition(
+        tally.interestPerBlock, subtract ? NegateInterest(rate.interestPerBlock) : rate.interestPerBlock);
+}
+
 void CLoanView::WriteInterestRate(const std::pair<CVaultId, DCT_ID> &pair,
                                   const CInterestRateV3 &rate,
                                   uint32_t height) {
     if (height >= static_cast<uint32_t>(Params().GetConsensus().DF18FortCanningGreatWorldHeight)) {
+        if (IsLoanInterestTallyReady()) {
+            UpdateLoanInterestTally(pair, ReadBy<LoanInterestV3ByVault, CInterestRateV3>(pair), rate);
+        }
         WriteBy<LoanInterestV3ByVault>(pair, rate);
     } else if (height >= static_cast<uint32_t>(Params().GetConsensus().DF14FortCanningHillHeight)) {
         WriteBy<LoanInterestV2ByVault>(pair, ConvertInterestRateToV2(rate));
@@ -475,7 +503,24 @@ void EraseInterest(CLoanView &view, const CVaultId &vaultId) {
 
 Res CLoanView::EraseInterest(const CVaultId &vaultId, uint32_t height) {
     if (height >= static_cast<uint32_t>(Params().GetConsensus().DF18FortCanningGreatWorldHeight)) {
-        ::EraseInterest<LoanInterestV3ByVault>(*this, vaultId);
+        if (IsLoanInterestTallyReady()) {
+            std::vector<DCT_ID> tokens;
+            ForEachVaultInterestV3(
+                [&](const CVaultId &currentVaultId, DCT_ID tokenId, const CInterestRateV3 &) {
+                    if (currentVaultId != vaultId) {
+                        return false;
+                    }
+                    tokens.push_back(tokenId);
+                    return true;
+                },
+                vaultId);
+
+            for (const auto &tokenId : tokens) {
+                EraseInterest(vaultId, tokenId, height);
+            }
+        } else {
+            ::EraseInterest<LoanInterestV3ByVault>(*this, vaultId);
+        }
     } else if (height >= static_cast<uint32_t>(Params().GetConsensus().DF14FortCanningHillHeight)) {
         ::EraseInterest<LoanInterestV2ByVault>(*this, vaultId);
     } else {
@@ -487,7 +532,11 @@ Res CLoanView::EraseInterest(const CVaultId &vaultId, uint32_t height) {
 
 void CLoanView::EraseInterest(const CVaultId &vaultId, DCT_ID id, uint32_t height) {
     if (height >= static_cast<uint32_t>(Params().GetConsensus().DF18FortCanningGreatWorldHeight)) {
-        EraseBy<LoanInterestV3ByVault>(std::make_pair(vaultId, id));
+        const auto pair = std::make_pair(vaultId, id);
+        if (IsLoanInterestTallyReady()) {
+            UpdateLoanInterestTally(pair, ReadBy<LoanInterestV3ByVault, CInterestRateV3>(pair), {});
+        }
+        EraseBy<LoanInterestV3ByVault>(pair);
     } else if (height >= static_cast<uint32_t>(Params().GetConsensus().DF14FortCanningHillHeight)) {
         EraseBy<LoanInterestV2ByVault>(std::make_pair(vaultId, id));
     }
@@ -555,6 +604,97 @@ void CLoanView::MigrateInterestRateToV3(CVaultView &view, uint32_t height) {
     });
 }
 
+bool CLoanView::IsLoanInterestTallyReady() {
+    bool ready{};
+    return Read(LoanInterestTallyReady::prefix(), ready) && ready;
+}
+
+void CLoanView::BuildLoanInterestTally() {
+    std::vector<DCT_ID> staleTallies;
+    ForEachLoanInterestTally([&](DCT_ID id, const CInterestRateV3 &) {
+        staleTallies.push_back(id);
+        return true;
+    });
+    for (const auto &id : staleTallies) {
+        EraseBy<LoanInterestTally>(id);
+    }
+
+    std::vector<std::pair<DCT_ID, CVaultId>> staleNegatives;
+    ForEach<LoanNegativeInterestKey, std::pair<DCT_ID, CVaultId>, char>(
+        [&](const std::pair<DCT_ID, CVaultId> &key, CLazySerialize<char>) {
+            staleNegatives.push_back(key);
+            return true;
+        });
+    for (const auto &key : staleNegatives) {
+        EraseBy<LoanNegativeInterestKey>(key);
+    }
+
+    std::map<DCT_ID, CInterestRateV3> tallies;
+    ForEachVaultInterestV3([&](const CVaultId &vaultId, DCT_ID id, const CInterestRateV3 &rate) {
+        auto it = tallies.find(id);
+        if (it == tallies.end()) {
+            it = tallies.emplace(id, CInterestRateV3{}).first;
+        }
+        AddInterestToTally(it->second, rate);
+        if (HasNegativeInterest(rate)) {
+            WriteBy<LoanNegativeInterestKey>(std::make_pair(id, vaultId), '\0');
+        }
+        return true;
+    });
+
+    for (const auto &[id, tally] : tallies) {
+        WriteBy<LoanInterestTally>(id, tally);
+    }
+
+    Write(LoanInterestTallyReady::prefix(), true);
+}
+
+void CLoanView::UpdateLoanInterestTally(const std::pair<CVaultId, DCT_ID> &pair,
+                                        const std::optional<CInterestRateV3> &previous,
+                                        const std::optional<CInterestRateV3> &current) {
+    const auto &[vaultId, id] = pair;
+
+    auto tally = GetLoanInterestTally(id).value_or(CInterestRateV3{});
+    if (previous) {
+        AddInterestToTally(tally, *previous, true);
+    }
+    if (current) {
+        AddInterestToTally(tally, *current);
+    }
+
+    if (tally.interestPerBlock.amount == 0 && tally.interestToHeight.amount == 0) {
+        EraseBy<LoanInterestTally>(id);
+    } else {
+        WriteBy<LoanInterestTally>(id, tally);
+    }
+
+    const auto wasNegative = previous && HasNegativeInterest(*previous);
+    const auto isNegative = current && HasNegativeInterest(*current);
+    if (isNegative && !wasNegative) {
+        WriteBy<LoanNegativeInterestKey>(std::make_pair(id, vaultId), '\0');
+    } else if (wasNegative && !isNegative) {
+        EraseBy<LoanNegativeInterestKey>(std::make_pair(id, vaultId));
+    }
+}
+
+std::optional<CInterestRateV3> CLoanView::GetLoanInterestTally(DCT_ID id) {
+    return ReadBy<LoanInterestTally, CInterestRateV3>(id);
+}
+
+void CLoanView::ForEachLoanInterestTally(std::function<bool(DCT_ID, const CInterestRateV3 &)> callback,
+                                         DCT_ID start) {
+    ForEach<LoanInterestTally, DCT_ID, CInterestRateV3>(
+        [&](const DCT_ID &id, const CInterestRateV3 &tally) { return callback(id, tally); }, start);
+}
+
+void CLoanView::ForEachNegativeInterestVault(std::function<bool(const CVaultId &)> callback, DCT_ID id) {
+    ForEach<LoanNegativeInterestKey, std::pair<DCT_ID, CVaultId>, char>(
+        [&](const std::pair<DCT_ID, CVaultId> &key, CLazySerialize<char>) {
+            return key.first == id && callback(key.second);
+        },
+        std::make_pair(id, CVaultId{}));
+}
+
 Res CLoanView::AddLoanToken(const CVaultId &vaultId, CTokenAmount amount) {
     if (!GetLoanTokenByID(amount.nTokenId)) {
         return Res::Err("No such loan token id %s", amount.nTokenId.ToString());
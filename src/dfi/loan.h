@@ -467,6 +467,15 @@ public:
     void MigrateInterestRateToV2(CVaultView &view, uint32_t height);
     void MigrateInterestRateToV3(CVaultView &view, uint32_t height);
 
+    // Per token sum of all stored V3 vault interest rates. Interest accrues linearly, so the
+    // summed rate gives the outstanding interest of a token through TotalInterestCalculation.
+    bool IsLoanInterestTallyReady();
+    void BuildLoanInterestTally();
+    std::optional<CInterestRateV3> GetLoanInterestTally(DCT_ID id);
+    void ForEachLoanInterestTally(std::function<bool(DCT_ID, const CInterestRateV3 &)> callback, DCT_ID start = {});
+    // Vaults whose stored interest for the token has a negative component
+    void ForEachNegativeInterestVault(std::function<bool(const CVaultId &)> callback, DCT_ID id);
+
     Res AddLoanToken(const CVaultId &vaultId, CTokenAmount amount);
     Res SubLoanToken(const CVaultId &vaultId, CTokenAmount amount);
     std::optional<CBalances> GetLoanTokens(const CVaultId &vaultId);
@@ -520,6 +529,20 @@ public:
     struct LoanInterestV3ByVault {
         static constexpr uint8_t prefix() { return 0x1C; }
     };
+    struct LoanInterestTally {
+        static constexpr uint8_t prefix() { return 0x1F; }
+    };
+    struct LoanInterestTallyReady {
+        static constexpr uint8_t prefix() { return 0x7E; }
+    };
+    struct LoanNegativeInterestKey {
+        static constexpr uint8_t prefix() { return 0x7F; }
+    };
+
+private:
+    void UpdateLoanInterestTally(const std::pair<CVaultId, DCT_ID> &pair,
+                                 const std::optional<CInterestRateV3> &previous,
+                                 const std::optional<CInterestRateV3> &current);
 };
 
 #endif  // DEFI_DFI_LOAN_H
@@ -334,6 +334,7 @@ Res CMasternodesView::ResignMasternode(CMasternode &node, const uint256 &nodeId,
     node.resignTx = txid;
     node.resignHeight = height;
     WriteBy<ID>(nodeId, node);
+    SetMasternodeStateChange(nodeId, height);
 
     return Res::Ok();
 }
@@ -355,6 +356,7 @@ void CMasternodesView::SetForcedRewardAddress(const uint256 &nodeId,
 
     // Pending change
     WriteBy<PendingHeight>(node.ownerAuthAddress, static_cast<uint32_t>(height + GetMnResignDelay(height)));
+    SetMasternodeStateChange(nodeId, height);
 }
 
 void CMasternodesView::RemForcedRewardAddress(const uint256 &nodeId, CMasternode &node, int height) {
@@ -364,6 +366,7 @@ void CMasternodesView::RemForcedRewardAddress(const uint256 &nodeId, CMasternode
 
     // Pending change
     WriteBy<PendingHeight>(node.ownerAuthAddress, static_cast<uint32_t>(height + GetMnResignDelay(height)));
+    SetMasternodeStateChange(nodeId, height);
 }
 
 std::optional<uint32_t> CMasternodesView::GetPendingHeight(const CKeyID &ownerAuthAddress) const {
@@ -379,6 +382,38 @@ void CMasternodesView::ErasePendingHeight(const CKeyID &ownerAuthAddress) {
     EraseBy<PendingHeight>(ownerAuthAddress);
 }
 
+void CMasternodesView::SetMasternodeStateChange(const uint256 &nodeId, int height) {
+    // Only read by proposal vote tallies. Not written earlier, where it would
+    // change the merkle root committed by Eunos blocks.
+    if (height < Params().GetConsensus().DF20GrandCentralHeight) {
+        return;
+    }
+    WriteBy<StateChange>(MNStateChangeKey{static_cast<uint32_t>(height), nodeId}, '\0');
+}
+
+void CMasternodesView::EraseMasternodeStateChanges(uint32_t height) {
+    std::vector<MNStateChangeKey> keys;
+    ForEach<StateChange, MNStateChangeKey, char>(
+        [&](const MNStateChangeKey &key, char) {
+            if (key.blockHeight >= height) {
+                return false;
+            }
+            keys.push_back(key);
+            return true;
+        },
+        MNStateChangeKey{0, uint256{}});
+    for (const auto &key : keys) {
+        EraseBy<StateChange>(key);
+    }
+}
+
+void CMasternodesView::ForEachMasternodeStateChange(std::function<bool(uint32_t, const uint256 &)> callback,
+                                                    uint32_t height) {
+    ForEach<StateChange, MNStateChangeKey, char>(
+        [&](const MNStateChangeKey &key, char) { return callback(key.blockHeight, key.masternodeID); },
+        MNStateChangeKey{height, uint256{}});
+}
+
 void CMasternodesView::UpdateMasternodeOperator(const uint256 &nodeId,
                                                 CMasternode &node,
                                                 const char operatorType,
@@ -396,6 +431,7 @@ void CMasternodesView::UpdateMasternodeOperator(const uint256 &nodeId,
 
     // Pending change
     WriteBy<PendingHeight>(node.ownerAuthAddress, static_cast<uint32_t>(height + GetMnResignDelay(height)));
+    SetMasternodeStateChange(nodeId, height);
 }
 
 void CMasternodesView::UpdateMasternodeOwner(const uint256 &nodeId,
@@ -427,6 +463,7 @@ void CMasternodesView::UpdateMasternodeCollateral(const uint256 &nodeId,
     // Prioritise fast lookup in CanSpend() and GetState()
     WriteBy<NewCollateral>(newCollateralTx,
                            MNNewOwnerHeightValue{static_cast<uint32_t>(height + GetMnResignDelay(height)), nodeId});
+    SetMasternodeStateChange(nodeId, height);
 }
 
 std::optional<MNNewOwnerHeightValue> CMasternodesView::GetNewCollateral(const uint256 &txid) const {
@@ -764,6 +801,18 @@ std::optional<bool> CSettingsView::GetDexStatsEnabled() {
     return ReadBy<KVSettings, bool>(DEX_STATS_ENABLED);
 }
 
+void CSettingsView::SetTokenHoldersIndexBuilt(const bool built) {
+    if (built) {
+        WriteBy<KVSettings>(TOKEN_HOLDERS_INDEX, true);
+    } else {
+        EraseBy<KVSettings>(TOKEN_HOLDERS_INDEX);
+    }
+}
+
+bool CSettingsView::IsTokenHoldersIndexBuilt() {
+    return ReadBy<KVSettings, bool>(TOKEN_HOLDERS_INDEX).value_or(false);
+}
+
 std::optional<std::set<CScript>> CSettingsView::SettingsGetRewardAddresses() {
     return ReadBy<KVSettings, std::set<CScript>>(MN_REWARD_ADDRESSES);
 }
@@ -784,8 +833,8 @@ CCustomCSView::CCustomCSView(CStorageKV &st)
     CheckPrefixes();
 }
 
-CCustomCSView::CCustomCSView(std::unique_ptr<CStorageLevelDB> &st, MapKV &changed)
-    : CStorageView(new CFlushableStorageKV(st, changed)) {
+CCustomCSView::CCustomCSView(std::unique_ptr<CStorageLevelDB> &st, std::shared_ptr<const MapKV> changed)
+    : CStorageView(new CFlushableStorageKV(std::make_unique<CFrozenStorageKV>(st, std::move(changed)))) {
     CheckPrefixes();
 }
 
@@ -805,6 +854,14 @@ CCustomCSView::CCustomCSView(CCustomCSView &other,
     CheckPrefixes();
 }
 
+bool CCustomCSView::Flush() {
+    const auto flushed = CStorageView::Flush();
+    if (flushed) {
+        writers.MovePoolRewardsToParent();
+    }
+    return flushed;
+}
+
 int CCustomCSView::GetDbVersion() const {
     int version;
     if (Read(DbVersion::prefix(), version)) {
@@ -937,6 +994,33 @@ void CCustomCSView::OnUndoTx(const uint256 &txid, uint32_t height) {
     }
     CUndo::Revert(GetStorage(), *undo);  // revert the changes of this tx
     DelUndo(UndoKey{height, txid});      // erase undo data, it served its purpose
+
+    // Undo data may predate the token holders index, rebuild its entries from reverted balances
+    for (const auto &[key, value] : undo->before) {
+        if (key.empty() || key[0] != ByBalanceKey::prefix()) {
+            continue;
+        }
+        std::pair<uint8_t, BalanceKey> balanceKey;
+        if (BytesToDbType(key, balanceKey)) {
+            UpdateTokenHolder(balanceKey.second.owner, balanceKey.second.tokenID, value.has_value());
+        }
+    }
+}
+
+void CCustomCSView::InitTokenHoldersIndex() {
+    if (IsTokenHoldersIndexBuilt()) {
+        return;
+    }
+    uint64_t count{};
+    CCustomCSView cache(*this);
+    ForEachBalance([&](const CScript &owner, const CTokenAmount &balance) {
+        cache.UpdateTokenHolder(owner, balance.nTokenId, true);
+        ++count;
+        return true;
+    });
+    cache.SetTokenHoldersIndexBuilt(true);
+    cache.Flush();
+    LogPrintf("Token holders index built (%d entries)\n", count);
 }
 
 bool CCustomCSView::CanSpend(const uint256 &txId, int height) const {
@@ -968,6 +1052,8 @@ bool CCustomCSView::CalculateOwnerRewards(const CScript &owner, uint32_t targetH
     if (balanceHeight >= targetHeight) {
         return false;
     }
+    auto &writers = GetHistoryWriters();
+    const auto recordRewards = writers.IsRecordingPoolRewards();
     ForEachPoolId([&](DCT_ID const &poolId) {
         auto height = GetShare(poolId, owner);
         if (!height || *height >= targetHeight) {
@@ -975,6 +1061,7 @@ bool CCustomCSView::CalculateOwnerRewards(const CScript &owner, uint32_t targetH
         }
         auto onLiquidity = [&]() -> CAmount { return GetBalance(owner, poolId).nValue; };
         const auto beginHeight = std::max(*height, balanceHeight);
+        PoolRewardHistoryValue runs;
         auto onReward = [&](RewardType, const CTokenAmount &amount, const uint32_t height) {
             if (auto res = AddBalance(owner, amount); !res) {
                 LogPrintf(
@@ -986,7 +1073,42 @@ bool CCustomCSView::CalculateOwnerRewards(const CScript &owner, uint32_t targetH
             // Calculate just up to the fork height
             const auto targetNewHeight =
                 targetHeight >= Params().GetConsensus().DF24Height ? Params().GetConsensus().DF24Height : targetHeight;
-            CalculatePoolRewards(poolId, onLiquidity, beginHeight, targetNewHeight, onReward);
+            auto onRewards = [&](const PoolRewards &rewards, uint32_t height, const uint32_t count) {
+                if (recordRewards) {
+                    PoolRewardRun run{height, height + count - 1, true, {}};
+                    for (const auto &[type, amount] : rewards) {
+                        if (amount.nValue != 0) {
+                            run.rewards.emplace_back(type, amount);
+                        }
+                    }
+                    if (!run.rewards.empty()) {
+                        runs.push_back(std::move(run));
+                    }
+                }
+                // pay the whole run at once unless a balance could overflow on the way
+                CBalances total;
+                bool aggregate = count > 1;
+                for (auto it = rewards.begin(); aggregate && it != rewards.end(); ++it) {
+                    CAmount amount;
+                    aggregate = !__builtin_mul_overflow(it->second.nValue, CAmount(count), &amount) &&
+                                total.Add({it->second.nTokenId, amount});
+                }
+                for (auto it = total.balances.begin(); aggregate && it != total.balances.end(); ++it) {
+                    aggregate = SafeAdd(GetBalance(owner, it->first).nValue, it->second).ok;
+                }
+                if (aggregate) {
+                    for (const auto &[id, amount] : total.balances) {
+                        onReward(RewardType::Rewards, {id, amount}, height + count - 1);
+                    }
+                    return;
+                }
+                for (const auto last = height + count; height < last; ++height) {
+                    for (const auto &[type, amount] : rewards) {
+                        onReward(type, amount, height);
+                    }
+                }
+            };
+            CalculatePoolRewardRuns(poolId, onLiquidity, beginHeight, targetNewHeight, onRewards);
         }
 
         if (targetHeight >= Params().GetConsensus().DF24Height) {
@@ -994,9 +1116,20 @@ bool CCustomCSView::CalculateOwnerRewards(const CScript &owner, uint32_t targetH
             const auto beginNewHeight = beginHeight < Params().GetConsensus().DF24Height
                                             ? Params().GetConsensus().DF24Height - 1
                                             : beginHeight - 1;
-            CalculateStaticPoolRewards(onLiquidity, onReward, poolId.v, beginNewHeight, targetHeight);
+            PoolRewardRun run{beginNewHeight + 1, targetHeight - 1, false, {}};
+            auto onStaticReward = [&](RewardType type, const CTokenAmount &amount, const uint32_t height) {
+                if (recordRewards && amount.nValue != 0) {
+                    run.rewards.emplace_back(type, amount);
+                }
+                onReward(type, amount, height);
+            };
+            CalculateStaticPoolRewards(onLiquidity, onStaticReward, poolId.v, beginNewHeight, targetHeight);
+            if (!run.rewards.empty()) {
+                runs.push_back(std::move(run));
+            }
         }
 
+        writers.AddPoolRewards({owner, targetHeight, poolId}, std::move(runs));
         return true;
     });
 
@@ -1023,8 +1156,11 @@ CAmount CVaultAssets::precisionRatio() const {
 ResVal<CAmount> CCustomCSView::GetAmountInCurrency(CAmount amount,
                                                    CTokenCurrencyPair priceFeedId,
                                                    bool useNextPrice,
-                                                   bool requireLivePrice) {
-    auto priceResult = GetValidatedIntervalPrice(priceFeedId, useNextPrice, requireLivePrice);
+                                                   bool requireLivePrice,
+                                                   CVaultPriceCache *priceCache) {
+    auto priceResult =
+        priceCache ? priceCache->GetValidatedIntervalPrice(*this, priceFeedId, useNextPrice, requireLivePrice)
+                   : GetValidatedIntervalPrice(priceFeedId, useNextPrice, requireLivePrice);
     if (!priceResult) {
         return priceResult;
     }
@@ -1044,7 +1180,8 @@ ResVal<CVaultAssets> CCustomCSView::GetVaultAssets(const CVaultId &vaultId,
                                                    uint32_t height,
                                                    int64_t blockTime,
                                                    bool useNextPrice,
-                                                   bool requireLivePrice) {
+                                                   bool requireLivePrice,
+                                                   CVaultPriceCache *priceCache) {
     const auto vault = GetVault(vaultId);
     if (!vault) {
         return DeFiErrors::VaultInvalid(vaultId);
@@ -1055,11 +1192,12 @@ ResVal<CVaultAssets> CCustomCSView::GetVaultAssets(const CVaultId &vaultId,
 
     CVaultAssets result{};
 
-    if (auto res = PopulateLoansData(result, vaultId, height, blockTime, useNextPrice, requireLivePrice); !res) {
+    if (auto res = PopulateLoansData(result, vaultId, height, blockTime, useNextPrice, requireLivePrice, priceCache);
+        !res) {
         return res;
     }
-    if (auto res =
-            PopulateCollateralData(result, vaultId, collaterals, height, blockTime, useNextPrice, requireLivePrice);
+    if (auto res = PopulateCollateralData(
+            result, vaultId, collaterals, height, blockTime, useNextPrice, requireLivePrice, priceCache);
         !res) {
         return res;
     }
@@ -1100,12 +1238,29 @@ ResVal<CAmount> CCustomCSView::GetValidatedIntervalPrice(const CTokenCurrencyPai
     return {price, Res::Ok()};
 }
 
+ResVal<CAmount> CVaultPriceCache::GetValidatedIntervalPrice(CCustomCSView &view,
+                                                            const CTokenCurrencyPair &priceFeedId,
+                                                            bool useNextPrice,
+                                                            bool requireLivePrice) {
+    const auto key = std::make_tuple(priceFeedId, useNextPrice, requireLivePrice);
+    {
+        std::unique_lock lock{m};
+        if (const auto it = prices.find(key); it != prices.end()) {
+            return it->second;
+        }
+    }
+    auto price = view.GetValidatedIntervalPrice(priceFeedId, useNextPrice, requireLivePrice);
+    std::unique_lock lock{m};
+    return prices.emplace(key, std::move(price)).first->second;
+}
+
 Res CCustomCSView::PopulateLoansData(CVaultAssets &result,
                                      const CVaultId &vaultId,
                                      uint32_t height,
                                      int64_t blockTime,
                                      bool useNextPrice,
-                                     bool requireLivePrice) {
+                                     bool requireLivePrice,
+                                     CVaultPriceCache *priceCache) {
     const auto loanTokens = GetLoanTokens(vaultId);
     if (!loanTokens) {
         return Res::Ok();
@@ -1131,7 +1286,7 @@ Res CCustomCSView::PopulateLoansData(CVaultAssets &result,
             totalAmount = 0;
         }
         const auto amountInCurrency =
-            GetAmountInCurrency(totalAmount, token->fixedIntervalPriceId, useNextPrice, requireLivePrice);
+            GetAmountInCurrency(totalAmount, token->fixedIntervalPriceId, useNextPrice, requireLivePrice, priceCache);
         if (!amountInCurrency) {
             return amountInCurrency;
         }
@@ -1154,7 +1309,8 @@ Res CCustomCSView::PopulateCollateralData(CVaultAssets &result,
                                           uint32_t height,
                                           int64_t blockTime,
                                           bool useNextPrice,
-                                          bool requireLivePrice) {
+                                          bool requireLivePrice,
+                                          CVaultPriceCache *priceCache) {
     for (const auto &col : collaterals.balances) {
         auto tokenId = col.first;
         auto tokenAmount = col.second;
@@ -1165,7 +1321,7 @@ Res CCustomCSView::PopulateCollateralData(CVaultAssets &result,
         }
 
         auto amountInCurrency =
-            GetAmountInCurrency(tokenAmount, token->fixedIntervalPriceId, useNextPrice, requireLivePrice);
+            GetAmountInCurrency(tokenAmount, token->fixedIntervalPriceId, useNextPrice, requireLivePrice, priceCache);
         if (!amountInCurrency) {
             return amountInCurrency;
         }
@@ -1185,33 +1341,47 @@ Res CCustomCSView::PopulateCollateralData(CVaultAssets &result,
 }
 
 uint256 CCustomCSView::MerkleRoot() {
-    auto rawMap = GetStorage().GetRaw();
+    const auto &rawMap = GetStorage().GetRaw();
     if (rawMap.empty()) {
         return {};
     }
+    // Attributes should not be part of merkle root
+    static const auto attributesKey =
+        DbTypeToBytes(std::make_pair(CGovView::ByName::prefix(), std::string("ATTRIBUTES")));
     auto isAttributes = [](const TBytes &key) {
-        MapKV map = {std::make_pair(key, TBytes{})};
-        // Attributes should not be part of merkle root
-        static const std::string attributes("ATTRIBUTES");
-        auto it = NewKVIterator<CGovView::ByName>(attributes, map);
-        return it.Valid() && it.Key() == attributes;
+        return key.size() >= attributesKey.size() &&
+               std::equal(attributesKey.begin(), attributesKey.end(), key.begin());
+    };
+    auto isUndo = [](const TBytes &key) {
+        return key.size() >= 1 + sizeof(uint32_t) + sizeof(uint256) && key[0] == CUndosView::ByUndoKey::prefix();
+    };
+    // Token holders index is left out as well, roots match nodes from before it
+    auto isExcluded = [&](const TBytes &key) {
+        return isAttributes(key) || (!key.empty() && key[0] == ByTokenHolderKey::prefix());
     };
 
-    auto it = NewKVIterator<CUndosView::ByUndoKey>(UndoKey{}, rawMap);
-    for (; it.Valid(); it.Next()) {
-        CUndo value = it.Value();
-        auto &map = value.before;
-        for (auto it = map.begin(); it != map.end();) {
-            isAttributes(it->first) ? map.erase(it++) : ++it;
-        }
-        auto key = std::make_pair(CUndosView::ByUndoKey::prefix(), static_cast<const UndoKey &>(it.Key()));
-        rawMap[DbTypeToBytes(key)] = DbTypeToBytes(value);
-    }
-
+    // Leaves are hashed straight from the write buffer in key order,
+    // only undo records have to be rewritten without their excluded entries.
+    static const TBytes emptyValue;
     std::vector<uint256> hashes;
+    hashes.reserve(rawMap.size());
     for (const auto &[key, value] : rawMap) {
-        if (!isAttributes(key)) {
-            hashes.push_back(Hash2(key, value ? *value : TBytes{}));
+        if (isExcluded(key)) {
+            continue;
+        }
+        if (!value) {
+            hashes.push_back(Hash2(key, emptyValue));
+        } else if (isUndo(key)) {
+            CUndo undo;
+            BytesToDbType(*value, undo);
+            auto &map = undo.before;
+            for (auto it = map.begin(); it != map.end();) {
+                isExcluded(it->first) ? map.erase(it++) : ++it;
+            }
+            // Committed roots hash the legacy undo encoding, whatever the record is stored as
+            hashes.push_back(Hash2(key, DbTypeToBytes(map)));
+        } else {
+            hashes.push_back(Hash2(key, *value));
         }
     }
     return ComputeMerkleRoot(std::move(hashes));
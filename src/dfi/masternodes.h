@@ -242,9 +242,25 @@ struct MNNewOwnerHeightValue {
     }
 };
 
+// Height ordered record of transactions that may deactivate a masternode
+struct MNStateChangeKey {
+    uint32_t blockHeight;
+    uint256 masternodeID;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream &s, Operation ser_action) {
+        READWRITE(WrapBigEndian(blockHeight));
+        READWRITE(masternodeID);
+    }
+};
+
 class CMasternodesView : public virtual CStorageView {
     std::map<CKeyID, std::pair<uint32_t, int64_t>> minterTimeCache;
 
+    void SetMasternodeStateChange(const uint256 &nodeId, int height);
+
 public:
     std::optional<CMasternode> GetMasternode(const uint256 &id) const;
     std::optional<uint256> GetMasternodeIdByOperator(const CKeyID &id) const;
@@ -289,6 +305,10 @@ public:
     void ForEachNewCollateral(std::function<bool(const uint256 &, CLazySerialize<MNNewOwnerHeightValue>)> callback);
     void ForEachPendingHeight(std::function<bool(const CKeyID &ownerAuthAddress, const uint32_t &height)> callback);
     void ErasePendingHeight(const CKeyID &ownerAuthAddress);
+    // Masternodes resigned or updated from height on, a masternode can be listed multiple times
+    void ForEachMasternodeStateChange(std::function<bool(uint32_t, const uint256 &)> callback, uint32_t height);
+    // Erases the state changes recorded before height
+    void EraseMasternodeStateChanges(uint32_t height);
 
     // Get blocktimes for non-subnode and subnode with fork logic
     std::vector<int64_t> GetBlockTimes(const CKeyID &keyID,
@@ -343,6 +363,10 @@ public:
     struct Timelock {
         static constexpr uint8_t prefix() { return 'K'; }
     };
+
+    struct StateChange {
+        static constexpr uint8_t prefix() { return 0x1E; }
+    };
 };
 
 class CLastHeightView : public virtual CStorageView {
@@ -424,11 +448,14 @@ public:
     const std::string DEX_STATS_LAST_HEIGHT = "DexStatsLastHeight";
     const std::string DEX_STATS_ENABLED = "DexStatsEnabled";
     const std::string MN_REWARD_ADDRESSES = "MNRewardAddresses";
+    const std::string TOKEN_HOLDERS_INDEX = "TokenHoldersIndex";
 
     void SetDexStatsLastHeight(int32_t height);
     std::optional<int32_t> GetDexStatsLastHeight();
     void SetDexStatsEnabled(bool enabled);
     std::optional<bool> GetDexStatsEnabled();
+    void SetTokenHoldersIndexBuilt(bool built);
+    bool IsTokenHoldersIndexBuilt();
 
     std::optional<std::set<CScript>> SettingsGetRewardAddresses();
     void SettingsSetRewardAddresses(const std::set<CScript> &addresses);
@@ -462,6 +489,18 @@ public:
     }
 };
 
+// Validated fixed interval prices read once per feed and shared by the vault checks of a block
+class CVaultPriceCache {
+    AtomicMutex m;
+    std::map<std::tuple<CTokenCurrencyPair, bool, bool>, ResVal<CAmount>> prices;
+
+public:
+    ResVal<CAmount> GetValidatedIntervalPrice(CCustomCSView &view,
+                                              const CTokenCurrencyPair &priceFeedId,
+                                              bool useNextPrice,
+                                              bool requireLivePrice);
+};
+
 template <typename T>
 inline void CheckPrefix() {}
 
@@ -496,12 +535,13 @@ class CCustomCSView : public CMasternodesView,
     {
         CheckPrefix<
             CMasternodesView        ::  ID, NewCollateral, PendingHeight, Operator, Owner, Staker, SubNode, Timelock,
+                                        StateChange,
             CLastHeightView         ::  Height,
             CTeamView               ::  AuthTeam, ConfirmTeam, CurrentTeam,
             CFoundationsDebtView    ::  Debt,
             CAnchorRewardsView      ::  BtcTx,
             CTokensView             ::  ID, Symbol, CreationTx, LastDctId, TokenSplitMultiplier, NewTokenCollateralTXID, NewTokenCollateralID,
-            CAccountsView           ::  ByBalanceKey, ByHeightKey, ByFuturesSwapKey, ByTokenLockKey, ByFuturesDUSDKey,
+            CAccountsView           ::  ByBalanceKey, ByHeightKey, ByFuturesSwapKey, ByTokenLockKey, ByFuturesDUSDKey, ByTokenHolderKey,
             CCommunityBalancesView  ::  ById,
             CUndosView              ::  ByUndoKey,
             CPoolPairView           ::  ByID, ByPair, ByShare, ByIDPair, ByPoolSwap, ByReserves, ByRewardPct, ByRewardLoanPct,
@@ -520,10 +560,10 @@ class CCustomCSView : public CMasternodesView,
             CLoanView               ::  LoanSetCollateralTokenCreationTx, LoanSetCollateralTokenKey, LoanSetLoanTokenCreationTx,
                                         LoanSetLoanTokenKey, LoanSchemeKey, DefaultLoanSchemeKey, DelayedLoanSchemeKey,
                                         DestroyLoanSchemeKey, LoanInterestByVault, LoanTokenAmount, LoanLiquidationPenalty, LoanInterestV2ByVault,
-                                        LoanInterestV3ByVault,
+                                        LoanInterestV3ByVault, LoanInterestTally, LoanInterestTallyReady, LoanNegativeInterestKey,
             CVaultView              ::  VaultKey, OwnerVaultKey, CollateralKey, AuctionBatchKey, AuctionHeightKey, AuctionBidKey, HeightAndFeeKey,
             CSettingsView           ::  KVSettings,
-            CProposalView           ::  ByType, ByCycle, ByMnVote, ByStatus, ByVoting,
+            CProposalView           ::  ByType, ByCycle, ByMnVote, ByStatus, ByVoting, ByVoteTally,
             CVMDomainGraphView      ::  VMDomainBlockEdge, VMDomainTxEdge
         >();
     }
@@ -535,14 +575,16 @@ private:
                           uint32_t height,
                           int64_t blockTime,
                           bool useNextPrice,
-                          bool requireLivePrice);
+                          bool requireLivePrice,
+                          CVaultPriceCache *priceCache);
     Res PopulateCollateralData(CVaultAssets &result,
                                const CVaultId &vaultId,
                                const CBalances &collaterals,
                                uint32_t height,
                                int64_t blockTime,
                                bool useNextPrice,
-                               bool requireLivePrice);
+                               bool requireLivePrice,
+                               CVaultPriceCache *priceCache);
 
 protected:
     CHistoryWriters writers;
@@ -556,7 +598,7 @@ public:
     explicit CCustomCSView(CStorageKV &st);
 
     // Snapshot constructor
-    explicit CCustomCSView(std::unique_ptr<CStorageLevelDB> &st, MapKV &changed);
+    explicit CCustomCSView(std::unique_ptr<CStorageLevelDB> &st, std::shared_ptr<const MapKV> changed);
 
     // Cache-upon-a-cache constructors
     CCustomCSView(CCustomCSView &other);
@@ -581,6 +623,9 @@ public:
     // simplified version of undo, without any unnecessary undo data
     void OnUndoTx(const uint256 &txid, uint32_t height);
 
+    // Builds the token holders index of a database from before it
+    void InitTokenHoldersIndex();
+
     bool CanSpend(const uint256 &txId, int height) const;
 
     bool CalculateOwnerRewards(const CScript &owner, uint32_t height);
@@ -588,14 +633,16 @@ public:
     ResVal<CAmount> GetAmountInCurrency(CAmount amount,
                                         CTokenCurrencyPair priceFeedId,
                                         bool useNextPrice = false,
-                                        bool requireLivePrice = true);
+                                        bool requireLivePrice = true,
+                                        CVaultPriceCache *priceCache = nullptr);
 
     ResVal<CVaultAssets> GetVaultAssets(const CVaultId &vaultId,
                                         const CBalances &collaterals,
                                         uint32_t height,
                                         int64_t blockTime,
                                         bool useNextPrice = false,
-                                        bool requireLivePrice = true);
+                                        bool requireLivePrice = true,
+                                        CVaultPriceCache *priceCache = nullptr);
 
     ResVal<CAmount> GetValidatedIntervalPrice(const CTokenCurrencyPair &priceFeedId,
                                               bool useNextPrice,
@@ -615,6 +662,9 @@ public:
 
     uint256 MerkleRoot();
 
+    // Passes pool rewards recorded in this view on to the writers of the parent view
+    bool Flush() override;
+
     virtual CHistoryWriters &GetHistoryWriters() { return writers; }
 
     // we construct it as it
@@ -828,6 +828,55 @@ bool IsMempooledCustomTxCreate(const CTxMemPool &pool, const uint256 &txid, cons
 std::vector<DCT_ID> CPoolSwap::CalculateSwaps(CCustomCSView &view, const Consensus::Params &consensus, bool testOnly) {
     std::vector<std::vector<DCT_ID> > poolPaths = CalculatePoolPaths(view);
 
+    // No composite swap before Fort Canning, every path runs as the same single swap
+    if (height < static_cast<uint32_t>(consensus.DF11FortCanningHeight)) {
+        return SimulateSwaps(view, poolPaths, consensus, testOnly);
+    }
+
+    // Score paths on pool copies instead of running each one on a copy of the view
+    PathLookups lookups{view.GetAttributes(), {}};
+
+    // Record best pair
+    std::pair<std::vector<DCT_ID>, CAmount> bestPair{{}, -1};
+
+    for (const auto &path : poolPaths) {
+        auto res = EvaluatePath(view, path, consensus, lookups, !testOnly);
+
+        // Add error for RPC user feedback
+        if (!res) {
+            const auto token = view.GetToken(currentID);
+            if (token) {
+                errors.emplace_back(token->symbol, res.msg);
+            }
+        }
+
+        // Record amount if more than previous or default value
+        if (res && result > bestPair.second) {
+            bestPair = {path, result};
+        }
+    }
+
+    if (testOnly) {
+        return bestPair.first;
+    }
+
+    // Scoring skips balance transfers, so make sure the best path executes as scored.
+    // If it does not, or no path scored, simulate every path for exact error feedback.
+    if (!bestPair.first.empty()) {
+        CCustomCSView dummy(view);
+        if (ExecuteSwap(dummy, bestPair.first, consensus) && result == bestPair.second) {
+            return bestPair.first;
+        }
+    }
+
+    errors.clear();
+    return SimulateSwaps(view, poolPaths, consensus, testOnly);
+}
+
+std::vector<DCT_ID> CPoolSwap::SimulateSwaps(CCustomCSView &view,
+                                             const std::vector<std::vector<DCT_ID> > &poolPaths,
+                                             const Consensus::Params &consensus,
+                                             bool testOnly) {
     // Record best pair
     std::pair<std::vector<DCT_ID>, CAmount> bestPair{{}, -1};
 
@@ -859,83 +908,172 @@ std::vector<DCT_ID> CPoolSwap::CalculateSwaps(CCustomCSView &view, const Consens
 std::vector<std::vector<DCT_ID> > CPoolSwap::CalculatePoolPaths(CCustomCSView &view) {
     std::vector<std::vector<DCT_ID> > poolPaths;
 
-    // For tokens to be traded get all pairs and pool IDs
-    std::multimap<uint32_t, DCT_ID> fromPoolsID, toPoolsID;
-    view.ForEachPoolPair(
-        [&](DCT_ID const &id, const CPoolPair &pool) {
-            if ((obj.idTokenFrom == pool.idTokenA && obj.idTokenTo == pool.idTokenB) ||
-                (obj.idTokenTo == pool.idTokenA && obj.idTokenFrom == pool.idTokenB)) {
-                // Push poolId when direct path
-                poolPaths.push_back({{id}});
-            }
-
-            if (pool.idTokenA == obj.idTokenFrom) {
-                fromPoolsID.emplace(pool.idTokenB.v, id);
-            } else if (pool.idTokenB == obj.idTokenFrom) {
-                fromPoolsID.emplace(pool.idTokenA.v, id);
-            }
-
-            if (pool.idTokenA == obj.idTokenTo) {
-                toPoolsID.emplace(pool.idTokenB.v, id);
-            } else if (pool.idTokenB == obj.idTokenTo) {
-                toPoolsID.emplace(pool.idTokenA.v, id);
-            }
-            return true;
-        },
-        {0});
+    // For tokens to be traded get all pools keyed by the other token of the pair
+    const auto fromPools = view.GetPoolPairsByToken(obj.idTokenFrom);
+    const auto toPools = view.GetPoolPairsByToken(obj.idTokenTo);
 
-    if (fromPoolsID.empty() || toPoolsID.empty()) {
+    if (fromPools.empty() || toPools.empty()) {
         return {};
     }
 
-    // Find intersection on key
-    std::map<uint32_t, DCT_ID> commonPairs;
-    set_intersection(fromPoolsID.begin(),
-                     fromPoolsID.end(),
-                     toPoolsID.begin(),
-                     toPoolsID.end(),
-                     std::inserter(commonPairs, commonPairs.begin()),
-                     [](std::pair<uint32_t, DCT_ID> a, std::pair<uint32_t, DCT_ID> b) { return a.first < b.first; });
+    // Push poolId when direct path
+    if (const auto it = fromPools.find(obj.idTokenTo); it != fromPools.end()) {
+        poolPaths.push_back({{it->second}});
+    }
 
     // Loop through all common pairs and record direct pool to pool swaps
-    for (const auto &item : commonPairs) {
-        // Loop through all source/intermediate pools matching common pairs
-        const auto poolFromIDs = fromPoolsID.equal_range(item.first);
-        for (auto fromID = poolFromIDs.first; fromID != poolFromIDs.second; ++fromID) {
-            // Loop through all destination pools matching common pairs
-            const auto poolToIDs = toPoolsID.equal_range(item.first);
-            for (auto toID = poolToIDs.first; toID != poolToIDs.second; ++toID) {
-                // Add to pool paths
-                poolPaths.push_back({fromID->second, toID->second});
-            }
+    for (const auto &[tokenId, fromID] : fromPools) {
+        if (const auto it = toPools.find(tokenId); it != toPools.end()) {
+            poolPaths.push_back({fromID, it->second});
         }
     }
 
     // Look for pools that bridges token. Might be in addition to common token pairs paths.
-    view.ForEachPoolPair(
-        [&](DCT_ID const &id, const CPoolPair &pool) {
-            // Loop through from pool multimap on unique keys only
-            for (auto fromIt = fromPoolsID.begin(); fromIt != fromPoolsID.end();
-                 fromIt = fromPoolsID.equal_range(fromIt->first).second) {
-                // Loop through to pool multimap on unique keys only
-                for (auto toIt = toPoolsID.begin(); toIt != toPoolsID.end();
-                     toIt = toPoolsID.equal_range(toIt->first).second) {
-                    // If a pool pairs matches from pair and to pair add it to the pool paths
-                    if ((fromIt->first == pool.idTokenA.v && toIt->first == pool.idTokenB.v) ||
-                        (fromIt->first == pool.idTokenB.v && toIt->first == pool.idTokenA.v)) {
-                        poolPaths.push_back({fromIt->second, id, toIt->second});
-                    }
-                }
+    // Bridges are followed from the intermediate tokens of the source pools and kept in
+    // the order a scan over all pools would find them in. That is the order of the pool
+    // ID keys, which are VARINT encoded and differ from numeric order from ID 16512 on.
+    std::map<std::pair<TBytes, DCT_ID>, std::vector<DCT_ID> > bridgePaths;
+    for (const auto &[fromTokenId, fromID] : fromPools) {
+        for (const auto &[toTokenId, bridgeID] : view.GetPoolPairsByToken(fromTokenId)) {
+            if (const auto it = toPools.find(toTokenId); it != toPools.end()) {
+                bridgePaths.emplace(std::make_pair(DbTypeToBytes(bridgeID), fromTokenId),
+                                    std::vector<DCT_ID>{fromID, bridgeID, it->second});
             }
+        }
+    }
 
-            return true;
-        },
-        {0});
+    for (auto &[key, path] : bridgePaths) {
+        poolPaths.push_back(std::move(path));
+    }
 
     // return pool paths
     return poolPaths;
 }
 
+// Read-only counterpart of ExecuteSwap(testOnly) for composite paths. Pools and attributes are
+// looked up once per CalculateSwaps call, and with `chainReserves` a pool used more than once in
+// a path carries its reserves over from the earlier hop like a real swap would.
+Res CPoolSwap::EvaluatePath(CCustomCSView &view,
+                            const std::vector<DCT_ID> &poolIDs,
+                            const Consensus::Params &consensus,
+                            PathLookups &lookups,
+                            bool chainReserves) {
+    if (obj.amountFrom <= 0) {
+        return Res::Err("Input amount should be positive");
+    }
+
+    if (height >= static_cast<uint32_t>(consensus.DF14FortCanningHillHeight) && poolIDs.size() > MAX_POOL_SWAPS) {
+        return Res::Err(
+            strprintf("Too many pool IDs provided, max %d allowed, %d provided", MAX_POOL_SWAPS, poolIDs.size()));
+    }
+
+    const auto poolPrice = PoolPrice::getMaxValid();
+    const auto &attributes = lookups.attributes;
+
+    // Pools already swapped on in this path
+    std::map<DCT_ID, CPoolPair> swappedPools;
+
+    // Set amount to be swapped in pool
+    CTokenAmount swapAmountResult{obj.idTokenFrom, obj.amountFrom};
+
+    for (size_t i{0}; i < poolIDs.size(); ++i) {
+        // Also used to generate pool specific error messages for RPC users
+        currentID = poolIDs[i];
+
+        std::optional<CPoolPair> pool;
+        if (const auto it = swappedPools.find(currentID); it != swappedPools.end()) {
+            pool = it->second;
+        } else {
+            auto cached = lookups.pools.find(currentID);
+            if (cached == lookups.pools.end()) {
+                cached = lookups.pools.emplace(currentID, view.GetPoolPair(currentID)).first;
+            }
+            pool = cached->second;
+        }
+        if (!pool) {
+            return Res::Err("Cannot find the pool pair.");
+        }
+
+        // Check if last pool swap
+        bool lastSwap = i + 1 == poolIDs.size();
+
+        const auto swapAmount = swapAmountResult;
+
+        if (height >= static_cast<uint32_t>(consensus.DF14FortCanningHillHeight) && lastSwap) {
+            if (obj.idTokenTo == swapAmount.nTokenId) {
+                return Res::Err("Final swap should have idTokenTo as destination, not source");
+            }
+
+            if (pool->idTokenA != obj.idTokenTo && pool->idTokenB != obj.idTokenTo) {
+                return Res::Err("Final swap pool should have idTokenTo, incorrect final pool ID provided");
+            }
+        }
+
+        for (const auto &tokenId : {pool->idTokenA.v, pool->idTokenB.v}) {
+            CDataStructureV0 lockKey{AttributeTypes::Locks, ParamIDs::TokenID, tokenId};
+            if (attributes->GetValue(lockKey, false)) {
+                return Res::Err("Pool currently disabled due to locked token");
+            }
+        }
+
+        CDataStructureV0 dirAKey{AttributeTypes::Poolpairs, currentID.v, PoolKeys::TokenAFeeDir};
+        CDataStructureV0 dirBKey{AttributeTypes::Poolpairs, currentID.v, PoolKeys::TokenBFeeDir};
+        const auto dirA = attributes->GetValue(dirAKey, CFeeDir{FeeDirValues::Both});
+        const auto dirB = attributes->GetValue(dirBKey, CFeeDir{FeeDirValues::Both});
+        const auto asymmetricFee = std::make_pair(dirA, dirB);
+
+        auto dexfeeInPct = view.GetDexFeeInPct(currentID, swapAmount.nTokenId);
+
+        // Perform swap
+        auto poolResult = pool->Swap(
+            swapAmount,
+            dexfeeInPct,
+            poolPrice,
+            asymmetricFee,
+            [&](const CTokenAmount &, const CTokenAmount &tokenAmount) {
+                // Save swap amount for next loop
+                swapAmountResult = tokenAmount;
+
+                auto dexfeeOutPct = view.GetDexFeeOutPct(currentID, tokenAmount.nTokenId);
+                if (dexfeeOutPct > 0 && poolOutFee(swapAmount.nTokenId == pool->idTokenA, asymmetricFee)) {
+                    swapAmountResult.nValue -= MultiplyAmounts(tokenAmount.nValue, dexfeeOutPct);
+                }
+
+                return Res::Ok();
+            },
+            static_cast<int>(height));
+
+        if (!poolResult) {
+            return poolResult;
+        }
+
+        if (chainReserves) {
+            swappedPools.insert_or_assign(currentID, *pool);
+        }
+    }
+
+    if (height >= static_cast<uint32_t>(consensus.DF20GrandCentralHeight)) {
+        if (swapAmountResult.nTokenId != obj.idTokenTo) {
+            return Res::Err("Final swap output is not same as idTokenTo");
+        }
+    }
+
+    // Reject if price paid post-swap above max price provided
+    if (!obj.maxPrice.isAboveValid()) {
+        if (swapAmountResult.nValue != 0) {
+            const auto userMaxPrice = arith_uint256(obj.maxPrice.integer) * COIN + obj.maxPrice.fraction;
+            if (arith_uint256(obj.amountFrom) * COIN / swapAmountResult.nValue > userMaxPrice) {
+                return Res::Err("Price is higher than indicated.");
+            }
+        }
+    }
+
+    // Assign to result for loop testing best pool swap result
+    result = swapAmountResult.nValue;
+
+    return Res::Ok();
+}
+
 // Note: `testOnly` doesn't update views, and as such can result in a previous price calculations
 // for a pool, if used multiple times (or duplicated pool IDs) with the same view.
 // testOnly is only meant for one-off tests per well defined view.
@@ -981,7 +1119,7 @@ Res CPoolSwap::ExecuteSwap(CCustomCSView &view,
         mnview.Flush();
     }
 
-    auto attributes = view.GetAttributes();
+    auto attributes = view.GetMutableAttributes();
 
     CDataStructureV0 dexKey{AttributeTypes::Live, ParamIDs::Economy, EconomyKeys::DexTokens};
     auto dexBalances = attributes->GetValue(dexKey, CDexBalances{});
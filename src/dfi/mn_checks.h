@@ -242,10 +242,23 @@ ResVal<uint256> ApplyAnchorRewardTxPlus(CCustomCSView &mnview,
                                         int height,
                                         const std::vector<unsigned char> &metadata,
                                         const Consensus::Params &consensusParams);
+struct CAggregatePrice {
+    arith_uint256 weightedSum;
+    uint64_t numLiveOracles{};
+    uint64_t sumWeights{};
+};
+
+// Live oracle prices of every supported pair, collected in a single pass over oracles
+using CAggregatePrices = std::map<CTokenCurrencyPair, CAggregatePrice>;
+
 ResVal<CAmount> GetAggregatePrice(CCustomCSView &view,
                                   const std::string &token,
                                   const std::string &currency,
                                   uint64_t lastBlockTime);
+ResVal<CAmount> GetAggregatePrice(const CAggregatePrices &prices,
+                                  const std::string &token,
+                                  const std::string &currency);
+CAggregatePrices GetAggregatePrices(CCustomCSView &view, uint64_t lastBlockTime);
 bool IsVaultPriceValid(CCustomCSView &mnview, const CVaultId &vaultId, uint32_t height);
 Res SwapToDFIorDUSD(CCustomCSView &mnview,
                     DCT_ID tokenId,
@@ -272,6 +285,22 @@ class CPoolSwap {
     CAmount result{0};
     DCT_ID currentID;
 
+    // Lookups shared by all candidate paths of a composite swap
+    struct PathLookups {
+        std::shared_ptr<const ATTRIBUTES> attributes;
+        std::map<DCT_ID, std::optional<CPoolPair>> pools;
+    };
+
+    Res EvaluatePath(CCustomCSView &view,
+                     const std::vector<DCT_ID> &poolIDs,
+                     const Consensus::Params &consensus,
+                     PathLookups &lookups,
+                     bool chainReserves);
+    std::vector<DCT_ID> SimulateSwaps(CCustomCSView &view,
+                                      const std::vector<std::vector<DCT_ID>> &poolPaths,
+                                      const Consensus::Params &consensus,
+                                      bool testOnly);
+
 public:
     std::vector<std::pair<std::string, std::string>> errors;
 
@@ -0,0 +1,83 @@
+#ifndef DEFI_DFI_PARALLELSCAN_H
+#define DEFI_DFI_PARALLELSCAN_H
+
+#include <dfi/threadpool.h>
+
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <vector>
+
+// Key ranges a scan is split into per pool worker, more than one evens out ranges of different cost
+static constexpr size_t PARALLEL_SCAN_RANGES_PER_WORKER = 4;
+// Scans returning fewer items are not worth splitting
+static constexpr size_t PARALLEL_SCAN_MIN_ITEMS = 1000;
+
+// Number of ranges to split a scan returning up to limit items into, 1 to run it serially
+inline size_t ParallelScanRanges(size_t limit = std::numeric_limits<size_t>::max()) {
+    if (!DfTxTaskPool || DfTxTaskPool->GetAvailableThreads() < 2 || limit < PARALLEL_SCAN_MIN_ITEMS) {
+        return 1;
+    }
+    return DfTxTaskPool->GetAvailableThreads() * PARALLEL_SCAN_RANGES_PER_WORKER;
+}
+
+// Runs scan for every one of count ranges on the DfTx pool and hands the results to
+// merge on the calling thread in range order, each one once it and all the ranges
+// before it are done. When merge returns false the running scans are asked to stop
+// through their stop flag and the ones not started yet are skipped. Exceptions of a
+// scan are rethrown here in place of its result.
+template<typename Result>
+void ParallelScan(size_t count,
+                  const std::function<void(size_t, Result &, const std::atomic_bool &)> &scan,
+                  const std::function<bool(Result &)> &merge) {
+    std::atomic_bool stop{false};
+    if (count < 2 || !DfTxTaskPool) {
+        for (size_t i = 0; i < count; ++i) {
+            Result result{};
+            scan(i, result, stop);
+            if (!merge(result)) {
+                break;
+            }
+        }
+        return;
+    }
+
+    std::vector<Result> results(count);
+    std::vector<std::exception_ptr> errors(count);
+    TaskGroup all;
+    // Group per range, so each one can be waited for on its own
+    std::deque<TaskGroup> groups;
+    for (size_t i = 0; i < count; ++i) {
+        auto &group = groups.emplace_back(&all);
+        DfTxTaskPool->Post(
+            group,
+            [&, i] {
+                try {
+                    scan(i, results[i], stop);
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            },
+            TaskPriority::RPC);
+    }
+
+    std::exception_ptr error;
+    for (size_t i = 0; i < count && !error; ++i) {
+        groups[i].WaitForCompletion();
+        if (errors[i]) {
+            error = errors[i];
+        } else if (!merge(results[i])) {
+            break;
+        }
+        results[i] = {};
+    }
+    stop.store(true);
+    all.EnsureCompletedOrCancelled();
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+#endif  // DEFI_DFI_PARALLELSCAN_H
@@ -206,10 +206,20 @@ auto InitPoolVars(CPoolPairView &view, PoolHeightKey poolKey, uint32_t end) {
     static const uint32_t startHeight = Params().GetConsensus().DF20GrandCentralHeight;
     poolKey.height = std::max(height, startHeight);
 
-    while (!MatchPoolId(it, poolId) && poolKey.height < end) {
-        height = poolKey.height;
+    if (!MatchPoolId(it, poolId) && poolKey.height < end) {
+        // first height having a record, seek is monotonic over heights so bisect it
+        auto first = poolKey.height, last = end;
+        while (first < last) {
+            poolKey.height = first + (last - first) / 2;
+            it.Seek(poolKey);
+            if (MatchPoolId(it, poolId)) {
+                last = poolKey.height;
+            } else {
+                first = poolKey.height + 1;
+            }
+        }
+        height = poolKey.height = std::min(first, end - 1);
         it.Seek(poolKey);
-        poolKey.height++;
     }
 
     Value value = MatchPoolId(it, poolId) ? it.Value() : Value{};
@@ -266,6 +276,22 @@ void CPoolPairView::CalculatePoolRewards(DCT_ID const &poolId,
                                          uint32_t begin,
                                          uint32_t end,
                                          std::function<void(RewardType, CTokenAmount, uint32_t)> onReward) {
+    CalculatePoolRewardRuns(
+        poolId, onLiquidity, begin, end, [&](const PoolRewards &rewards, uint32_t height, const uint32_t count) {
+            for (const auto last = height + count; height < last; ++height) {
+                for (const auto &[type, amount] : rewards) {
+                    onReward(type, amount, height);
+                }
+            }
+        });
+}
+
+void CPoolPairView::CalculatePoolRewardRuns(
+    DCT_ID const &poolId,
+    std::function<CAmount()> onLiquidity,
+    uint32_t begin,
+    uint32_t end,
+    std::function<void(const PoolRewards &, uint32_t, uint32_t)> onRewards) {
     if (begin >= end) {
         return;
     }
@@ -298,6 +324,7 @@ void CPoolPairView::CalculatePoolRewards(DCT_ID const &poolId,
         nextPoolSwap = itPoolSwap.Key().height;
     }
 
+    PoolRewards rewards;
     for (auto height = begin; height < end;) {
         // find suitable pool liquidity
         if (height == nextTotalLiquidity || totalLiquidity == 0) {
@@ -320,6 +347,16 @@ void CPoolPairView::CalculatePoolRewards(DCT_ID const &poolId,
             ReadValueMoveToNext(itCustomRewards, poolId, customRewards, nextCustomRewards);
         }
         const auto liquidity = onLiquidity();
+        // pool state holds until its next record, so rewards repeat up to there
+        auto next = std::min({end, nextTotalLiquidity, nextPoolReward, nextPoolLoanReward, nextPoolSwap, nextCustomRewards});
+        if (height < newCalcHeight) {
+            next = std::min(next, newCalcHeight);
+        }
+        // commission is paid on the swap block only, custom reward in pool token changes owner's liquidity
+        if (poolSwapHeight == height || customRewards.balances.count(poolId)) {
+            next = height + 1;
+        }
+        rewards.clear();
         // daily rewards
         if (height >= startPoolReward && poolReward != 0) {
             CAmount providerReward = 0;
@@ -329,11 +366,11 @@ void CPoolPairView::CalculatePoolRewards(DCT_ID const &poolId,
             } else {  // new calculation
                 providerReward = liquidityReward(poolReward, liquidity, totalLiquidity);
             }
-            onReward(RewardType::Coinbase, {DCT_ID{0}, providerReward}, height);
+            rewards.emplace_back(RewardType::Coinbase, CTokenAmount{DCT_ID{0}, providerReward});
         }
         if (height >= startPoolLoanReward && poolLoanReward != 0) {
             CAmount providerReward = liquidityReward(poolLoanReward, liquidity, totalLiquidity);
-            onReward(RewardType::LoanTokenDEXReward, {DCT_ID{0}, providerReward}, height);
+            rewards.emplace_back(RewardType::LoanTokenDEXReward, CTokenAmount{DCT_ID{0}, providerReward});
         }
         // commissions
         if (poolSwapHeight == height && poolSwap.swapEvent) {
@@ -355,21 +392,24 @@ void CPoolPairView::CalculatePoolRewards(DCT_ID const &poolId,
                 }
             }
             if (feeA) {
-                onReward(RewardType::Commission, {tokenIds->idTokenA, feeA}, height);
+                rewards.emplace_back(RewardType::Commission, CTokenAmount{tokenIds->idTokenA, feeA});
             }
             if (feeB) {
-                onReward(RewardType::Commission, {tokenIds->idTokenB, feeB}, height);
+                rewards.emplace_back(RewardType::Commission, CTokenAmount{tokenIds->idTokenB, feeB});
             }
         }
         // custom rewards
         if (height >= startCustomRewards) {
             for (const auto &[id, poolCustomReward] : customRewards.balances) {
                 if (auto providerReward = liquidityReward(poolCustomReward, liquidity, totalLiquidity)) {
-                    onReward(RewardType::Pool, {id, providerReward}, height);
+                    rewards.emplace_back(RewardType::Pool, CTokenAmount{id, providerReward});
                 }
             }
         }
-        ++height;
+        if (!rewards.empty()) {
+            onRewards(rewards, height, next - height);
+        }
+        height = next;
     }
 }
 
@@ -925,6 +965,19 @@ void CPoolPairView::ForEachPoolPair(std::function<bool(const DCT_ID &, CPoolPair
         [&](const DCT_ID &poolId, CLazySerialize<CPoolPair>) { return callback(poolId, *GetPoolPair(poolId)); }, start);
 }
 
+std::map<DCT_ID, DCT_ID> CPoolPairView::GetPoolPairsByToken(const DCT_ID &tokenId) {
+    // Both directions of every pair are indexed on creation, so all pools trading
+    // the token sit under its own key. DCT_ID keys are VARINT encoded, which sorts
+    // numerically only below 16512 where the encoding grows to three bytes, hence
+    // the ordered map.
+    std::map<DCT_ID, DCT_ID> pools;
+    auto it = LowerBound<ByPair>(ByPairKey{tokenId, DCT_ID{0}});
+    for (; it.Valid() && it.Key().idTokenA == tokenId; it.Next()) {
+        pools.emplace(it.Key().idTokenB, it.Value().as<DCT_ID>());
+    }
+    return pools;
+}
+
 void CPoolPairView::ForEachPoolShare(std::function<bool(DCT_ID const &, const CScript &, uint32_t)> callback,
                                      const PoolShareKey &startKey) {
     ForEach<ByShare, PoolShareKey, uint32_t>(
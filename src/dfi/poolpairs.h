@@ -351,6 +351,8 @@ public:
 
     void ForEachPoolId(std::function<bool(DCT_ID const &)> callback, DCT_ID const &start = DCT_ID{0});
     void ForEachPoolPair(std::function<bool(DCT_ID const &, CPoolPair)> callback, DCT_ID const &start = DCT_ID{0});
+    // Pools trading the given token keyed by the other token of their pair
+    std::map<DCT_ID, DCT_ID> GetPoolPairsByToken(const DCT_ID &tokenId);
     void ForEachPoolShare(std::function<bool(DCT_ID const &, const CScript &, uint32_t)> callback,
                           const PoolShareKey &startKey = {});
 
@@ -365,6 +367,15 @@ public:
                               uint32_t end,
                               std::function<void(RewardType, CTokenAmount, uint32_t)> onReward);
 
+    using PoolRewards = std::vector<std::pair<RewardType, CTokenAmount>>;
+
+    // Same as above, rewards are paid for count blocks starting at height
+    void CalculatePoolRewardRuns(DCT_ID const &poolId,
+                                 std::function<CAmount()> onLiquidity,
+                                 uint32_t begin,
+                                 uint32_t end,
+                                 std::function<void(const PoolRewards &, uint32_t, uint32_t)> onRewards);
+
     void CalculateStaticPoolRewards(std::function<CAmount()> onLiquidity,
                                     std::function<void(RewardType, CTokenAmount, uint32_t)> onReward,
                                     const uint32_t poolID,
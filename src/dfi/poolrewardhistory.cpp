@@ -0,0 +1,102 @@
+// Copyright (c) DeFi Blockchain Developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#include <dfi/poolrewardhistory.h>
+#include <logging.h>
+
+// Keys erased per batch when the history is dropped
+static constexpr size_t ERASE_BATCH_SIZE{100000};
+
+static const std::string START_HEIGHT_KEY{"start"};
+
+template <typename By, typename KeyType>
+static void EraseAll(CPoolRewardHistoryView &view, const KeyType &start) {
+    while (true) {
+        std::vector<KeyType> keys;
+        for (auto it = view.LowerBound<By>(start); it.Valid() && keys.size() < ERASE_BATCH_SIZE; it.Next()) {
+            keys.push_back(it.Key());
+        }
+        if (keys.empty()) {
+            break;
+        }
+        for (const auto &key : keys) {
+            view.EraseBy<By>(key);
+        }
+        view.Flush();
+    }
+}
+
+void CPoolRewardHistoryView::InitPoolRewardHistory(bool enabled, uint32_t height) {
+    const auto start = GetPoolRewardHistoryStart();
+    if (enabled) {
+        if (!start) {
+            LogPrintf("Pool reward history is recorded from height %d\n", height);
+            WriteBy<ByPoolRewardHistoryStart>(START_HEIGHT_KEY, height);
+            startHeight = std::optional<uint32_t>{height};
+            Flush();
+        }
+        return;
+    }
+    if (!start) {
+        return;
+    }
+
+    LogPrintf("Dropping pool reward history...\n");
+
+    // Erase the marker first, so partially dropped history is never used
+    EraseBy<ByPoolRewardHistoryStart>(START_HEIGHT_KEY);
+    startHeight = std::optional<uint32_t>{};
+    Flush();
+
+    EraseAll<ByPoolRewardHistoryKey>(*this, PoolRewardHistoryKey{{}, ~0u, DCT_ID{0}});
+    EraseAll<ByPoolRewardHeightKey>(*this, PoolRewardHeightKey{~0u, {}});
+}
+
+std::optional<uint32_t> CPoolRewardHistoryView::GetPoolRewardHistoryStart() const {
+    if (!startHeight) {
+        startHeight = ReadBy<ByPoolRewardHistoryStart, uint32_t>(START_HEIGHT_KEY);
+    }
+    return *startHeight;
+}
+
+void CPoolRewardHistoryView::WritePoolRewardHistory(const PoolRewardHistoryKey &key,
+                                                    const PoolRewardHistoryValue &value) {
+    WriteBy<ByPoolRewardHistoryKey>(key, value);
+    WriteBy<ByPoolRewardHeightKey>(PoolRewardHeightKey{key.blockHeight, key.owner}, '\0');
+}
+
+Res CPoolRewardHistoryView::ErasePoolRewardHistoryHeight(uint32_t height) {
+    std::vector<PoolRewardHeightKey> heightKeys;
+    std::vector<PoolRewardHistoryKey> keys;
+
+    auto it = LowerBound<ByPoolRewardHeightKey>(PoolRewardHeightKey{height});
+    for (; it.Valid() && it.Key().blockHeight == height; it.Next()) {
+        heightKeys.push_back(it.Key());
+    }
+
+    for (const auto &heightKey : heightKeys) {
+        auto rewardIt = LowerBound<ByPoolRewardHistoryKey>(PoolRewardHistoryKey{heightKey.owner, height, DCT_ID{0}});
+        for (; rewardIt.Valid() && rewardIt.Key().owner == heightKey.owner && rewardIt.Key().blockHeight == height;
+             rewardIt.Next()) {
+            keys.push_back(rewardIt.Key());
+        }
+        EraseBy<ByPoolRewardHeightKey>(heightKey);
+    }
+
+    for (const auto &key : keys) {
+        EraseBy<ByPoolRewardHistoryKey>(key);
+    }
+    return Res::Ok();
+}
+
+void CPoolRewardHistoryView::ForEachPoolRewardHistory(
+    std::function<bool(const PoolRewardHistoryKey &, CLazySerialize<PoolRewardHistoryValue>)> callback,
+    const PoolRewardHistoryKey &start) {
+    ForEach<ByPoolRewardHistoryKey, PoolRewardHistoryKey, PoolRewardHistoryValue>(callback, start);
+}
+
+void CPoolRewardHistoryView::ForEachPoolRewardHeight(std::function<bool(const PoolRewardHeightKey &, char)> callback,
+                                                     const PoolRewardHeightKey &start) {
+    ForEach<ByPoolRewardHeightKey, PoolRewardHeightKey, char>(callback, start);
+}
@@ -0,0 +1,111 @@
+// Copyright (c) DeFi Blockchain Developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DEFI_DFI_POOLREWARDHISTORY_H
+#define DEFI_DFI_POOLREWARDHISTORY_H
+
+#include <amount.h>
+#include <flushablestorage.h>
+#include <script/script.h>
+
+#include <optional>
+
+// Rewards of a pool paid to an owner by a single settlement, keyed by the settlement height
+struct PoolRewardHistoryKey {
+    CScript owner;
+    uint32_t blockHeight;
+    DCT_ID poolID;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream &s, Operation ser_action) {
+        READWRITE(owner);
+
+        if (ser_action.ForRead()) {
+            READWRITE(WrapBigEndian(blockHeight));
+            blockHeight = ~blockHeight;
+        } else {
+            uint32_t blockHeight_ = ~blockHeight;
+            READWRITE(WrapBigEndian(blockHeight_));
+        }
+
+        READWRITE(WrapBigEndian(poolID.v));
+    }
+};
+
+// Height ordered index of settlements, used for listings over all owners and rollback
+struct PoolRewardHeightKey {
+    uint32_t blockHeight;
+    CScript owner;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream &s, Operation ser_action) {
+        if (ser_action.ForRead()) {
+            READWRITE(WrapBigEndian(blockHeight));
+            blockHeight = ~blockHeight;
+        } else {
+            uint32_t blockHeight_ = ~blockHeight;
+            READWRITE(WrapBigEndian(blockHeight_));
+        }
+
+        READWRITE(owner);
+    }
+};
+
+// Rewards for heights [firstHeight, lastHeight]. When perBlock is set every height
+// of the range received the amounts, otherwise they were paid once for the range.
+struct PoolRewardRun {
+    uint32_t firstHeight{};
+    uint32_t lastHeight{};
+    bool perBlock{};
+    std::vector<std::pair<uint8_t, CTokenAmount>> rewards;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream &s, Operation ser_action) {
+        READWRITE(firstHeight);
+        READWRITE(lastHeight);
+        READWRITE(perBlock);
+        READWRITE(rewards);
+    }
+};
+
+using PoolRewardHistoryValue = std::vector<PoolRewardRun>;
+
+class CPoolRewardHistoryView : public virtual CStorageView {
+    mutable std::optional<std::optional<uint32_t>> startHeight;
+
+public:
+    // Starts recording at height, or drops the recorded history when disabled
+    void InitPoolRewardHistory(bool enabled, uint32_t height);
+    // First height the history is complete from, none when it isn't recorded
+    [[nodiscard]] std::optional<uint32_t> GetPoolRewardHistoryStart() const;
+
+    void WritePoolRewardHistory(const PoolRewardHistoryKey &key, const PoolRewardHistoryValue &value);
+    Res ErasePoolRewardHistoryHeight(uint32_t height);
+    void ForEachPoolRewardHistory(
+        std::function<bool(const PoolRewardHistoryKey &, CLazySerialize<PoolRewardHistoryValue>)> callback,
+        const PoolRewardHistoryKey &start);
+    void ForEachPoolRewardHeight(std::function<bool(const PoolRewardHeightKey &, char)> callback,
+                                 const PoolRewardHeightKey &start);
+
+    // tags
+    struct ByPoolRewardHistoryKey {
+        static constexpr uint8_t prefix() { return 'R'; }
+    };
+    struct ByPoolRewardHeightKey {
+        static constexpr uint8_t prefix() { return 'r'; }
+    };
+    struct ByPoolRewardHistoryStart {
+        static constexpr uint8_t prefix() { return 'P'; }
+    };
+};
+
+static constexpr bool DEFAULT_REWARDHISTORYINDEX = false;
+
+#endif  // DEFI_DFI_POOLREWARDHISTORY_H
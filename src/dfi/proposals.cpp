@@ -78,6 +78,7 @@ Res CProposalView::CreateProposal(const CProposalId &propId,
     }
     prop.proposalEndHeight = height;
     WriteBy<ByType>(propId, prop);
+    WriteBy<ByVoteTally>(std::make_pair(propId, uint8_t{1}), CProposalVoteTally{prop.creationHeight});
     return Res::Ok();
 }
 
@@ -122,6 +123,7 @@ Res CProposalView::UpdateProposalCycle(const CProposalId &propId,
     }
 
     WriteBy<ByStatus>(key, cycle);
+    WriteBy<ByVoteTally>(std::make_pair(propId, cycle), CProposalVoteTally{static_cast<uint32_t>(height)});
 
     // Update values from attributes on each cycle
     auto prop = GetProposal(propId);
@@ -179,6 +181,14 @@ Res CProposalView::AddProposalVote(const CProposalId &propId, const uint256 &mas
     }
 
     CMnVotePerCycle key{propId, *cycle, masternodeId};
+    const auto tallyKey = std::make_pair(propId, *cycle);
+    if (auto tally = ReadBy<ByVoteTally, CProposalVoteTally>(tallyKey)) {
+        if (const auto prevVote = ReadBy<ByMnVote, uint8_t>(key)) {
+            tally->Add(static_cast<CProposalVoteType>(*prevVote), -1);
+        }
+        tally->Add(vote, 1);
+        WriteBy<ByVoteTally>(tallyKey, *tally);
+    }
     WriteBy<ByMnVote>(key, uint8_t(vote));
     return Res::Ok();
 }
@@ -194,6 +204,20 @@ std::optional<CProposalVoteType> CProposalView::GetProposalVote(const CProposalI
     return static_cast<CProposalVoteType>(*vote);
 }
 
+std::optional<CProposalVoteTally> CProposalView::GetProposalVoteTally(const CProposalId &propId, uint8_t cycle) {
+    return ReadBy<ByVoteTally, CProposalVoteTally>(std::make_pair(propId, cycle));
+}
+
+void CProposalVoteTally::Add(CProposalVoteType vote, int32_t count) {
+    if (vote == CProposalVoteType::VoteYes) {
+        yes += count;
+    } else if (vote == CProposalVoteType::VoteNo) {
+        no += count;
+    } else if (vote == CProposalVoteType::VoteNeutral) {
+        neutral += count;
+    }
+}
+
 void CProposalView::ForEachProposal(std::function<bool(const CProposalId &, const CProposalObject &)> callback,
                                     const CProposalStatusType status,
                                     const CProposalId start) {
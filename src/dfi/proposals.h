@@ -133,6 +133,28 @@ struct CMnVotePerCycle {
     }
 };
 
+/// Running vote counts of a proposal cycle, each masternode counted with its latest vote
+struct CProposalVoteTally {
+    // Height the cycle started at, masternodes changed from it are rechecked at cycle end
+    uint32_t startHeight{};
+    uint32_t yes{};
+    uint32_t no{};
+    uint32_t neutral{};
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream &s, Operation ser_action) {
+        READWRITE(startHeight);
+        READWRITE(yes);
+        READWRITE(no);
+        READWRITE(neutral);
+    }
+
+    [[nodiscard]] uint32_t Total() const { return yes + no + neutral; }
+    void Add(CProposalVoteType vote, int32_t count);
+};
+
 /// View for managing proposals and their data
 class CProposalView : public virtual CStorageView {
 public:
@@ -147,6 +169,8 @@ public:
     std::optional<CProposalVoteType> GetProposalVote(const CProposalId &propId,
                                                      uint8_t cycle,
                                                      const uint256 &masternodeId);
+    // Vote counts of cycles started before tallies were introduced are not available
+    std::optional<CProposalVoteTally> GetProposalVoteTally(const CProposalId &propId, uint8_t cycle);
 
     void ForEachProposal(std::function<bool(const CProposalId &, const CProposalObject &)> callback,
                          const CProposalStatusType status,
@@ -178,6 +202,9 @@ public:
     struct ByVoting {
         static constexpr uint8_t prefix() { return 0x2F; }
     };
+    struct ByVoteTally {
+        static constexpr uint8_t prefix() { return 0x1D; }
+    };
 };
 
 #endif  // DEFI_DFI_PROPOSALS_H
@@ -2,11 +2,13 @@
 #include <dfi/accountshistory.h>
 #include <dfi/govvariables/attributes.h>
 #include <dfi/mn_rpc.h>
+#include <dfi/parallelscan.h>
 #include <dfi/threadpool.h>
 #include <dfi/validation.h>
 #include <dfi/vaulthistory.h>
 #include <ffi/ffihelpers.h>
-#include <boost/asio.hpp>
+
+#include <queue>
 
 static bool DEFAULT_DVM_OWNERSHIP_CHECK = true;
 
@@ -213,6 +215,125 @@ static void onPoolRewards(CCustomCSView &view,
     });
 }
 
+// Lists pool rewards in [begin, end) of owner, or of all owners when empty, newest first.
+// Settled rewards are read from the history index, rewards of a single owner
+// not settled yet are calculated on top. Stops once count rewards above
+// everything left to read were accepted by onReward.
+static void onPoolRewardHistory(CCustomCSView &view,
+                                CAccountHistoryStorage &history,
+                                const CScript &owner,
+                                const uint32_t begin,
+                                const uint32_t end,
+                                const size_t count,
+                                std::function<bool(const CScript &)> isMatchOwner,
+                                std::function<bool(const CScript &, uint32_t, DCT_ID, RewardType, CTokenAmount)> onReward) {
+    // heights of the newest count accepted rewards
+    std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<>> accepted;
+    auto isFull = [&]() { return count != 0 && accepted.size() >= count; };
+    auto addReward = [&](const CScript &rewardOwner, uint32_t height, DCT_ID poolId, RewardType type, CTokenAmount amount) {
+        if (onReward(rewardOwner, height, poolId, type, amount)) {
+            accepted.push(height);
+            if (count != 0 && accepted.size() > count) {
+                accepted.pop();
+            }
+        }
+    };
+    // rewards of a settlement are at least one block below it
+    auto isSettlementNeeded = [&](uint32_t height) { return height > begin && !(isFull() && accepted.top() + 1 >= height); };
+
+    if (!owner.empty()) {
+        if (const auto settled = view.GetBalancesHeight(owner); settled < end) {
+            onPoolRewards(view,
+                          owner,
+                          std::max(settled, begin),
+                          end,
+                          [&](uint32_t height, DCT_ID poolId, RewardType type, CTokenAmount amount) {
+                              addReward(owner, height, poolId, type, amount);
+                          });
+        }
+    }
+
+    struct Cursor {
+        DCT_ID poolId;
+        const PoolRewardRun *run;
+        uint32_t height;
+        uint32_t bottom;
+    };
+
+    auto onSettlement = [&](const CScript &settlementOwner, const std::vector<std::pair<DCT_ID, PoolRewardHistoryValue>> &pools) {
+        std::vector<Cursor> cursors;
+        for (const auto &[poolId, runs] : pools) {
+            for (const auto &run : runs) {
+                // rewards paid once for a range are listed at its last height
+                const auto bottom = run.perBlock ? std::max(run.firstHeight, begin) : run.lastHeight;
+                if (bottom >= begin && bottom < end) {
+                    cursors.push_back({poolId, &run, std::min(run.lastHeight, end - 1), bottom});
+                }
+            }
+        }
+        // walk heights of all runs from the top, until the rest can't get into the listing
+        while (!cursors.empty()) {
+            auto it = std::max_element(cursors.begin(), cursors.end(), [](const Cursor &a, const Cursor &b) {
+                return a.height < b.height;
+            });
+            if (isFull() && it->height < accepted.top()) {
+                break;
+            }
+            for (const auto &[type, amount] : it->run->rewards) {
+                addReward(settlementOwner, it->height, it->poolId, static_cast<RewardType>(type), amount);
+            }
+            if (it->height == it->bottom) {
+                cursors.erase(it);
+            } else {
+                --it->height;
+            }
+        }
+    };
+
+    auto readSettlement = [&](const CScript &settlementOwner, uint32_t height) {
+        std::vector<std::pair<DCT_ID, PoolRewardHistoryValue>> pools;
+        history.ForEachPoolRewardHistory(
+            [&](const PoolRewardHistoryKey &key, CLazySerialize<PoolRewardHistoryValue> value) {
+                if (key.owner != settlementOwner || key.blockHeight != height) {
+                    return false;
+                }
+                pools.emplace_back(key.poolID, value.get());
+                return true;
+            },
+            {settlementOwner, height, DCT_ID{0}});
+        onSettlement(settlementOwner, pools);
+    };
+
+    if (!owner.empty()) {
+        std::optional<uint32_t> lastHeight;
+        history.ForEachPoolRewardHistory(
+            [&](const PoolRewardHistoryKey &key, CLazySerialize<PoolRewardHistoryValue>) {
+                if (key.owner != owner || !isSettlementNeeded(key.blockHeight)) {
+                    return false;
+                }
+                if (key.blockHeight != lastHeight) {
+                    lastHeight = key.blockHeight;
+                    readSettlement(owner, key.blockHeight);
+                }
+                return true;
+            },
+            {owner, std::numeric_limits<uint32_t>::max(), DCT_ID{0}});
+        return;
+    }
+
+    history.ForEachPoolRewardHeight(
+        [&](const PoolRewardHeightKey &key, char) {
+            if (!isSettlementNeeded(key.blockHeight)) {
+                return false;
+            }
+            if (isMatchOwner(key.owner)) {
+                readSettlement(key.owner, key.blockHeight);
+            }
+            return true;
+        },
+        {std::numeric_limits<uint32_t>::max(), {}});
+}
+
 static void searchInWallet(const CWallet *pwallet,
                            const CScript &account,
                            isminetype filter,
@@ -426,38 +547,74 @@ UniValue listaccounts(const JSONRPCRequest &request) {
         isMineOnly = request.params[3].get_bool();
     }
 
-    UniValue ret(UniValue::VARR);
-
     auto [view, accountView, vaultView] = GetSnapshots();
     auto targetHeight = view->GetLastHeight() + 1;
 
     CalcMissingRewardTempFix(*view, targetHeight, *pwallet);
 
-    view->ForEachAccount(
-        [&, &view = view](const CScript &account) {
-            if (isMineOnly && IsMineCached(*pwallet, account) != ISMINE_SPENDABLE) {
-                return true;
-            }
-
-            view->CalculateOwnerRewards(account, targetHeight);
-
-            // output the relavant balances only for account
-            view->ForEachBalance(
-                [&](CScript const &owner, CTokenAmount balance) {
-                    if (account != owner) {
+    RPCResultWriter ret(request, UniValue::VARR);
+
+    // Accounts are scanned in key ranges in parallel, rewards are calculated in a view per range.
+    // A streamed reply is scanned serially, buffered ranges would hold all of it in memory.
+    const auto ranges = view->SplitRange<CAccountsView::ByHeightKey>(
+        start.owner, ret.IsStreaming() ? 1 : ParallelScanRanges(limit));
+    const auto serial = ranges.size() == 1;
+    std::atomic<size_t> remaining{limit};
+    // A serial scan writes straight to the reply, ranges buffer up to what the reply still misses
+    const auto emit = [&](std::vector<UniValue> &balances, const UniValue &balance) {
+        if (serial) {
+            // stop once the client is gone
+            return ret.push_back(balance) && --limit != 0;
+        }
+        balances.push_back(balance);
+        return balances.size() < remaining.load(std::memory_order_relaxed);
+    };
+    ParallelScan<std::vector<UniValue>>(
+        ranges.size(),
+        [&, &view = view](size_t i, std::vector<UniValue> &balances, const std::atomic_bool &stop) {
+            CCustomCSView rangeView(*view);
+            auto startTokenID = i == 0 ? start.tokenID : DCT_ID{};
+            bool more{true};
+
+            rangeView.ForEachAccount(
+                [&](const CScript &account) {
+                    if (stop || !ranges[i].Contains(account)) {
                         return false;
                     }
-                    ret.push_back(accountToJSON(*view, owner, balance, verbose, indexed_amounts));
-                    return --limit != 0;
-                },
-                {account, start.tokenID});
+                    if (isMineOnly && IsMineCached(*pwallet, account) != ISMINE_SPENDABLE) {
+                        return true;
+                    }
 
-            start.tokenID = DCT_ID{};  // reset to start id
-            return limit != 0;
+                    rangeView.CalculateOwnerRewards(account, targetHeight);
+
+                    // output the relavant balances only for account
+                    rangeView.ForEachBalance(
+                        [&](CScript const &owner, CTokenAmount balance) {
+                            if (account != owner) {
+                                return false;
+                            }
+                            more = emit(balances, accountToJSON(rangeView, owner, balance, verbose, indexed_amounts));
+                            return more;
+                        },
+                        {account, startTokenID});
+
+                    startTokenID = DCT_ID{};  // reset to start id
+                    return more;
+                },
+                ranges[i].start);
         },
-        start.owner);
+        [&](std::vector<UniValue> &balances) {
+            for (const auto &balance : balances) {
+                // stop once the client is gone
+                if (!ret.push_back(balance) || --limit == 0) {
+                    return false;
+                }
+            }
+            remaining.store(limit, std::memory_order_relaxed);
+            return true;
+        });
 
-    return GetRPCResultCache().Set(request, ret);
+    return GetRPCResultCache().Set(request, ret.get());
 }
 
 UniValue getaccount(const JSONRPCRequest &request) {
@@ -1219,7 +1376,10 @@ UniValue listaccounthistory(const JSONRPCRequest &request) {
 
     RPCHelpMan{
         "listaccounthistory",
-        "\nReturns information about account history.\n",
+        "\nReturns information about account history.\n"
+        "With -rewardhistoryindex, rewards are read from the index when it covers the requested range. "
+        "Rewards paid once for a range of blocks are listed at its last block and rewards of \"mine\" "
+        "or \"all\" listings are limited to the ones already paid out.\n",
         {
           {"owner",
              RPCArg::Type::STR,
@@ -1442,12 +1602,19 @@ UniValue listaccounthistory(const JSONRPCRequest &request) {
     maxBlockHeight = std::min(maxBlockHeight, height);
     depth = std::min(depth, maxBlockHeight);
 
+    const auto rewardHistoryStart = accountView->GetPoolRewardHistoryStart();
+
     for (const auto &account : accountSet) {
         const auto startBlock = maxBlockHeight - depth;
         auto shouldSkipBlock = [startBlock, maxBlockHeight](uint32_t blockHeight) {
             return startBlock > blockHeight || blockHeight > maxBlockHeight;
         };
 
+        // recorded rewards are listed directly when they cover the whole range
+        const bool rewardsFromHistory =
+            !noRewards && !hasTxFilter && rewardHistoryStart && *rewardHistoryStart <= startBlock;
+        const bool recalculateRewards = !noRewards && !rewardsFromHistory;
+
         CScript lastOwner;
         auto count = limit + start;
         auto lastHeight = maxBlockHeight;
@@ -1465,7 +1632,7 @@ UniValue listaccounthistory(const JSONRPCRequest &request) {
             }
 
             std::unique_ptr<CScopeAccountReverter> reverter;
-            if (!noRewards) {
+            if (recalculateRewards) {
                 reverter = std::make_unique<CScopeAccountReverter>(*view, key.owner, value.diff);
             }
 
@@ -1474,7 +1641,7 @@ UniValue listaccounthistory(const JSONRPCRequest &request) {
 
             if (shouldSkipBlock(key.blockHeight)) {
                 // show rewards in interval [startBlock, lastHeight)
-                if (!noRewards && startBlock > workingHeight) {
+                if (recalculateRewards && startBlock > workingHeight) {
                     accountRecord = false;
                     workingHeight = startBlock;
                 } else {
@@ -1514,7 +1681,7 @@ UniValue listaccounthistory(const JSONRPCRequest &request) {
                 --count;
             }
 
-            if (!noRewards && count && lastHeight > workingHeight) {
+            if (recalculateRewards && count && lastHeight > workingHeight) {
                 onPoolRewards(*view,
                               key.owner,
                               workingHeight,
@@ -1536,7 +1703,7 @@ UniValue listaccounthistory(const JSONRPCRequest &request) {
             return count != 0 || isMine;
         };
 
-        if (!noRewards && !account.empty()) {
+        if (recalculateRewards && !account.empty()) {
             // revert previous tx to restore account balances to maxBlockHeight
             accountView->ForEachAccountHistory(
                 [&, &view = view](const AccountHistoryKey &key, const AccountHistoryValue &value) {
@@ -1554,6 +1721,28 @@ UniValue listaccounthistory(const JSONRPCRequest &request) {
 
         accountView->ForEachAccountHistory(shouldContinueToNextAccountHistory, account, maxBlockHeight, txn);
 
+        if (rewardsFromHistory) {
+            onPoolRewardHistory(
+                *view,
+                *accountView,
+                account,
+                startBlock,
+                maxBlockHeight,
+                static_cast<size_t>(limit) + start,
+                [&](const CScript &owner) { return !isMine || (IsMineCached(*pwallet, owner) & filter); },
+                [&, &view = view](
+                    const CScript &owner, uint32_t height, DCT_ID poolId, RewardType type, CTokenAmount amount) {
+                    if (!tokenFilter.empty() && !hasToken({
+                                                    {amount.nTokenId, amount.nValue}
+                    })) {
+                        return false;
+                    }
+                    auto &array = ret.emplace(height, UniValue::VARR).first->second;
+                    array.push_back(rewardhistoryToJSON(*view, owner, height, poolId, type, amount, format));
+                    return true;
+                });
+        }
+
         if (shouldSearchInWallet) {
             count = limit + start;
             searchInWallet(
@@ -1577,20 +1766,21 @@ UniValue listaccounthistory(const JSONRPCRequest &request) {
         }
     }
 
-    UniValue slice(UniValue::VARR);
-    for (auto it = ret.cbegin(); limit != 0 && it != ret.cend(); ++it) {
+    // history is ordered by height across accounts, so only the final slice can be streamed;
+    // heights already written are dropped as we go
+    RPCResultWriter slice(request, UniValue::VARR);
+    for (auto it = ret.begin(); limit != 0 && it != ret.end(); it = ret.erase(it)) {
         const auto &array = it->second.get_array();
         for (size_t i = 0; limit != 0 && i < array.size(); ++i) {
             if (start != 0) {
                 --start;
                 continue;
             }
-            slice.push_back(array[i]);
-            --limit;
+            limit = slice.push_back(array[i]) ? limit - 1 : 0;
         }
     }
 
-    return GetRPCResultCache().Set(request, slice);
+    return GetRPCResultCache().Set(request, slice.get());
 }
 
 UniValue getaccounthistory(const JSONRPCRequest &request) {
@@ -2592,97 +2782,95 @@ UniValue getburninfo(const JSONRPCRequest &request) {
     const auto chunkSize = height / nWorkers;
 
     TaskGroup g;
-    BufferPool<CGetBurnInfoResult> resultsPool{nWorkers};
+    // Every chunk gets its own result, deque keeps them in place while tasks run
+    std::deque<CGetBurnInfoResult> results;
 
     LOCK(cs_main);  // Lock for pburnHistoryDB
 
-    auto &pool = DfTxTaskPool->pool;
     auto processedHeight = initialResult.height;
     auto i = 0;
     while (processedHeight < height) {
         auto startHeight = initialResult.height + (chunkSize * (i + 1));
         auto stopHeight = initialResult.height + (chunkSize * (i));
 
-        g.AddTask();
-        boost::asio::post(pool, [startHeight, stopHeight, &g, &resultsPool] {
-            auto currentResult = resultsPool.Acquire();
+        auto currentResult = &results.emplace_back();
+        DfTxTaskPool->Post(
+            g,
+            [startHeight, stopHeight, currentResult] {
+                pburnHistoryDB->ForEachAccountHistory(
+                    [currentResult, stopHeight](const AccountHistoryKey &key, const AccountHistoryValue &value) {
+                        // Stop on chunk range for worker
+                        if (key.blockHeight <= stopHeight) {
+                            return false;
+                        }
 
-            pburnHistoryDB->ForEachAccountHistory(
-                [currentResult, stopHeight](const AccountHistoryKey &key, const AccountHistoryValue &value) {
-                    // Stop on chunk range for worker
-                    if (key.blockHeight <= stopHeight) {
-                        return false;
-                    }
+                        // UTXO burn
+                        if (value.category == uint8_t(CustomTxType::None)) {
+                            for (auto const &diff : value.diff) {
+                                currentResult->burntDFI += diff.second;
+                            }
+                            return true;
+                        }
 
-                    // UTXO burn
-                    if (value.category == uint8_t(CustomTxType::None)) {
-                        for (auto const &diff : value.diff) {
-                            currentResult->burntDFI += diff.second;
+                        // Fee burn
+                        if (value.category == uint8_t(CustomTxType::CreateMasternode) ||
+                            value.category == uint8_t(CustomTxType::CreateToken) ||
+                            value.category == uint8_t(CustomTxType::Vault) ||
+                            value.category == uint8_t(CustomTxType::CreateCfp) ||
+                            value.category == uint8_t(CustomTxType::CreateVoc)) {
+                            for (auto const &diff : value.diff) {
+                                currentResult->burntFee += diff.second;
+                            }
+                            return true;
                         }
-                        return true;
-                    }
 
-                    // Fee burn
-                    if (value.category == uint8_t(CustomTxType::CreateMasternode) ||
-                        value.category == uint8_t(CustomTxType::CreateToken) ||
-                        value.category == uint8_t(CustomTxType::Vault) ||
-                        value.category == uint8_t(CustomTxType::CreateCfp) ||
-                        value.category == uint8_t(CustomTxType::CreateVoc)) {
-                        for (auto const &diff : value.diff) {
-                            currentResult->burntFee += diff.second;
+                        // withdraw burn
+                        if (value.category == uint8_t(CustomTxType::PaybackLoan) ||
+                            value.category == uint8_t(CustomTxType::PaybackLoanV2) ||
+                            value.category == uint8_t(CustomTxType::PaybackWithCollateral)) {
+                            for (const auto &[id, amount] : value.diff) {
+                                currentResult->paybackFee.Add({id, amount});
+                            }
+                            return true;
                         }
-                        return true;
-                    }
 
-                    // withdraw burn
-                    if (value.category == uint8_t(CustomTxType::PaybackLoan) ||
-                        value.category == uint8_t(CustomTxType::PaybackLoanV2) ||
-                        value.category == uint8_t(CustomTxType::PaybackWithCollateral)) {
-                        for (const auto &[id, amount] : value.diff) {
-                            currentResult->paybackFee.Add({id, amount});
+                        // auction burn
+                        if (value.category == uint8_t(CustomTxType::AuctionBid)) {
+                            for (auto const &diff : value.diff) {
+                                currentResult->auctionFee += diff.second;
+                            }
+                            return true;
                         }
-                        return true;
-                    }
 
-                    // auction burn
-                    if (value.category == uint8_t(CustomTxType::AuctionBid)) {
-                        for (auto const &diff : value.diff) {
-                            currentResult->auctionFee += diff.second;
+                        // dex fee burn
+                        if (value.category == uint8_t(CustomTxType::PoolSwap) ||
+                            value.category == uint8_t(CustomTxType::PoolSwapV2)) {
+                            for (auto const &diff : value.diff) {
+                                currentResult->dexfeeburn.Add({diff.first, diff.second});
+                            }
+                            return true;
                         }
-                        return true;
-                    }
 
-                    // dex fee burn
-                    if (value.category == uint8_t(CustomTxType::PoolSwap) ||
-                        value.category == uint8_t(CustomTxType::PoolSwapV2)) {
-                        for (auto const &diff : value.diff) {
-                            currentResult->dexfeeburn.Add({diff.first, diff.second});
+                        // token burn with burnToken tx
+                        if (value.category == uint8_t(CustomTxType::BurnToken)) {
+                            for (auto const &diff : value.diff) {
+                                currentResult->burntTokens.Add({diff.first, diff.second});
+                            }
+                            return true;
                         }
-                        return true;
-                    }
 
-                    // token burn with burnToken tx
-                    if (value.category == uint8_t(CustomTxType::BurnToken)) {
+                        // Token burn
                         for (auto const &diff : value.diff) {
                             currentResult->burntTokens.Add({diff.first, diff.second});
                         }
-                        return true;
-                    }
-
-                    // Token burn
-                    for (auto const &diff : value.diff) {
-                        currentResult->burntTokens.Add({diff.first, diff.second});
-                    }
-
-                    return true;
-                },
-                {},
-                startHeight,
-                std::numeric_limits<uint32_t>::max());
 
-            resultsPool.Release(currentResult);
-            g.RemoveTask();
-        });
+                        return true;
+                    },
+                    {},
+                    startHeight,
+                    std::numeric_limits<uint32_t>::max());
+            },
+            TaskPriority::RPC);
 
         // perfect accuracy: processedHeight += (startHeight > height) ? chunksRemainder : chunkSize;
         processedHeight += chunkSize;
@@ -2691,13 +2879,13 @@ UniValue getburninfo(const JSONRPCRequest &request) {
 
     g.WaitForCompletion();
 
-    for (const auto &r : resultsPool.GetBuffer()) {
-        totalResult->burntDFI += r->burntDFI;
-        totalResult->burntFee += r->burntFee;
-        totalResult->auctionFee += r->auctionFee;
-        totalResult->burntTokens.AddBalances(r->burntTokens.balances);
-        totalResult->dexfeeburn.AddBalances(r->dexfeeburn.balances);
-        totalResult->paybackFee.AddBalances(r->paybackFee.balances);
+    for (const auto &r : results) {
+        totalResult->burntDFI += r.burntDFI;
+        totalResult->burntFee += r.burntFee;
+        totalResult->auctionFee += r.auctionFee;
+        totalResult->burntTokens.AddBalances(r.burntTokens.balances);
+        totalResult->dexfeeburn.AddBalances(r.dexfeeburn.balances);
+        totalResult->paybackFee.AddBalances(r.paybackFee.balances);
     }
 
     GetMemoizedResultCache().Set(request, {height, hash, *totalResult});
@@ -3417,17 +3605,34 @@ UniValue logaccountbalances(const JSONRPCRequest &request) {
 
     std::map<std::string, std::vector<CTokenAmount>> accounts;
     size_t count{};
-    view->ForEachBalance([&](const CScript &owner, CTokenAmount balance) {
-        ++count;
-        auto ownerStr = ScriptToString(owner);
-        if (outToLog) {
-            LogPrintf("AccountBalance: (%s: %d@%d)\n", ownerStr, balance.nValue, balance.nTokenId.v);
-        }
-        if (outToRpc) {
-            accounts[ownerStr].push_back(CTokenAmount{{balance.nTokenId.v}, balance.nValue});
-        }
-        return true;
-    });
+    using Balances = std::vector<std::pair<std::string, CTokenAmount>>;
+    const auto ranges = view->SplitRange<CAccountsView::ByBalanceKey>(BalanceKey{}, ParallelScanRanges());
+    ParallelScan<Balances>(
+        ranges.size(),
+        [&, &view = view](size_t i, Balances &balances, const std::atomic_bool &stop) {
+            view->ForEachBalance(
+                [&](const CScript &owner, CTokenAmount balance) {
+                    if (stop || !ranges[i].Contains({owner, balance.nTokenId})) {
+                        return false;
+                    }
+                    balances.emplace_back(ScriptToString(owner), balance);
+                    return true;
+                },
+                ranges[i].start);
+        },
+        // balances are logged in key order
+        [&](Balances &balances) {
+            for (const auto &[ownerStr, balance] : balances) {
+                ++count;
+                if (outToLog) {
+                    LogPrintf("AccountBalance: (%s: %d@%d)\n", ownerStr, balance.nValue, balance.nTokenId.v);
+                }
+                if (outToRpc) {
+                    accounts[ownerStr].push_back(CTokenAmount{{balance.nTokenId.v}, balance.nValue});
+                }
+            }
+            return true;
+        });
 
     if (outToLog) {
         LogPrintf("IndexStats: (balances: %d)\n", count);
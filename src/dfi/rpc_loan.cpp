@@ -1,4 +1,3 @@
-#include <boost/asio.hpp>
 
 #include <dfi/accountshistory.h>
 #include <dfi/govvariables/attributes.h>
@@ -1498,6 +1497,28 @@ UniValue paybackloan(const JSONRPCRequest &request) {
     return signsend(rawTx, pwallet, optAuthTx)->GetHash().GetHex();
 }
 
+static UniValue interestToJSON(CCustomCSView &view,
+                               const DCT_ID id,
+                               const CInterestAmount &cumulativeInterest,
+                               const CInterestAmount &totalInterestPerBlock,
+                               const uint32_t height) {
+    const auto totalInterest = cumulativeInterest.negative ? -CeilInterest(cumulativeInterest.amount, height)
+                                                           : CeilInterest(cumulativeInterest.amount, height);
+    const auto interestPerBlock = totalInterestPerBlock.negative ? -CeilInterest(totalInterestPerBlock.amount, height)
+                                                                 : CeilInterest(totalInterestPerBlock.amount, height);
+
+    UniValue obj(UniValue::VOBJ);
+    const auto token = view.GetToken(id);
+    obj.pushKV("token", token->CreateSymbolKey(id));
+    obj.pushKV("totalInterest", ValueFromAmount(totalInterest));
+    obj.pushKV("interestPerBlock", ValueFromAmount(interestPerBlock));
+    if (height >= static_cast<uint32_t>(Params().GetConsensus().DF14FortCanningHillHeight)) {
+        obj.pushKV("realizedInterestPerBlock",
+                   UniValue(UniValue::VNUM, GetInterestPerBlockHighPrecisionString(totalInterestPerBlock)));
+    }
+    return obj;
+}
+
 UniValue getloaninfo(const JSONRPCRequest &request) {
     RPCHelpMan{
         "getloaninfo",
@@ -1532,83 +1553,81 @@ UniValue getloaninfo(const JSONRPCRequest &request) {
     auto priceBlocks = GetFixedIntervalPriceBlocks(*view);
 
     TaskGroup g;
-    g.AddTask();
-
-    auto &pool = DfTxTaskPool->pool;
 
-    boost::asio::post(pool, [&, &view = view] {
-        view->ForEachLoanScheme([&](const std::string &identifier, const CLoanSchemeData &data) {
-            totalLoanSchemes++;
-            return true;
-        });
-
-        // First assume it's on the DB. For later, might be worth thinking if it's better to incorporate
-        // attributes right into the for each loop, so the interface remains consistent.
-        view->ForEachLoanCollateralToken([&](CollateralTokenKey const &key, uint256 const &collTokenTx) {
-            totalCollateralTokens++;
-            return true;
-        });
-
-        view->ForEachLoanToken([&](DCT_ID const &key, CLoanView::CLoanSetLoanTokenImpl loanToken) {
-            totalLoanTokens++;
-            return true;
-        });
-
-        // Now, let's go over attributes. If it's on attributes, the above calls would have done nothing.
-        auto attributes = view->GetAttributes();
+    DfTxTaskPool->Post(
+        g,
+        [&, &view = view] {
+            view->ForEachLoanScheme([&](const std::string &identifier, const CLoanSchemeData &data) {
+                totalLoanSchemes++;
+                return true;
+            });
 
-        attributes->ForEach(
-            [&](const CDataStructureV0 &attr, const CAttributeValue &) {
-                if (attr.type != AttributeTypes::Token) {
-                    return false;
-                }
-                if (attr.key == TokenKeys::LoanCollateralEnabled) {
-                    totalCollateralTokens++;
-                } else if (attr.key == TokenKeys::LoanMintingEnabled) {
-                    totalLoanTokens++;
-                }
+            // First assume it's on the DB. For later, might be worth thinking if it's better to incorporate
+            // attributes right into the for each loop, so the interface remains consistent.
+            view->ForEachLoanCollateralToken([&](CollateralTokenKey const &key, uint256 const &collTokenTx) {
+                totalCollateralTokens++;
                 return true;
-            },
-            CDataStructureV0{AttributeTypes::Token});
+            });
 
-        view->ForEachVaultAuction(
-            [&](const CVaultId &vaultId, const CAuctionData &data) {
-                totalAuctions += data.batchCount;
+            view->ForEachLoanToken([&](DCT_ID const &key, CLoanView::CLoanSetLoanTokenImpl loanToken) {
+                totalLoanTokens++;
                 return true;
-            },
-            height);
+            });
+
+            // Now, let's go over attributes. If it's on attributes, the above calls would have done nothing.
+            auto attributes = view->GetAttributes();
+
+            attributes->ForEach(
+                [&](const CDataStructureV0 &attr, const CAttributeValue &) {
+                    if (attr.type != AttributeTypes::Token) {
+                        return false;
+                    }
+                    if (attr.key == TokenKeys::LoanCollateralEnabled) {
+                        totalCollateralTokens++;
+                    } else if (attr.key == TokenKeys::LoanMintingEnabled) {
+                        totalLoanTokens++;
+                    }
+                    return true;
+                },
+                CDataStructureV0{AttributeTypes::Token});
 
-        g.RemoveTask();
-    });
+            view->ForEachVaultAuction(
+                [&](const CVaultId &vaultId, const CAuctionData &data) {
+                    totalAuctions += data.batchCount;
+                    return true;
+                },
+                height);
+        },
+        TaskPriority::RPC);
 
     std::atomic<uint64_t> vaultsTotal{0};
     std::atomic<uint64_t> colsValTotal{0};
     std::atomic<uint64_t> loansValTotal{0};
 
     view->ForEachVault([&, &view = view](const CVaultId &vaultId, const CVaultData &data) {
-        g.AddTask();
-        boost::asio::post(pool,
-                          [&,
-                           &colsValTotal = colsValTotal,
-                           &loansValTotal = loansValTotal,
-                           &vaultsTotal = vaultsTotal,
-                           vaultId = vaultId,
-                           height = height,
-                           useNextPrice = useNextPrice,
-                           requireLivePrice = requireLivePrice] {
-                              auto collaterals = view->GetVaultCollaterals(vaultId);
-                              if (!collaterals) {
-                                  collaterals = CBalances{};
-                              }
-                              auto rate = view->GetVaultAssets(
-                                  vaultId, *collaterals, height, lastBlockTime, useNextPrice, requireLivePrice);
-                              if (rate) {
-                                  colsValTotal.fetch_add(rate.val->totalCollaterals, std::memory_order_relaxed);
-                                  loansValTotal.fetch_add(rate.val->totalLoans, std::memory_order_relaxed);
-                              }
-                              vaultsTotal.fetch_add(1, std::memory_order_relaxed);
-                              g.RemoveTask();
-                          });
+        DfTxTaskPool->Post(
+            g,
+            [&,
+             &colsValTotal = colsValTotal,
+             &loansValTotal = loansValTotal,
+             &vaultsTotal = vaultsTotal,
+             vaultId = vaultId,
+             height = height,
+             useNextPrice = useNextPrice,
+             requireLivePrice = requireLivePrice] {
+                auto collaterals = view->GetVaultCollaterals(vaultId);
+                if (!collaterals) {
+                    collaterals = CBalances{};
+                }
+                auto rate =
+                    view->GetVaultAssets(vaultId, *collaterals, height, lastBlockTime, useNextPrice, requireLivePrice);
+                if (rate) {
+                    colsValTotal.fetch_add(rate.val->totalCollaterals, std::memory_order_relaxed);
+                    loansValTotal.fetch_add(rate.val->totalLoans, std::memory_order_relaxed);
+                }
+                vaultsTotal.fetch_add(1, std::memory_order_relaxed);
+            },
+            TaskPriority::RPC);
         return true;
     });
 
@@ -1645,6 +1664,19 @@ UniValue getloaninfo(const JSONRPCRequest &request) {
     ret.pushKV("defaults", defaultsObj);
     ret.pushKV("totals", totalsObj);
 
+    // Outstanding interest per loan token across all schemes, read from the running tally
+    if (view->IsLoanInterestTallyReady()) {
+        UniValue interestArr{UniValue::VARR};
+        view->ForEachLoanInterestTally([&, &view = view](DCT_ID id, const CInterestRateV3 &tally) {
+            if (view->GetToken(id)) {
+                interestArr.push_back(
+                    interestToJSON(*view, id, TotalInterestCalculation(tally, height), tally.interestPerBlock, height));
+            }
+            return true;
+        });
+        ret.pushKV("interest", interestArr);
+    }
+
     return GetRPCResultCache().Set(request, ret);
 }
 
@@ -1734,26 +1766,9 @@ UniValue getinterest(const JSONRPCRequest &request) {
         });
     }
 
-    UniValue obj(UniValue::VOBJ);
-    for (auto it = interest.begin(); it != interest.end(); ++it) {
-        const auto &tokenId = it->first;
-        const auto &[cumulativeInterest, totalInterestPerBlock] = it->second;
-
-        const auto totalInterest = cumulativeInterest.negative ? -CeilInterest(cumulativeInterest.amount, height)
-                                                               : CeilInterest(cumulativeInterest.amount, height);
-        const auto interestPerBlock = totalInterestPerBlock.negative
-                                          ? -CeilInterest(totalInterestPerBlock.amount, height)
-                                          : CeilInterest(totalInterestPerBlock.amount, height);
-
-        const auto token = view->GetToken(tokenId);
-        obj.pushKV("token", token->CreateSymbolKey(tokenId));
-        obj.pushKV("totalInterest", ValueFromAmount(totalInterest));
-        obj.pushKV("interestPerBlock", ValueFromAmount(interestPerBlock));
-        if (height >= Params().GetConsensus().DF14FortCanningHillHeight) {
-            obj.pushKV("realizedInterestPerBlock",
-                       UniValue(UniValue::VNUM, GetInterestPerBlockHighPrecisionString(totalInterestPerBlock)));
-        }
-        ret.push_back(obj);
+    for (const auto &[tokenId, amounts] : interest) {
+        const auto &[cumulativeInterest, totalInterestPerBlock] = amounts;
+        ret.push_back(interestToJSON(*view, tokenId, cumulativeInterest, totalInterestPerBlock, height));
     }
     return GetRPCResultCache().Set(request, ret);
 }
@@ -885,6 +885,48 @@ UniValue listlatestrawprices(const JSONRPCRequest &request) {
     return GetRPCResultCache().Set(request, result);
 }
 
+static void AddOraclePrice(CAggregatePrice &aggregate,
+                           const COracle &oracle,
+                           const CPriceTimePair &pricePair,
+                           uint64_t lastBlockTime) {
+    auto amount = pricePair.first;
+    auto timestamp = pricePair.second;
+    if (!diffInHour(timestamp, lastBlockTime)) {
+        return;
+    }
+    ++aggregate.numLiveOracles;
+    aggregate.sumWeights += oracle.weightage;
+    aggregate.weightedSum += arith_uint256(amount) * arith_uint256(oracle.weightage);
+}
+
+ResVal<CAmount> GetAggregatePrice(const CAggregatePrice &aggregate,
+                                  const std::string &token,
+                                  const std::string &currency) {
+    // DUSD-USD always returns 1.00000000
+    if (token == "DUSD" && currency == "USD") {
+        return ResVal<CAmount>(COIN, Res::Ok());
+    }
+
+    static const uint64_t minimumLiveOracles = Params().NetworkIDString() == CBaseChainParams::REGTEST ? 1 : 2;
+    if (aggregate.numLiveOracles < minimumLiveOracles) {
+        return Res::Err("no live oracles for specified request");
+    }
+    if (aggregate.sumWeights <= 0) {
+        return Res::Err("all live oracles which meet specified request, have zero weight");
+    }
+
+    ResVal<CAmount> res((aggregate.weightedSum / arith_uint256(aggregate.sumWeights)).GetLow64(), Res::Ok());
+
+    return res;
+}
+
+ResVal<CAmount> GetAggregatePrice(const CAggregatePrices &prices,
+                                  const std::string &token,
+                                  const std::string &currency) {
+    auto it = prices.find(std::make_pair(token, currency));
+    return GetAggregatePrice(it != prices.end() ? it->second : CAggregatePrice{}, token, currency);
+}
+
 ResVal<CAmount> GetAggregatePrice(CCustomCSView &view,
                                   const std::string &token,
                                   const std::string &currency,
@@ -893,45 +935,38 @@ ResVal<CAmount> GetAggregatePrice(CCustomCSView &view,
     if (token == "DUSD" && currency == "USD") {
         return ResVal<CAmount>(COIN, Res::Ok());
     }
-    arith_uint256 weightedSum = 0;
-    uint64_t numLiveOracles = 0, sumWeights = 0;
+    CAggregatePrice aggregate;
     view.ForEachOracle([&](const COracleId &, COracle oracle) {
         if (!oracle.SupportsPair(token, currency)) {
             return true;
         }
-        for (const auto &tokenPrice : oracle.tokenPrices) {
-            if (token != tokenPrice.first) {
-                continue;
-            }
-            for (const auto &price : tokenPrice.second) {
-                if (currency != price.first) {
-                    continue;
-                }
-                const auto &pricePair = price.second;
-                auto amount = pricePair.first;
-                auto timestamp = pricePair.second;
-                if (!diffInHour(timestamp, lastBlockTime)) {
-                    continue;
-                }
-                ++numLiveOracles;
-                sumWeights += oracle.weightage;
-                weightedSum += arith_uint256(amount) * arith_uint256(oracle.weightage);
+        if (auto tokenPrice = oracle.tokenPrices.find(token); tokenPrice != oracle.tokenPrices.end()) {
+            if (auto price = tokenPrice->second.find(currency); price != tokenPrice->second.end()) {
+                AddOraclePrice(aggregate, oracle, price->second, lastBlockTime);
             }
         }
         return true;
     });
 
-    static const uint64_t minimumLiveOracles = Params().NetworkIDString() == CBaseChainParams::REGTEST ? 1 : 2;
-    if (numLiveOracles < minimumLiveOracles) {
-        return Res::Err("no live oracles for specified request");
-    }
-    if (sumWeights <= 0) {
-        return Res::Err("all live oracles which meet specified request, have zero weight");
-    }
-
-    ResVal<CAmount> res((weightedSum / arith_uint256(sumWeights)).GetLow64(), Res::Ok());
+    return GetAggregatePrice(aggregate, token, currency);
+}
 
-    return res;
+CAggregatePrices GetAggregatePrices(CCustomCSView &view, uint64_t lastBlockTime) {
+    CAggregatePrices prices;
+    view.ForEachOracle([&](const COracleId &, COracle oracle) {
+        for (const auto &pair : oracle.availablePairs) {
+            prices.emplace(pair, CAggregatePrice{});
+        }
+        for (const auto &[token, currencyPrices] : oracle.tokenPrices) {
+            for (const auto &[currency, pricePair] : currencyPrices) {
+                if (oracle.SupportsPair(token, currency)) {
+                    AddOraclePrice(prices[std::make_pair(token, currency)], oracle, pricePair, lastBlockTime);
+                }
+            }
+        }
+        return true;
+    });
+    return prices;
 }
 
 namespace {
@@ -961,25 +996,18 @@ namespace {
         }
 
         UniValue result(UniValue::VARR);
-        std::set<CTokenCurrencyPair> setTokenCurrency;
-        view.ForEachOracle([&](const COracleId &, COracle oracle) {
-            const auto &pairs = oracle.availablePairs;
-            setTokenCurrency.insert(pairs.begin(), pairs.end());
-            return true;
-        });
+        const auto prices = GetAggregatePrices(view, lastBlockTime);
 
-        if (start >= setTokenCurrency.size()) {
+        if (start >= prices.size()) {
             throw JSONRPCError(RPC_MISC_ERROR, "start index greater than number of prices available");
         }
 
-        for (auto tokenCurrency :
-             std::set<CTokenCurrencyPair>(std::next(setTokenCurrency.begin(), start), setTokenCurrency.end())) {
+        for (auto it = std::next(prices.begin(), start); it != prices.end(); ++it) {
             UniValue item{UniValue::VOBJ};
-            const auto &token = tokenCurrency.first;
-            const auto &currency = tokenCurrency.second;
+            const auto &[token, currency] = it->first;
             item.pushKV(oraclefields::Token, token);
             item.pushKV(oraclefields::Currency, currency);
-            auto aggregatePrice = GetAggregatePrice(view, token, currency, lastBlockTime);
+            auto aggregatePrice = GetAggregatePrice(it->second, token, currency);
             if (aggregatePrice) {
                 item.pushKV(oraclefields::AggregatedPrice, ValueFromAmount(*aggregatePrice.val));
                 item.pushKV(oraclefields::ValidityFlag, oraclefields::FlagIsValid);
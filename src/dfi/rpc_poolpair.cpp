@@ -1,6 +1,7 @@
 #include <dfi/accountshistory.h>
 #include <dfi/govvariables/attributes.h>
 #include <dfi/mn_rpc.h>
+#include <dfi/parallelscan.h>
 #include <dfi/validation.h>
 #include <dfi/vaulthistory.h>
 
@@ -1382,30 +1383,55 @@ UniValue listpoolshares(const JSONRPCRequest &request) {
     PoolShareKey startKey{start, CScript{}};
     auto [view, accountView, vaultView] = GetSnapshots();
 
-    UniValue ret(UniValue::VOBJ);
-    view->ForEachPoolShare(
-        [&, &view = view](DCT_ID const &poolId, const CScript &provider, uint32_t) {
-            const CTokenAmount tokenAmount = view->GetBalance(provider, poolId);
-            if (tokenAmount.nValue) {
-                const auto poolPair = view->GetPoolPair(poolId);
-                if (poolPair) {
-                    if (isMineOnly) {
-                        if (IsMineCached(*pwallet, provider) == ISMINE_SPENDABLE) {
-                            ret.pushKVs(poolShareToJSON(poolId, provider, tokenAmount.nValue, *poolPair, verbose));
-                            limit--;
-                        }
-                    } else {
-                        ret.pushKVs(poolShareToJSON(poolId, provider, tokenAmount.nValue, *poolPair, verbose));
-                        limit--;
+    RPCResultWriter ret(request, UniValue::VOBJ);
+
+    // Shares are scanned in key ranges in parallel. A streamed reply is scanned serially,
+    // buffered ranges would hold all of it in memory.
+    const auto ranges =
+        view->SplitRange<CPoolPairView::ByShare>(startKey, ret.IsStreaming() ? 1 : ParallelScanRanges(limit));
+    const auto serial = ranges.size() == 1;
+    std::atomic<size_t> remaining{limit};
+    // A serial scan writes straight to the reply, ranges buffer up to what the reply still misses
+    const auto emit = [&](std::vector<UniValue> &shares, const UniValue &share) {
+        if (serial) {
+            // stop once the client is gone
+            return ret.pushKVs(share) && --limit != 0;
+        }
+        shares.push_back(share);
+        return shares.size() < remaining.load(std::memory_order_relaxed);
+    };
+    ParallelScan<std::vector<UniValue>>(
+        ranges.size(),
+        [&, &view = view](size_t i, std::vector<UniValue> &shares, const std::atomic_bool &stop) {
+            view->ForEachPoolShare(
+                [&](DCT_ID const &poolId, const CScript &provider, uint32_t) {
+                    if (stop || !ranges[i].Contains({poolId, provider})) {
+                        return false;
+                    }
+                    const CTokenAmount tokenAmount = view->GetBalance(provider, poolId);
+                    if (!tokenAmount.nValue) {
+                        return true;
+                    }
+                    const auto poolPair = view->GetPoolPair(poolId);
+                    if (!poolPair || (isMineOnly && IsMineCached(*pwallet, provider) != ISMINE_SPENDABLE)) {
+                        return true;
                     }
+                    return emit(shares, poolShareToJSON(poolId, provider, tokenAmount.nValue, *poolPair, verbose));
+                },
+                ranges[i].start);
+        },
+        [&](std::vector<UniValue> &shares) {
+            for (const auto &share : shares) {
+                // stop once the client is gone
+                if (!ret.pushKVs(share) || --limit == 0) {
+                    return false;
                 }
             }
+            remaining.store(limit, std::memory_order_relaxed);
+            return true;
+        });
 
-            return limit != 0;
-        },
-        startKey);
-
-    return GetRPCResultCache().Set(request, ret);
+    return GetRPCResultCache().Set(request, ret.get());
 }
 
 UniValue listloantokenliquidity(const JSONRPCRequest &request) {
@@ -1473,6 +1499,45 @@ UniValue listloantokenliquidity(const JSONRPCRequest &request) {
     return GetRPCResultCache().Set(request, ret);
 }
 
+UniValue getrewardconsolidationstats(const JSONRPCRequest &request) {
+    RPCHelpMan{
+        "getrewardconsolidationstats",
+        "\nReturns progress and throughput of the current or last pool reward consolidation.\n",
+        {},
+        RPCResult{"{\n"
+                  "  \"running\": true|false,     (boolean) Whether a consolidation is in progress\n"
+                  "  \"runs\": n,                 (numeric) Consolidations run since startup\n"
+                  "  \"height\": n,               (numeric) Block height of the consolidation\n"
+                  "  \"owners\": n,               (numeric) Owners to consolidate\n"
+                  "  \"completed\": n,            (numeric) Owners consolidated so far\n"
+                  "  \"shards\": n,               (numeric) Shards the owners were split into\n"
+                  "  \"starttime\": n,            (numeric) Start time in seconds since epoch\n"
+                  "  \"calculationtime\": n,      (numeric) Milliseconds spent calculating rewards\n"
+                  "  \"mergetime\": n,            (numeric) Milliseconds spent flushing the shards\n"
+                  "  \"ownerspersecond\": n       (numeric) Owners consolidated per second\n"
+                  "}\n"},
+        RPCExamples{HelpExampleCli("getrewardconsolidationstats", "") +
+                    HelpExampleRpc("getrewardconsolidationstats", "")},
+    }
+        .Check(request);
+
+    const auto stats = GetRewardConsolidationStats();
+    const auto elapsed = stats.running ? (GetTimeMillis() - stats.startTime) * 1000 : stats.calculationTime;
+
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("running", stats.running);
+    ret.pushKV("runs", stats.runs);
+    ret.pushKV("height", stats.height);
+    ret.pushKV("owners", stats.owners);
+    ret.pushKV("completed", stats.completed);
+    ret.pushKV("shards", stats.shards);
+    ret.pushKV("starttime", stats.startTime / 1000);
+    ret.pushKV("calculationtime", elapsed / 1000);
+    ret.pushKV("mergetime", stats.mergeTime / 1000);
+    ret.pushKV("ownerspersecond", elapsed > 0 ? stats.completed * 1000000 / elapsed : 0);
+    return ret;
+}
+
 static const CRPCCommand commands[] = {
   //  category        name                        actor (function)            params
   //  -------------   -----------------------     ---------------------       ----------
@@ -1487,6 +1552,7 @@ static const CRPCCommand commands[] = {
     {"poolpair", "listpoolshares",         &listpoolshares,         {"pagination", "verbose", "is_mine_only"}},
     {"poolpair", "testpoolswap",           &testpoolswap,           {"metadata", "path", "verbose"}          },
     {"poolpair", "listloantokenliquidity", &listloantokenliquidity, {}                                       },
+    {"poolpair", "getrewardconsolidationstats", &getrewardconsolidationstats, {}                             },
 };
 
 void RegisterPoolpairRPCCommands(CRPCTable &tableRPC) {
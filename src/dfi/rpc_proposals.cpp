@@ -970,7 +970,7 @@ UniValue listgovproposalvotes(const JSONRPCRequest &request) {
         throw JSONRPCError(RPC_INVALID_PARAMETER, "Incorrect cycle value");
     }
 
-    UniValue ret(UniValue::VARR);
+    RPCResultWriter ret(request, UniValue::VARR);
 
     std::map<std::string, VotingInfo> map;
 
@@ -1024,7 +1024,9 @@ UniValue listgovproposalvotes(const JSONRPCRequest &request) {
                                                       : CTxDestination(WitnessV0KeyHash(node->ownerAuthAddress));
                 if (::IsMineCached(*pwallet, GetScriptForDestination(ownerDest))) {
                     if (!aggregate) {
-                        ret.push_back(proposalVoteToJSON(propId, propCycle, id, vote, valid));
+                        if (!ret.push_back(proposalVoteToJSON(propId, propCycle, id, vote, valid))) {
+                            return false;
+                        }
                         limit--;
                     } else {
                         proposalVoteAccounting(vote, pId, map);
@@ -1051,7 +1053,9 @@ UniValue listgovproposalvotes(const JSONRPCRequest &request) {
                 }
 
                 if (!aggregate) {
-                    ret.push_back(proposalVoteToJSON(propId, propCycle, id, vote, valid));
+                    if (!ret.push_back(proposalVoteToJSON(propId, propCycle, id, vote, valid))) {
+                        return false;
+                    }
                     limit--;
                 } else {
                     proposalVoteAccounting(vote, pId, map);
@@ -1072,11 +1076,13 @@ UniValue listgovproposalvotes(const JSONRPCRequest &request) {
             stats.pushKV("neutral", entry.second.votesNeutral);
             stats.pushKV("no", entry.second.votesNo);
 
-            ret.push_back(stats);
+            if (!ret.push_back(stats)) {
+                break;
+            }
         }
     }
 
-    return ret;
+    return ret.get();
 }
 
 UniValue getgovproposal(const JSONRPCRequest &request) {
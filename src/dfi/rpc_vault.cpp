@@ -2,6 +2,7 @@
 #include <dfi/auctionhistory.h>
 #include <dfi/govvariables/attributes.h>
 #include <dfi/mn_rpc.h>
+#include <dfi/parallelscan.h>
 #include <dfi/vaulthistory.h>
 
 extern UniValue AmountsToJSON(const CCustomCSView &view,
@@ -615,12 +616,53 @@ UniValue listvaults(const JSONRPCRequest &request) {
         }
     }
 
-    UniValue valueArr{UniValue::VARR};
-
     auto [view, accountView, vaultView] = GetSnapshots();
 
+    RPCResultWriter valueArr(request, UniValue::VARR);
+
+    // Vault states need the vault assets at current prices, so vaults are read in batches
+    // that are evaluated in parallel and written in key order
+    std::vector<std::pair<CVaultId, CVaultData>> batch;
+    const auto evaluateBatch = [&, &view = view]() {
+        ParallelScan<std::optional<UniValue>>(
+            batch.size(),
+            [&](size_t i, std::optional<UniValue> &vaultObj, const std::atomic_bool &stop) {
+                if (stop) {
+                    return;
+                }
+                const auto &[vaultId, data] = batch[i];
+                CCustomCSView batchView(*view);
+                auto vaultState = GetVaultState(batchView, vaultId, data);
+                if (state != VaultState::Unknown && state != vaultState) {
+                    return;
+                }
+                if (!verbose) {
+                    vaultObj = UniValue{UniValue::VOBJ};
+                    vaultObj->pushKV("vaultId", vaultId.GetHex());
+                    vaultObj->pushKV("ownerAddress", ScriptToString(data.ownerAddress));
+                    vaultObj->pushKV("loanSchemeId", data.schemeId);
+                    vaultObj->pushKV("state", VaultStateToString(vaultState));
+                } else {
+                    vaultObj = VaultToJSON(batchView, vaultId, data);
+                }
+            },
+            [&](std::optional<UniValue> &vaultObj) {
+                if (!vaultObj) {
+                    return true;
+                }
+                // stop once the client is gone
+                if (!valueArr.push_back(*vaultObj)) {
+                    limit = 0;
+                    return false;
+                }
+                return --limit != 0;
+            });
+        batch.clear();
+    };
+    const auto batchSize = std::min(limit, ParallelScanRanges());
+
     view->ForEachVault(
-        [&, &view = view](const CVaultId &vaultId, const CVaultData &data) {
+        [&](const CVaultId &vaultId, const CVaultData &data) {
             if (!including_start) {
                 including_start = true;
                 return (true);
@@ -628,28 +670,21 @@ UniValue listvaults(const JSONRPCRequest &request) {
             if (!ownerAddress.empty() && ownerAddress != data.ownerAddress) {
                 return false;
             }
-            auto vaultState = GetVaultState(*view, vaultId, data);
-
-            if ((loanSchemeId.empty() || loanSchemeId == data.schemeId) &&
-                (state == VaultState::Unknown || state == vaultState)) {
-                UniValue vaultObj{UniValue::VOBJ};
-                if (!verbose) {
-                    vaultObj.pushKV("vaultId", vaultId.GetHex());
-                    vaultObj.pushKV("ownerAddress", ScriptToString(data.ownerAddress));
-                    vaultObj.pushKV("loanSchemeId", data.schemeId);
-                    vaultObj.pushKV("state", VaultStateToString(vaultState));
-                } else {
-                    vaultObj = VaultToJSON(*view, vaultId, data);
+            if (loanSchemeId.empty() || loanSchemeId == data.schemeId) {
+                batch.emplace_back(vaultId, data);
+                if (batch.size() >= batchSize) {
+                    evaluateBatch();
                 }
-                valueArr.push_back(vaultObj);
-                limit--;
             }
             return limit != 0;
         },
         start,
         ownerAddress);
+    if (limit != 0) {
+        evaluateBatch();
+    }
 
-    return GetRPCResultCache().Set(request, valueArr);
+    return GetRPCResultCache().Set(request, valueArr.get());
 }
 
 UniValue getvault(const JSONRPCRequest &request) {
@@ -1362,10 +1397,10 @@ UniValue listauctionhistory(const JSONRPCRequest &request) {
         filter = DecodeScriptTxId(account, {start.owner, start.vaultId});
     }
 
-    UniValue ret(UniValue::VARR);
-
     auto [view, accountView, vaultView] = GetSnapshots();
 
+    RPCResultWriter ret(request, UniValue::VARR);
+
     accountView->ForEachAuctionHistory(
         [&, &view = view](const AuctionHistoryKey &key, CLazySerialize<AuctionHistoryValue> valueLazy) -> bool {
             if (filter == 0 && start.owner != key.owner) {
@@ -1380,13 +1415,15 @@ UniValue listauctionhistory(const JSONRPCRequest &request) {
                 return true;
             }
 
-            ret.push_back(auctionhistoryToJSON(*view, key, valueLazy.get()));
+            if (!ret.push_back(auctionhistoryToJSON(*view, key, valueLazy.get()))) {
+                return false;
+            }
 
             return --limit != 0;
         },
         start);
 
-    return GetRPCResultCache().Set(request, ret);
+    return GetRPCResultCache().Set(request, ret.get());
 }
 
 UniValue vaultToJSON(const CCustomCSView &view,
@@ -2211,6 +2248,100 @@ UniValue logstoredinterests(const JSONRPCRequest &request) {
     return GetRPCResultCache().Set(request, ret);
 }
 
+UniValue checkinteresttally(const JSONRPCRequest &request) {
+    RPCHelpMan{
+        "checkinteresttally",
+        "Compares the per token interest tally against a full scan of all stored interests.\n",
+        {
+
+        },
+        RPCResult{"{\n"
+                  "  \"height\" : n,                           Height the interest is calculated at\n"
+                  "  \"match\" : true|false,                   Whether tally and scan agree for every token\n"
+                  "  \"tokens\" : [{\n"
+                  "    \"token\" : n,                          Token ID\n"
+                  "    \"tallyInterest\" : n.nnnnnnnn,         Total interest from the tally\n"
+                  "    \"scanInterest\" : n.nnnnnnnn,          Total interest from the scan\n"
+                  "    \"tallyInterestPerBlock\" : n.nnnnnnnn, Interest per block from the tally\n"
+                  "    \"scanInterestPerBlock\" : n.nnnnnnnn,  Interest per block from the scan\n"
+                  "    \"tallyNegativeVaults\" : n,            Indexed vaults with negative interest\n"
+                  "    \"scanNegativeVaults\" : n,             Scanned vaults with negative interest\n"
+                  "    \"match\" : true|false,                 Whether tally and scan agree\n"
+                  "  }]\n"
+                  "}\n"},
+        RPCExamples{HelpExampleCli("checkinteresttally", "") + HelpExampleRpc("checkinteresttally", "")},
+    }
+        .Check(request);
+
+    auto [view, accountView, vaultView] = GetSnapshots();
+    const auto height = view->GetLastHeight();
+
+    if (height < Params().GetConsensus().DF18FortCanningGreatWorldHeight || !view->IsLoanInterestTallyReady()) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Interest tally is not available at this height");
+    }
+
+    struct InterestTotals {
+        CInterestAmount interest;
+        CInterestAmount interestPerBlock;
+        uint64_t negativeVaults{};
+    };
+    std::map<DCT_ID, std::pair<InterestTotals, InterestTotals>> totals;
+
+    view->ForEachLoanInterestTally([&, &view = view](DCT_ID id, const CInterestRateV3 &tally) {
+        auto &tallied = totals[id].first;
+        tallied.interest = TotalInterestCalculation(tally, height);
+        tallied.interestPerBlock = tally.interestPerBlock;
+        view->ForEachNegativeInterestVault(
+            [&](const CVaultId &) {
+                ++tallied.negativeVaults;
+                return true;
+            },
+            id);
+        return true;
+    });
+
+    view->ForEachVaultInterestV3([&](const CVaultId &, DCT_ID id, const CInterestRateV3 &rate) {
+        auto &scanned = totals[id].second;
+        scanned.interest = InterestAddition(scanned.interest, TotalInterestCalculation(rate, height));
+        scanned.interestPerBlock = InterestAddition(scanned.interestPerBlock, rate.interestPerBlock);
+        if (rate.interestPerBlock.negative || rate.interestToHeight.negative) {
+            ++scanned.negativeVaults;
+        }
+        return true;
+    });
+
+    const auto isEqual = [](const CInterestAmount &a, const CInterestAmount &b) {
+        return a.negative == b.negative && a.amount == b.amount;
+    };
+
+    auto allMatch{true};
+    UniValue tokens(UniValue::VARR);
+    for (const auto &[id, pair] : totals) {
+        const auto &[tallied, scanned] = pair;
+        const auto match = isEqual(tallied.interest, scanned.interest) &&
+                           isEqual(tallied.interestPerBlock, scanned.interestPerBlock) &&
+                           tallied.negativeVaults == scanned.negativeVaults;
+        allMatch &= match;
+
+        UniValue item(UniValue::VOBJ);
+        item.pushKV("token", id.ToString());
+        item.pushKV("tallyInterest", GetInterestPerBlockHighPrecisionString(tallied.interest));
+        item.pushKV("scanInterest", GetInterestPerBlockHighPrecisionString(scanned.interest));
+        item.pushKV("tallyInterestPerBlock", GetInterestPerBlockHighPrecisionString(tallied.interestPerBlock));
+        item.pushKV("scanInterestPerBlock", GetInterestPerBlockHighPrecisionString(scanned.interestPerBlock));
+        item.pushKV("tallyNegativeVaults", tallied.negativeVaults);
+        item.pushKV("scanNegativeVaults", scanned.negativeVaults);
+        item.pushKV("match", match);
+        tokens.push_back(item);
+    }
+
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("height", height);
+    ret.pushKV("match", allMatch);
+    ret.pushKV("tokens", tokens);
+    return ret;
+}
+
 UniValue getloantokens(const JSONRPCRequest &request) {
     RPCHelpMan{
         "getloantokens",
@@ -2261,6 +2392,7 @@ static const CRPCCommand commands[] = {
     {"vault",  "estimatevault",      &estimatevault,      {"collateralAmounts", "loanAmounts"}       },
     {"hidden", "getstoredinterest",  &getstoredinterest,  {"vaultId", "token"}                       },
     {"hidden", "logstoredinterests", &logstoredinterests, {}                                         },
+    {"hidden", "checkinteresttally", &checkinteresttally, {}                                         },
     {"hidden", "getloantokens",      &getloantokens,      {"vaultId"}                                },
 };
 
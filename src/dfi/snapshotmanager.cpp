@@ -3,6 +3,30 @@
 #include <dfi/accountshistory.h>
 #include <dfi/masternodes.h>
 #include <dfi/vaulthistory.h>
+#include <memusage.h>
+#include <rpc/resultcache.h>
+
+static size_t FrozenMemoryUsage(const std::shared_ptr<const MapKV> &changed) {
+    if (!changed) {
+        return 0;
+    }
+    auto usage = memusage::DynamicUsage(*changed);
+    for (const auto &[key, value] : *changed) {
+        usage += memusage::DynamicUsage(key);
+        if (value) {
+            usage += memusage::DynamicUsage(*value);
+        }
+    }
+    return usage;
+}
+
+CBlockSnapshot::CBlockSnapshot(const leveldb::Snapshot *otherSnapshot,
+                               std::shared_ptr<const MapKV> otherChanged,
+                               const CBlockSnapshotKey &otherKey)
+    : snapshot(otherSnapshot),
+      changed(std::move(otherChanged)),
+      key(otherKey),
+      memoryUsage(FrozenMemoryUsage(changed)) {}
 
 template <typename T>
 static void CheckoutSnapshot(T &checkedOutMap, const CBlockSnapshot &snapshot) {
@@ -11,12 +35,17 @@ static void CheckoutSnapshot(T &checkedOutMap, const CBlockSnapshot &snapshot) {
     if (checkedOutMap.count(checkOutKey)) {
         ++checkedOutMap.at(checkOutKey).count;
     } else {
-        checkedOutMap[checkOutKey] = {dbSnapshot, 1};
+        checkedOutMap[checkOutKey] = {dbSnapshot, 1, snapshot.GetMemoryUsage()};
     }
 }
 
 SnapshotCollection GetSnapshots() {
-    return psnapshotManager->GetSnapshots();
+    // Taken before the checkout, so a block change in between is always noticed
+    auto &rpcCache = GetRPCResultCache();
+    const auto generation = rpcCache.GetGeneration();
+    auto snapshots = psnapshotManager->GetSnapshots();
+    rpcCache.TrackSnapshot(*std::get<0>(snapshots), generation);
+    return snapshots;
 }
 
 SnapshotCollection CSnapshotManager::GetSnapshots() {
@@ -116,7 +145,7 @@ static void SetCurrentSnapshot(T &db, U &currentSnapshot, SnapshotType type, con
 
         // Set current snapshot
         currentSnapshot = std::make_unique<CBlockSnapshot>(
-            snapshot, MapKV{}, CBlockSnapshotKey{type, block->nHeight, block->GetBlockHash()});
+            snapshot, nullptr, CBlockSnapshotKey{type, block->nHeight, block->GetBlockHash()});
     }
 }
 
@@ -149,7 +178,7 @@ void CSnapshotManager::SetBlockSnapshots(CFlushableStorageKV &viewStorge,
     ::SetCurrentSnapshot(vaultView, currentVaultSnapshot, SnapshotType::VAULT, block);
 }
 
-std::pair<MapKV, std::unique_ptr<CStorageLevelDB>> CSnapshotManager::GetGlobalViewSnapshot() {
+std::pair<std::shared_ptr<const MapKV>, std::unique_ptr<CStorageLevelDB>> CSnapshotManager::GetGlobalViewSnapshot() {
     // Get database snapshot and flushable storage changed map
     auto [changedMap, snapshot] = pcustomcsview->GetStorage().CreateSnapshotData();
 
@@ -176,7 +205,7 @@ std::unique_ptr<CCheckedOutSnapshot> CSnapshotManager::GetGlobalHistorySnapshot(
     auto globalSnapshot = std::make_unique<CCheckedOutSnapshot>(snapshot, key);
 
     // Set global as current snapshot
-    currentHistorySnapshot = std::make_unique<CBlockSnapshot>(globalSnapshot->GetLevelDBSnapshot(), MapKV{}, key);
+    currentHistorySnapshot = std::make_unique<CBlockSnapshot>(globalSnapshot->GetLevelDBSnapshot(), nullptr, key);
 
     // Track checked out snapshot
     ::CheckoutSnapshot(checkedOutHistoryMap, *currentHistorySnapshot);
@@ -194,7 +223,7 @@ std::unique_ptr<CCheckedOutSnapshot> CSnapshotManager::GetGlobalVaultSnapshot()
     auto globalSnapshot = std::make_unique<CCheckedOutSnapshot>(snapshot, key);
 
     // Set global as current snapshot
-    currentVaultSnapshot = std::make_unique<CBlockSnapshot>(globalSnapshot->GetLevelDBSnapshot(), MapKV{}, key);
+    currentVaultSnapshot = std::make_unique<CBlockSnapshot>(globalSnapshot->GetLevelDBSnapshot(), nullptr, key);
 
     // Track checked out snapshot
     ::CheckoutSnapshot(checkedOutVaultMap, *currentVaultSnapshot);
@@ -203,7 +232,7 @@ std::unique_ptr<CCheckedOutSnapshot> CSnapshotManager::GetGlobalVaultSnapshot()
     return globalSnapshot;
 }
 
-std::pair<MapKV, std::unique_ptr<CStorageLevelDB>> CSnapshotManager::CheckoutViewSnapshot() {
+std::pair<std::shared_ptr<const MapKV>, std::unique_ptr<CStorageLevelDB>> CSnapshotManager::CheckoutViewSnapshot() {
     // Create checked out snapshot
     auto snapshot =
         std::make_unique<CCheckedOutSnapshot>(currentViewSnapshot->GetLevelDBSnapshot(), currentViewSnapshot->GetKey());
@@ -261,4 +290,34 @@ void CSnapshotManager::ReturnSnapshot(const CBlockSnapshotKey &key) {
     ::DestructSnapshot(key, checkedOutVaultMap, currentVaultSnapshot, vaultDB);
 }
 
+SnapshotMemoryInfo CSnapshotManager::GetMemoryInfo() {
+    std::unique_lock lock(mtx);
+
+    SnapshotMemoryInfo info;
+    if (currentViewSnapshot) {
+        info.height = currentViewSnapshot->GetKey().height;
+    }
+
+    for (const auto &[type, checkedOutMap] : {std::make_pair(SnapshotType::VIEW, &checkedOutViewMap),
+                                              std::make_pair(SnapshotType::HISTORY, &checkedOutHistoryMap),
+                                              std::make_pair(SnapshotType::VAULT, &checkedOutVaultMap)}) {
+        auto &count = info.checkedOut[type];
+        for (const auto &[key, value] : *checkedOutMap) {
+            count += value.count;
+        }
+    }
+
+    // Layers are shared by all views checked out of the same block
+    for (const auto &[key, value] : checkedOutViewMap) {
+        ++info.layers;
+        info.memoryUsage += value.memoryUsage;
+    }
+    if (currentViewSnapshot && !checkedOutViewMap.count(currentViewSnapshot->GetKey())) {
+        ++info.layers;
+        info.memoryUsage += currentViewSnapshot->GetMemoryUsage();
+    }
+
+    return info;
+}
+
 std::unique_ptr<CSnapshotManager> psnapshotManager;
@@ -60,22 +60,27 @@ struct CBlockSnapshotKey {
 struct CBlockSnapshotValue {
     const leveldb::Snapshot *snapshot;
     int64_t count;
+    size_t memoryUsage;
 };
 
+// Snapshot of a block. View snapshots carry the changes pending on top of the database,
+// frozen and shared with every view checked out from it.
 class CBlockSnapshot {
     const leveldb::Snapshot *snapshot{};
-    MapKV changed;
+    std::shared_ptr<const MapKV> changed;
     CBlockSnapshotKey key;
+    size_t memoryUsage{};
 
 public:
-    CBlockSnapshot(const leveldb::Snapshot *otherSnapshot, const MapKV &otherChanged, const CBlockSnapshotKey &otherKey)
-        : snapshot(otherSnapshot),
-          changed(otherChanged),
-          key(otherKey) {}
+    CBlockSnapshot(const leveldb::Snapshot *otherSnapshot,
+                   std::shared_ptr<const MapKV> otherChanged,
+                   const CBlockSnapshotKey &otherKey);
 
     [[nodiscard]] const leveldb::Snapshot *GetLevelDBSnapshot() const { return snapshot; }
     [[nodiscard]] const CBlockSnapshotKey &GetKey() const { return key; }
-    [[nodiscard]] const MapKV &GetChanged() const { return changed; }
+    [[nodiscard]] const std::shared_ptr<const MapKV> &GetChanged() const { return changed; }
+    // Memory held by the frozen changes
+    [[nodiscard]] size_t GetMemoryUsage() const { return memoryUsage; }
 };
 
 class CCheckedOutSnapshot {
@@ -94,6 +99,16 @@ public:
     [[nodiscard]] const leveldb::Snapshot *GetLevelDBSnapshot() const { return snapshot; }
 };
 
+struct SnapshotMemoryInfo {
+    // Height of the current snapshot, -1 if there is none
+    int64_t height{-1};
+    // Snapshots checked out by type
+    std::map<SnapshotType, int64_t> checkedOut;
+    // Frozen change layers alive and the memory they hold
+    size_t layers{};
+    size_t memoryUsage{};
+};
+
 class CSnapshotManager {
     std::unique_ptr<CBlockSnapshot> currentViewSnapshot;
     std::unique_ptr<CBlockSnapshot> currentHistorySnapshot;
@@ -125,14 +140,15 @@ public:
                            const CBlockIndex *block,
                            const bool nearTip);
     void ReturnSnapshot(const CBlockSnapshotKey &key);
+    SnapshotMemoryInfo GetMemoryInfo();
 
 private:
     std::optional<SnapshotCollection> GetCurrentSnapshots();
     SnapshotCollection GetGlobalSnapshots();
-    std::pair<MapKV, std::unique_ptr<CStorageLevelDB>> CheckoutViewSnapshot();
+    std::pair<std::shared_ptr<const MapKV>, std::unique_ptr<CStorageLevelDB>> CheckoutViewSnapshot();
     std::unique_ptr<CCheckedOutSnapshot> CheckoutHistorySnapshot();
     std::unique_ptr<CCheckedOutSnapshot> CheckoutVaultSnapshot();
-    std::pair<MapKV, std::unique_ptr<CStorageLevelDB>> GetGlobalViewSnapshot();
+    std::pair<std::shared_ptr<const MapKV>, std::unique_ptr<CStorageLevelDB>> GetGlobalViewSnapshot();
     std::unique_ptr<CCheckedOutSnapshot> GetGlobalHistorySnapshot();
     std::unique_ptr<CCheckedOutSnapshot> GetGlobalVaultSnapshot();
 };
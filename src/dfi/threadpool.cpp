@@ -1,14 +1,176 @@
 #include <dfi/threadpool.h>
 
 #include <logging.h>
+#include <tinyformat.h>
 #include <util/system.h>
+#include <util/threadnames.h>
+
+#include <algorithm>
+
+static thread_local TaskPool *currentPool{nullptr};
+static thread_local size_t currentWorker{0};
 
 TaskPool::TaskPool(size_t size)
-    : pool{size},
-      size{size} {}
+    : size{size} {
+    workers.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    for (size_t i = 0; i < size; ++i) {
+        workers[i]->thread = std::thread([this, i] { WorkerLoop(i); });
+    }
+}
+
+TaskPool::~TaskPool() {
+    Shutdown();
+}
+
+TaskPool *TaskPool::Current() {
+    return currentPool;
+}
+
+void TaskPool::Post(Task task, TaskPriority priority) {
+    Push(std::move(task), priority, nullptr);
+}
+
+void TaskPool::Push(Task task, TaskPriority priority, TaskGroup *group) {
+    const auto prio = static_cast<size_t>(priority);
+    auto &queue = currentPool == this ? workers[currentWorker]->local[prio] : shared[prio];
+    if (group) {
+        // Keeps the group alive until its waiters are notified
+        group->AddTask();
+    }
+    {
+        std::unique_lock l{queue.m};
+        queue.tasks.push_back({std::move(task), group});
+    }
+    posted[prio].fetch_add(1, std::memory_order_relaxed);
+    pending.fetch_add(1, std::memory_order_release);
+    {
+        // Sleeping workers check pending under this lock, no wake up is lost
+        std::unique_lock l{cv_m};
+    }
+    cv.notify_one();
+    if (group) {
+        group->NotifyPosted();
+        group->RemoveTask();
+    }
+}
+
+bool TaskPool::Take(std::deque<QueuedTask> &tasks, bool back, const TaskGroup *group, Task &task) {
+    const auto matches = [group](const QueuedTask &queued) {
+        return !group || (queued.group && queued.group->IsWithin(*group));
+    };
+    if (back) {
+        const auto it = std::find_if(tasks.rbegin(), tasks.rend(), matches);
+        if (it == tasks.rend()) {
+            return false;
+        }
+        task = std::move(it->task);
+        tasks.erase(std::next(it).base());
+    } else {
+        const auto it = std::find_if(tasks.begin(), tasks.end(), matches);
+        if (it == tasks.end()) {
+            return false;
+        }
+        task = std::move(it->task);
+        tasks.erase(it);
+    }
+    return true;
+}
+
+bool TaskPool::PopLocal(size_t index, size_t priority, const TaskGroup *group, Task &task) {
+    auto &queue = workers[index]->local[priority];
+    std::unique_lock l{queue.m};
+    return Take(queue.tasks, true, group, task);
+}
+
+bool TaskPool::PopShared(size_t priority, const TaskGroup *group, Task &task) {
+    auto &queue = shared[priority];
+    std::unique_lock l{queue.m};
+    return Take(queue.tasks, false, group, task);
+}
+
+bool TaskPool::Steal(size_t thief, size_t priority, const TaskGroup *group, Task &task) {
+    for (size_t i = 1; i <= size; ++i) {
+        const auto victim = (thief + i) % size;
+        if (currentPool == this && victim == currentWorker) {
+            continue;
+        }
+        auto &queue = workers[victim]->local[priority];
+        // A waiter looking for its group's tasks can't skip a busy queue,
+        // it sleeps until the next post once nothing is found
+        std::unique_lock l{queue.m, std::defer_lock};
+        if (group) {
+            l.lock();
+        } else if (!l.try_lock()) {
+            continue;
+        }
+        if (!Take(queue.tasks, false, group, task)) {
+            continue;
+        }
+        stolen.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+bool TaskPool::RunPendingTask(const TaskGroup *group) {
+    if (pending.load(std::memory_order_acquire) <= 0) {
+        return false;
+    }
+    const auto isWorker = currentPool == this;
+    Task task;
+    for (size_t priority = 0; priority < TASK_PRIORITIES; ++priority) {
+        if ((isWorker && PopLocal(currentWorker, priority, group, task)) || PopShared(priority, group, task) ||
+            Steal(currentWorker, priority, group, task)) {
+            pending.fetch_sub(1, std::memory_order_acq_rel);
+            task();
+            completed[priority].fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskPool::WorkerLoop(size_t index) {
+    util::ThreadRename(strprintf("dftxworker.%d", index));
+    currentPool = this;
+    currentWorker = index;
+    while (true) {
+        if (RunPendingTask()) {
+            continue;
+        }
+        std::unique_lock l{cv_m};
+        cv.wait(l, [&] { return pending.load(std::memory_order_acquire) > 0 || stopping.load(); });
+        if (stopping.load() && pending.load(std::memory_order_acquire) <= 0) {
+            return;
+        }
+    }
+}
 
 void TaskPool::Shutdown() {
-    pool.wait();
+    {
+        std::unique_lock l{cv_m};
+        stopping.store(true);
+    }
+    cv.notify_all();
+    for (auto &worker : workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+TaskPoolMetrics TaskPool::GetMetrics() const {
+    TaskPoolMetrics metrics;
+    metrics.threads = size;
+    for (size_t i = 0; i < TASK_PRIORITIES; ++i) {
+        metrics.posted[i] = posted[i].load(std::memory_order_relaxed);
+        metrics.completed[i] = completed[i].load(std::memory_order_relaxed);
+    }
+    metrics.stolen = stolen.load(std::memory_order_relaxed);
+    return metrics;
 }
 
 void InitDfTxGlobalTaskPool() {
@@ -28,30 +190,68 @@ void ShutdownDfTxGlobalTaskPool() {
     }
     LogPrintf("DfTxTaskPool: Waiting for tasks\n");
     DfTxTaskPool->Shutdown();
-    LogPrintf("DfTxTaskPool: Shutdown\n");
+    const auto metrics = DfTxTaskPool->GetMetrics();
+    LogPrintf("DfTxTaskPool: Shutdown (consensus tasks: %d, rpc tasks: %d, stolen: %d)\n",
+              metrics.completed[static_cast<size_t>(TaskPriority::Consensus)],
+              metrics.completed[static_cast<size_t>(TaskPriority::RPC)],
+              metrics.stolen);
 }
 
 void TaskGroup::AddTask() {
+    if (parent) {
+        parent->AddTask();
+    }
     tasks.fetch_add(1, std::memory_order_release);
 }
 
 void TaskGroup::RemoveTask() {
-    if (tasks.fetch_sub(1, std::memory_order_acq_rel) == 1) {
-        cv.notify_all();
+    // Read before the last task is removed, the group may be gone right after
+    const auto parentGroup = parent;
+    {
+        // Last removal happens under the lock, so a waiter can't return
+        // and destroy the group while it's still being notified
+        std::unique_lock<std::mutex> l(cv_m);
+        if (tasks.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            cv.notify_all();
+        }
+    }
+    if (parentGroup) {
+        parentGroup->RemoveTask();
     }
 }
 
-void TaskGroup::WaitForCompletion(bool checkForPrematureCompletion) {
-    if (checkForPrematureCompletion && tasks.load() == 0) {
-        return;
+void TaskGroup::NotifyPosted() {
+    {
+        std::unique_lock<std::mutex> l(cv_m);
+        posted.fetch_add(1, std::memory_order_release);
+    }
+    cv.notify_all();
+    if (parent) {
+        parent->NotifyPosted();
+    }
+}
+
+void TaskGroup::WaitForCompletion() {
+    const auto pool = TaskPool::Current();
+    std::unique_lock<std::mutex> l(cv_m, std::defer_lock);
+    while (tasks.load() != 0) {
+        // Read before looking for tasks, a post after it ends the wait below
+        const auto seen = posted.load(std::memory_order_acquire);
+        if (pool && pool->RunPendingTask(this)) {
+            continue;
+        }
+        l.lock();
+        cv.wait(l, [&] { return tasks.load() == 0 || posted.load() != seen; });
+        l.unlock();
     }
-    std::unique_lock<std::mutex> l(cv_m);
-    cv.wait(l, [&] { return tasks.load() == 0; });
+    // Last task is removed under the lock, wait for it to be released
+    // before the group can be destroyed
+    l.lock();
 }
 
-void TaskGroup::EnsureCompletedOrCancelled(bool checkForPrematureCompletion) {
+void TaskGroup::EnsureCompletedOrCancelled() {
     MarkCancelled();
-    WaitForCompletion(checkForPrematureCompletion);
+    WaitForCompletion();
 }
 
 std::unique_ptr<TaskPool> DfTxTaskPool;
@@ -1,10 +1,15 @@
 #ifndef DEFI_DFI_THREADPOOL_H
 #define DEFI_DFI_THREADPOOL_H
 
-#include <sync.h>
+#include <array>
 #include <atomic>
-#include <boost/asio.hpp>
 #include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 static const int DEFAULT_DFTX_WORKERS = 0;
 static const int DEFAULT_ECC_PRECACHE_WORKERS = -1;
@@ -13,80 +18,159 @@ static const int DEFAULT_ECC_PRECACHE_WORKERS = -1;
 // doesn't have the primitives needed for working with many at the same time efficiently
 // So, for now, we use a queue based approach for the thread pool
 
-// Simple boost thread pool with N threads that's kept around for now
-// Additionally, later task pool can abstract task group entirely, by
-// forwarding the post args into Post method of a child group created
-// from the TaskPool
+enum class TaskPriority : uint8_t {
+    // Block validation and connection, always scheduled first
+    Consensus,
+    // RPC fan-outs, only picked up while there's no consensus work queued
+    RPC,
+};
+
+static constexpr size_t TASK_PRIORITIES = 2;
+
+struct TaskPoolMetrics {
+    size_t threads{};
+    std::array<uint64_t, TASK_PRIORITIES> posted{};
+    std::array<uint64_t, TASK_PRIORITIES> completed{};
+    uint64_t stolen{};
+};
 
+class TaskGroup;
+
+// Work stealing pool with N threads. Every worker owns a deque per priority,
+// tasks posted from a worker go to its own deque and are run LIFO by the owner,
+// idle workers steal them FIFO from the other end. Tasks posted from outside
+// the pool go to a shared queue per priority. Queues are locked only for a
+// push or pop, thieves skip a busy queue instead of waiting on it unless they
+// look for tasks of a group they wait on.
 class TaskPool {
 public:
+    using Task = std::function<void()>;
+
     explicit TaskPool(size_t size);
+    ~TaskPool();
+    TaskPool(const TaskPool &) = delete;
+
+    void Post(Task task, TaskPriority priority = TaskPriority::Consensus);
+
+    // Posts task counted in group. Task is skipped if the group or any of
+    // its parents is cancelled by the time it's picked up.
+    template <typename F>
+    void Post(TaskGroup &group, F &&func, TaskPriority priority = TaskPriority::Consensus);
+
+    // Runs a single queued task on the calling thread, highest priority first.
+    // With a group set only its tasks and those of its children are picked up.
+    // Returns false if there was nothing to run.
+    bool RunPendingTask(const TaskGroup *group = nullptr);
+
+    // Waits for all queued tasks and joins the workers
     void Shutdown();
     [[nodiscard]] size_t GetAvailableThreads() const { return size; }
-    boost::asio::thread_pool pool;
+    [[nodiscard]] TaskPoolMetrics GetMetrics() const;
+
+    // Pool the calling thread is a worker of, nullptr otherwise
+    static TaskPool *Current();
 
 private:
+    struct QueuedTask {
+        Task task;
+        TaskGroup *group{};
+    };
+
+    struct TaskQueue {
+        std::mutex m;
+        std::deque<QueuedTask> tasks;
+    };
+
+    struct Worker {
+        std::array<TaskQueue, TASK_PRIORITIES> local;
+        std::thread thread;
+    };
+
+    void Push(Task task, TaskPriority priority, TaskGroup *group);
+    void WorkerLoop(size_t index);
+    static bool Take(std::deque<QueuedTask> &tasks, bool back, const TaskGroup *group, Task &task);
+    bool PopLocal(size_t index, size_t priority, const TaskGroup *group, Task &task);
+    bool PopShared(size_t priority, const TaskGroup *group, Task &task);
+    bool Steal(size_t thief, size_t priority, const TaskGroup *group, Task &task);
+
     size_t size;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::array<TaskQueue, TASK_PRIORITIES> shared;
+
+    std::atomic<int64_t> pending{0};
+    std::atomic_bool stopping{false};
+    std::mutex cv_m;
+    std::condition_variable cv;
+
+    std::array<std::atomic<uint64_t>, TASK_PRIORITIES> posted{};
+    std::array<std::atomic<uint64_t>, TASK_PRIORITIES> completed{};
+    std::atomic<uint64_t> stolen{0};
 };
 
 void InitDfTxGlobalTaskPool();
 void ShutdownDfTxGlobalTaskPool();
 
+// Counts outstanding tasks. Groups can be nested, tasks of a child group are
+// counted in its parents as well and cancelling a parent cancels its children.
 class TaskGroup {
 public:
     void AddTask();
     void RemoveTask();
-    void WaitForCompletion(bool checkForPrematureCompletion = true);
+    // Worker threads run queued tasks of the group while waiting, so nested
+    // groups waited on from within the pool can't starve it. Unrelated tasks
+    // are left to the other workers.
+    void WaitForCompletion();
     void MarkCancelled() { is_cancelled.store(true); }
-    bool IsCancelled() { return is_cancelled.load(); }
-    void EnsureCompletedOrCancelled(bool checkForPrematureCompletion = true);
+    bool IsCancelled() { return is_cancelled.load() || (parent && parent->IsCancelled()); }
+    void EnsureCompletedOrCancelled();
     void SetLeak(bool val = true) { is_leaked.store(val); }
+    // Whether this is the group or one of its children
+    bool IsWithin(const TaskGroup &group) const {
+        for (auto g = this; g; g = g->parent) {
+            if (g == &group) {
+                return true;
+            }
+        }
+        return false;
+    }
 
-    TaskGroup() = default;
+    explicit TaskGroup(TaskGroup *parent = nullptr)
+        : parent(parent) {}
     TaskGroup(const TaskGroup &) = delete;
 
     ~TaskGroup() {
         if (!is_leaked.load()) {
-            EnsureCompletedOrCancelled(true);
+            EnsureCompletedOrCancelled();
         }
     }
 
 private:
+    friend class TaskPool;
+    // Wakes up waiters on the group and its parents to pick up a new task
+    void NotifyPosted();
+
+    TaskGroup *const parent;
     std::atomic<uint64_t> tasks{0};
+    std::atomic<uint64_t> posted{0};
     std::mutex cv_m;
     std::condition_variable cv;
     std::atomic_bool is_cancelled{false};
     std::atomic_bool is_leaked{false};
 };
 
-template <typename T>
-class BufferPool {
-public:
-    explicit BufferPool(size_t size) {
-        pool.reserve(size);
-        for (size_t i = 0; i < size; i++) {
-            pool.push_back(std::make_shared<T>());
-        }
-    }
-
-    std::shared_ptr<T> Acquire() {
-        std::unique_lock l{m};
-        auto res = pool.back();
-        pool.pop_back();
-        return res;
-    }
-
-    void Release(std::shared_ptr<T> res) {
-        std::unique_lock l{m};
-        pool.push_back(res);
-    }
-
-    std::vector<std::shared_ptr<T>> &GetBuffer() { return pool; }
-
-private:
-    AtomicMutex m{};
-    std::vector<std::shared_ptr<T>> pool;
-};
+template <typename F>
+void TaskPool::Post(TaskGroup &group, F &&func, TaskPriority priority) {
+    group.AddTask();
+    Push(
+        [&group, func = std::forward<F>(func)]() mutable {
+            if (!group.IsCancelled()) {
+                func();
+            }
+            group.RemoveTask();
+        },
+        priority,
+        &group);
+}
 
 extern std::unique_ptr<TaskPool> DfTxTaskPool;
 
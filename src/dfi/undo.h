@@ -5,10 +5,13 @@
 #ifndef DEFI_DFI_UNDO_H
 #define DEFI_DFI_UNDO_H
 
+#include <crypto/common.h>
 #include <flushablestorage.h>
 #include <serialize.h>
 #include <serialize_optional.h>
 #include <uint256.h>
+
+#include <algorithm>
 #include <cstdint>
 
 struct UndoKey {
@@ -51,11 +54,116 @@ struct CUndo {
         }
     }
 
-    ADD_SERIALIZE_METHODS;
+    // Compact records start with a marker that can't begin the map of the legacy
+    // format, its size would be above MAX_SIZE. Keys are stored as the length of the
+    // prefix shared with the previous key plus the remaining bytes, 8 byte values,
+    // amounts mostly, as a zigzag varint when shorter.
+    static constexpr uint8_t COMPACT_MARKER = 0xff;
 
-    template <typename Stream, typename Operation>
-    inline void SerializationOp(Stream &s, Operation ser_action) {
-        READWRITE(before);
+    enum ValueType : uint8_t {
+        Erased = 0,
+        Raw = 1,
+        Int64 = 2,
+    };
+
+    template <typename Stream>
+    void Serialize(Stream &s) const {
+        ser_writedata8(s, COMPACT_MARKER);
+        WriteCompactSize(s, before.size());
+
+        const TBytes *prevKey{};
+        for (const auto &[key, value] : before) {
+            size_t shared{};
+            if (prevKey) {
+                const auto end = std::min(key.size(), prevKey->size());
+                while (shared < end && key[shared] == (*prevKey)[shared]) {
+                    ++shared;
+                }
+            }
+            WriteVarInt<Stream, VarIntMode::DEFAULT, uint64_t>(s, shared);
+            WriteCompactSize(s, key.size() - shared);
+            s.write(reinterpret_cast<const char *>(key.data() + shared), key.size() - shared);
+            prevKey = &key;
+
+            if (!value) {
+                ser_writedata8(s, Erased);
+            } else if (const auto zigzag = ZigZag(*value);
+                       zigzag && GetSizeOfVarInt<VarIntMode::DEFAULT>(*zigzag) <= sizeof(int64_t)) {
+                ser_writedata8(s, Int64);
+                WriteVarInt<Stream, VarIntMode::DEFAULT, uint64_t>(s, *zigzag);
+            } else {
+                ser_writedata8(s, Raw);
+                ::Serialize(s, *value);
+            }
+        }
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream &s) {
+        before.clear();
+        const auto marker = ser_readdata8(s);
+        if (marker != COMPACT_MARKER) {
+            // Legacy record, marker is the first byte of the map size
+            uint64_t size = marker;
+            if (marker == 253) {
+                size = ser_readdata16(s);
+            } else if (marker == 254) {
+                size = ser_readdata32(s);
+            }
+            for (uint64_t i = 0; i < size; ++i) {
+                TBytes key;
+                std::optional<TBytes> value;
+                ::Unserialize(s, key);
+                ::Unserialize(s, value);
+                before.emplace_hint(before.end(), std::move(key), std::move(value));
+            }
+            return;
+        }
+
+        const auto size = ReadCompactSize(s);
+        TBytes key;
+        for (uint64_t i = 0; i < size; ++i) {
+            const auto shared = ReadVarInt<Stream, VarIntMode::DEFAULT, uint64_t>(s);
+            if (shared > key.size()) {
+                throw std::ios_base::failure("CUndo: shared key prefix out of range");
+            }
+            const auto suffix = ReadCompactSize(s);
+            key.resize(shared + suffix);
+            if (suffix) {
+                s.read(reinterpret_cast<char *>(key.data() + shared), suffix);
+            }
+
+            std::optional<TBytes> value;
+            switch (ser_readdata8(s)) {
+                case Erased:
+                    break;
+                case Raw:
+                    value.emplace();
+                    ::Unserialize(s, *value);
+                    break;
+                case Int64:
+                    value = UnZigZag(ReadVarInt<Stream, VarIntMode::DEFAULT, uint64_t>(s));
+                    break;
+                default:
+                    throw std::ios_base::failure("CUndo: unknown value type");
+            }
+            before.emplace_hint(before.end(), key, std::move(value));
+        }
+    }
+
+private:
+    static std::optional<uint64_t> ZigZag(const TBytes &value) {
+        if (value.size() != sizeof(int64_t)) {
+            return {};
+        }
+        const auto n = static_cast<int64_t>(ReadLE64(value.data()));
+        return (static_cast<uint64_t>(n) << 1) ^ static_cast<uint64_t>(n >> 63);
+    }
+
+    static TBytes UnZigZag(const uint64_t zigzag) {
+        TBytes value(sizeof(int64_t));
+        WriteLE64(value.data(), (zigzag >> 1) ^ (~(zigzag & 1) + 1));
+        return value;
     }
 };
 
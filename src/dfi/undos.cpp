@@ -19,6 +19,20 @@ Res CUndosView::DelUndo(const UndoKey &key) {
     return Res::Ok();
 }
 
+size_t CUndosView::PruneUndos(uint32_t height, size_t limit) {
+    std::vector<UndoKey> keys;
+    for (auto it = LowerBound<ByUndoKey>(UndoKey{}); it.Valid() && keys.size() < limit; it.Next()) {
+        if (it.Key().height >= height) {
+            break;
+        }
+        keys.push_back(it.Key());
+    }
+    for (const auto &key : keys) {
+        EraseBy<ByUndoKey>(key);
+    }
+    return keys.size();
+}
+
 std::optional<CUndo> CUndosView::GetUndo(const UndoKey &key) const {
     CUndo val;
     bool ok = ReadBy<ByUndoKey>(key, val);
@@ -16,6 +16,8 @@ public:
     std::optional<CUndo> GetUndo(const UndoKey &key) const;
     Res SetUndo(const UndoKey &key, const CUndo &undo);
     Res DelUndo(const UndoKey &key);
+    // Erases up to limit records below height, oldest first. Returns the number erased.
+    size_t PruneUndos(uint32_t height, size_t limit);
 
     // tags
     struct ByUndoKey {
@@ -23,7 +23,6 @@
 #include <validation.h>
 
 #include <consensus/params.h>
-#include <boost/asio.hpp>
 
 #define MILLI 0.001
 
@@ -230,6 +229,7 @@ static void ProcessRewardEvents(const CBlockIndex *pindex, CCustomCSView &cache,
             return Res::Ok();
         },
         pindex->nHeight);
+    cache.GetHistoryWriters().FlushPoolRewards();
 
     auto res = cache.SubCommunityBalance(CommunityAccountType::IncentiveFunding, distributed.first);
     if (!res.ok) {
@@ -526,6 +526,8 @@ static void ProcessOracleEvents(const CBlockIndex *pindex, CCustomCSView &cache,
     if (pindex->nHeight % blockInterval != 0) {
         return;
     }
+    // Oracles are not changed here, aggregate all feeds in one pass
+    const auto aggregatePrices = GetAggregatePrices(cache, pindex->nTime);
     cache.ForEachFixedIntervalPrice([&](const CTokenCurrencyPair &, CFixedIntervalPrice fixedIntervalPrice) {
         // Ensure that we update active and next regardless of state of things
         // And SetFixedIntervalPrice on each evaluation of this block.
@@ -549,7 +551,7 @@ static void ProcessOracleEvents(const CBlockIndex *pindex, CCustomCSView &cache,
         // Use -1 to indicate empty price
         fixedIntervalPrice.priceRecord[1] = -1;
         auto aggregatePrice = GetAggregatePrice(
-            cache, fixedIntervalPrice.priceFeedId.first, fixedIntervalPrice.priceFeedId.second, pindex->nTime);
+            aggregatePrices, fixedIntervalPrice.priceFeedId.first, fixedIntervalPrice.priceFeedId.second);
         if (aggregatePrice) {
             fixedIntervalPrice.priceRecord[1] = aggregatePrice;
         } else {
@@ -685,8 +687,6 @@ static void ProcessLoanEvents(const CBlockIndex *pindex, CCustomCSView &cache, c
     if (pindex->nHeight % consensus.blocksCollateralizationRatioCalculation() == 0) {
         bool useNextPrice = false, requireLivePrice = true;
 
-        auto &pool = DfTxTaskPool->pool;
-
         struct VaultWithCollateralInfo {
             CVaultId vaultId;
             CBalances collaterals;
@@ -703,25 +703,42 @@ static void ProcessLoanEvents(const CBlockIndex *pindex, CCustomCSView &cache, c
 
         TaskGroup g;
 
-        const auto markCompleted = [&g] { g.RemoveTask(); };
+        // Prices do not change while vaults are checked, every feed is validated once
+        CVaultPriceCache priceCache;
 
-        cache.ForEachVaultCollateral([&](const CVaultId &vaultId, const CBalances &collaterals) {
-            g.AddTask();
+        // Only vaults with loans can fall below the scheme ratio,
+        // the ones holding collateral alone are not checked at all.
+        cache.ForEachLoanTokenAmount([&](const CVaultId &vaultId, const CBalances &) {
+            auto collaterals = cache.GetVaultCollaterals(vaultId);
+            if (!collaterals) {
+                return true;
+            }
 
             CVaultId vaultIdCopy = vaultId;
-            CBalances collateralsCopy = collaterals;
-
-            boost::asio::post(
-                pool,
-                [vaultIdCopy, collateralsCopy, &cache, pindex, useNextPrice, requireLivePrice, &lv, &markCompleted] {
+            CBalances collateralsCopy = std::move(*collaterals);
+
+            DfTxTaskPool->Post(
+                g,
+                [vaultIdCopy,
+                 collateralsCopy,
+                 &cache,
+                 pindex,
+                 useNextPrice,
+                 requireLivePrice,
+                 &priceCache,
+                 &lv] {
                     auto vaultId = vaultIdCopy;
                     auto collaterals = collateralsCopy;
 
-                    auto vaultAssets = cache.GetVaultAssets(
-                        vaultId, collaterals, pindex->nHeight, pindex->nTime, useNextPrice, requireLivePrice);
+                    auto vaultAssets = cache.GetVaultAssets(vaultId,
+                                                            collaterals,
+                                                            pindex->nHeight,
+                                                            pindex->nTime,
+                                                            useNextPrice,
+                                                            requireLivePrice,
+                                                            &priceCache);
 
                     if (!vaultAssets) {
-                        markCompleted();
                         return;
                     }
 
@@ -733,15 +750,11 @@ static void ProcessLoanEvents(const CBlockIndex *pindex, CCustomCSView &cache, c
 
                     if (scheme->ratio <= vaultAssets.val->ratio()) {
                         // All good, within ratio, nothing more to do.
-                        markCompleted();
                         return;
                     }
 
-                    {
-                        std::unique_lock lock{lv.m};
-                        lv.vaults.push_back(VaultWithCollateralInfo{vaultId, collaterals, vaultAssets, *vault});
-                    }
-                    markCompleted();
+                    std::unique_lock lock{lv.m};
+                    lv.vaults.push_back(VaultWithCollateralInfo{vaultId, collaterals, vaultAssets, *vault});
                 });
             return true;
         });
@@ -1172,12 +1185,68 @@ static auto GetLoanTokensForFutures(CCustomCSView &cache, ATTRIBUTES attributes)
     return loanTokens;
 }
 
+CFuturesSettlementBatch::CFuturesSettlementBatch(CCustomCSView &cache, const CBlockIndex *pindex)
+    : cache(cache),
+      height(pindex->nHeight),
+      blockHash(pindex->GetBlockHash()),
+      writers(cache.GetHistoryWriters().GetHistoryView(),
+              cache.GetHistoryWriters().GetBurnView(),
+              cache.GetHistoryWriters().GetVaultView()) {}
+
+void CFuturesSettlementBatch::FlushEntry() {
+    if (txn) {
+        writers.Flush(height, blockHash, *txn, type, {});
+        writers.ClearState();
+    }
+}
+
+void CFuturesSettlementBatch::NewEntry(const CustomTxType entryType) {
+    FlushEntry();
+    txn = GetNextAccPosition();
+    type = static_cast<uint8_t>(entryType);
+}
+
+void CFuturesSettlementBatch::AddBalance(const CScript &owner, const CTokenAmount &amount) {
+    if (amount.nValue != 0) {
+        credits[owner][amount.nTokenId] += amount.nValue;
+        writers.AddBalance(owner, amount, {});
+    }
+}
+
+Res CFuturesSettlementBatch::SubBalance(const CScript &owner, const CTokenAmount &amount) {
+    auto res = cache.SubBalance(owner, amount);
+    if (res && amount.nValue != 0) {
+        writers.SubBalance(owner, amount, {});
+    }
+    return res;
+}
+
+void CFuturesSettlementBatch::AddMintedTokens(const DCT_ID &id, const CAmount amount) {
+    mintedTokens[id] += amount;
+}
+
+void CFuturesSettlementBatch::Apply() {
+    FlushEntry();
+    txn.reset();
+
+    for (const auto &[id, amount] : mintedTokens) {
+        cache.AddMintedTokens(id, amount);
+    }
+    for (const auto &[owner, amounts] : credits) {
+        for (const auto &[id, amount] : amounts) {
+            cache.AddBalance(owner, {id, amount});
+        }
+    }
+    mintedTokens.clear();
+    credits.clear();
+}
+
 static void ProcessFutures(const CBlockIndex *pindex, CCustomCSView &cache, const Consensus::Params &consensus) {
     if (pindex->nHeight < consensus.DF15FortCanningRoadHeight) {
         return;
     }
 
-    auto attributes = cache.GetAttributes();
+    auto attributes = cache.GetMutableAttributes();
 
     CDataStructureV0 activeKey{AttributeTypes::Param, ParamIDs::DFIP2203, DFIPKeys::Active};
     CDataStructureV0 blockKey{AttributeTypes::Param, ParamIDs::DFIP2203, DFIPKeys::BlockPeriod};
@@ -1237,53 +1306,66 @@ static void ProcessFutures(const CBlockIndex *pindex, CCustomCSView &cache, cons
     auto dUsdToTokenSwapsCounter = 0;
     auto tokenTodUsdSwapsCounter = 0;
 
+    // Token metadata does not change during settlement, resolve it once per token
+    std::map<DCT_ID, std::string> loanSymbols;
+    const auto getLoanSymbol = [&](const DCT_ID &id) -> const std::string & {
+        auto it = loanSymbols.find(id);
+        if (it == loanSymbols.end()) {
+            const auto loanToken = cache.GetLoanTokenByID(id);
+            assert(loanToken);
+            it = loanSymbols.emplace(id, loanToken->symbol).first;
+        }
+        return it->second;
+    };
+
+    std::optional<DCT_ID> dusdID;
+    const auto getDUSDID = [&]() {
+        if (!dusdID) {
+            const auto tokenDUSD = cache.GetToken("DUSD");
+            assert(tokenDUSD);
+            dusdID = tokenDUSD->first;
+        }
+        return *dusdID;
+    };
+
+    CFuturesSettlementBatch batch(cache, pindex);
+
     cache.ForEachFuturesUserValues(
         [&](const CFuturesUserKey &key, const CFuturesUserValue &futuresValues) {
-            CAccountsHistoryWriter view(cache,
-                                        pindex->nHeight,
-                                        GetNextAccPosition(),
-                                        pindex->GetBlockHash(),
-                                        uint8_t(CustomTxType::FutureSwapExecution));
+            batch.NewEntry(CustomTxType::FutureSwapExecution);
 
             deletionPending.insert(key);
 
-            const auto source = view.GetLoanTokenByID(futuresValues.source.nTokenId);
-            assert(source);
-
-            if (source->symbol == "DUSD") {
+            if (getLoanSymbol(futuresValues.source.nTokenId) == "DUSD") {
                 const DCT_ID destId{futuresValues.destination};
-                const auto destToken = view.GetLoanTokenByID(destId);
-                assert(destToken);
-                try {
-                    const auto &premiumPrice = futuresPrices.at(destId).premium;
-                    if (premiumPrice > 0) {
-                        const auto total = DivideAmounts(futuresValues.source.nValue, premiumPrice);
-                        view.AddMintedTokens(destId, total);
-                        CTokenAmount destination{destId, total};
-                        view.AddBalance(key.owner, destination);
-                        burned.Add(futuresValues.source);
-                        minted.Add(destination);
-                        dUsdToTokenSwapsCounter++;
-                        LogPrint(BCLog::FUTURESWAP,
-                                 "ProcessFutures (): Owner %s source %s destination %s\n",
-                                 key.owner.GetHex(),
-                                 futuresValues.source.ToString(),
-                                 destination.ToString());
-                    }
-                } catch (const std::out_of_range &) {
+                getLoanSymbol(destId);
+                const auto price = futuresPrices.find(destId);
+                if (price == futuresPrices.end()) {
                     unpaidContracts.emplace(key, futuresValues);
+                } else if (const auto &premiumPrice = price->second.premium; premiumPrice > 0) {
+                    const auto total = DivideAmounts(futuresValues.source.nValue, premiumPrice);
+                    batch.AddMintedTokens(destId, total);
+                    CTokenAmount destination{destId, total};
+                    batch.AddBalance(key.owner, destination);
+                    burned.Add(futuresValues.source);
+                    minted.Add(destination);
+                    dUsdToTokenSwapsCounter++;
+                    LogPrint(BCLog::FUTURESWAP,
+                             "ProcessFutures (): Owner %s source %s destination %s\n",
+                             key.owner.GetHex(),
+                             futuresValues.source.ToString(),
+                             destination.ToString());
                 }
-
             } else {
-                const auto tokenDUSD = view.GetToken("DUSD");
-                assert(tokenDUSD);
-
-                try {
-                    const auto &discountPrice = futuresPrices.at(futuresValues.source.nTokenId).discount;
-                    const auto total = MultiplyAmounts(futuresValues.source.nValue, discountPrice);
-                    view.AddMintedTokens(tokenDUSD->first, total);
-                    CTokenAmount destination{tokenDUSD->first, total};
-                    view.AddBalance(key.owner, destination);
+                const auto tokenDUSD = getDUSDID();
+                const auto price = futuresPrices.find(futuresValues.source.nTokenId);
+                if (price == futuresPrices.end()) {
+                    unpaidContracts.emplace(key, futuresValues);
+                } else {
+                    const auto total = MultiplyAmounts(futuresValues.source.nValue, price->second.discount);
+                    batch.AddMintedTokens(tokenDUSD, total);
+                    CTokenAmount destination{tokenDUSD, total};
+                    batch.AddBalance(key.owner, destination);
                     burned.Add(futuresValues.source);
                     minted.Add(destination);
                     tokenTodUsdSwapsCounter++;
@@ -1292,13 +1374,9 @@ static void ProcessFutures(const CBlockIndex *pindex, CCustomCSView &cache, cons
                              key.owner.GetHex(),
                              futuresValues.source.ToString(),
                              destination.ToString());
-                } catch (const std::out_of_range &) {
-                    unpaidContracts.emplace(key, futuresValues);
                 }
             }
 
-            view.Flush();
-
             return true;
         },
         {static_cast<uint32_t>(pindex->nHeight), {}, std::numeric_limits<uint32_t>::max()});
@@ -1314,27 +1392,19 @@ static void ProcessFutures(const CBlockIndex *pindex, CCustomCSView &cache, cons
 
     // Refund unpaid contracts
     for (const auto &[key, value] : unpaidContracts) {
-        CAccountsHistoryWriter subView(cache,
-                                       pindex->nHeight,
-                                       GetNextAccPosition(),
-                                       pindex->GetBlockHash(),
-                                       uint8_t(CustomTxType::FutureSwapRefund));
-        subView.SubBalance(*contractAddressValue, value.source);
-        subView.Flush();
-
-        CAccountsHistoryWriter addView(cache,
-                                       pindex->nHeight,
-                                       GetNextAccPosition(),
-                                       pindex->GetBlockHash(),
-                                       uint8_t(CustomTxType::FutureSwapRefund));
-        addView.AddBalance(key.owner, value.source);
-        addView.Flush();
+        batch.NewEntry(CustomTxType::FutureSwapRefund);
+        batch.SubBalance(*contractAddressValue, value.source);
+
+        batch.NewEntry(CustomTxType::FutureSwapRefund);
+        batch.AddBalance(key.owner, value.source);
 
         LogPrint(
             BCLog::FUTURESWAP, "%s: Refund Owner %s value %s\n", __func__, key.owner.GetHex(), value.source.ToString());
         balances.Sub(value.source);
     }
 
+    batch.Apply();
+
     for (const auto &key : deletionPending) {
         cache.EraseFuturesUserValues(key);
     }
@@ -1373,7 +1443,7 @@ static void ProcessGovEvents(const CBlockIndex *pindex,
             CCustomCSView govCache(cache);
             // Add to existing ATTRIBUTES instead of overwriting.
             if (var->GetName() == "ATTRIBUTES") {
-                auto govVar = cache.GetAttributes();
+                auto govVar = cache.GetMutableAttributes();
                 govVar->time = pindex->GetBlockTime();
                 govVar->evmTemplate = evmTemplate;
                 auto newVar = std::dynamic_pointer_cast<ATTRIBUTES>(var);
@@ -1526,6 +1596,17 @@ size_t RewardConsolidationWorkersCount() {
     return workersMax > 2 ? workersMax : 3;
 }
 
+static AtomicMutex cs_rewardConsolidationStats;
+static RewardConsolidationStats rewardConsolidationStats;
+static std::atomic<uint64_t> rewardConsolidationCompleted{0};
+
+RewardConsolidationStats GetRewardConsolidationStats() {
+    std::unique_lock lock{cs_rewardConsolidationStats};
+    auto stats = rewardConsolidationStats;
+    stats.completed = rewardConsolidationCompleted.load(std::memory_order_relaxed);
+    return stats;
+}
+
 // Note: Be careful with lambda captures and default args. GCC 11.2.0, appears the if the captures are
 // unused in the function directly, but inside the lambda, it completely disassociates them from the fn
 // possibly when the lambda is lifted up and with default args, ends up inling the default arg
@@ -1540,52 +1621,75 @@ void ConsolidateRewards(CCustomCSView &view,
                         int numWorkers) {
     int nWorkers = numWorkers < 1 ? RewardConsolidationWorkersCount() : numWorkers;
     auto rewardsTime = GetTimeMicros();
-    boost::asio::thread_pool workerPool(nWorkers);
-    boost::asio::thread_pool mergeWorker(1);
-    std::atomic<uint64_t> tasksCompleted{0};
     std::atomic<uint64_t> reportedTs{0};
 
-    for (auto &owner : owners) {
-        // See https://github.com/DeFiCh/ain/pull/1291
-        // https://github.com/DeFiCh/ain/pull/1291#issuecomment-1137638060
-        // Technically not fully synchronized, but avoid races
-        // due to the segregated areas of operation.
-        boost::asio::post(workerPool, [&, &account = owner]() {
-            if (interruptOnShutdown && ShutdownRequested()) {
-                return;
-            }
-            auto tempView = std::make_unique<CCustomCSView>(view);
-            tempView->CalculateOwnerRewards(account, height);
-
-            boost::asio::post(mergeWorker, [&, tempView = std::move(tempView)]() {
+    // Owners are split in key ranges, every shard is consolidated in its own view on top of
+    // the untouched base view. Base view is written only after all workers are done, then the
+    // shard views are flushed into it one after another in owner order, each flush splicing
+    // the changes of a shard into the base.
+    // Shards run on the shared DfTxTaskPool, workers count only sets how finely owners are split.
+    std::vector<CScript> sortedOwners(owners.begin(), owners.end());
+    std::sort(sortedOwners.begin(), sortedOwners.end());
+    const auto shardsCount = std::min<size_t>(sortedOwners.size(), nWorkers * 4);
+    std::vector<std::unique_ptr<CCustomCSView>> shards(shardsCount);
+
+    {
+        std::unique_lock lock{cs_rewardConsolidationStats};
+        auto &stats = rewardConsolidationStats;
+        stats = {true, height, sortedOwners.size(), 0, shardsCount, GetTimeMillis(), 0, 0, stats.runs + 1};
+        rewardConsolidationCompleted.store(0, std::memory_order_relaxed);
+    }
+
+    TaskGroup g;
+    for (size_t shard = 0; shard < shardsCount; ++shard) {
+        DfTxTaskPool->Post(g, [&, shard]() {
+            const auto first = sortedOwners.size() * shard / shardsCount;
+            const auto last = sortedOwners.size() * (shard + 1) / shardsCount;
+            auto shardView = std::make_unique<CCustomCSView>(view);
+            for (auto i = first; i < last; ++i) {
                 if (interruptOnShutdown && ShutdownRequested()) {
-                    return;
+                    break;
                 }
-                tempView->Flush();
+                shardView->CalculateOwnerRewards(sortedOwners[i], height);
 
-                // This entire block is already serialized with single merge worker.
-                // So, relaxed ordering is more than sufficient - don't even need
-                // atomics really.
-                auto itemsCompleted = tasksCompleted.fetch_add(1, std::memory_order::memory_order_relaxed);
+                auto itemsCompleted = rewardConsolidationCompleted.fetch_add(1, std::memory_order_relaxed) + 1;
                 const auto logTimeIntervalMillis = 3 * 1000;
                 if (GetTimeMillis() - reportedTs > logTimeIntervalMillis) {
                     LogPrintf("Reward consolidation: %.2f%% completed (%d/%d)\n",
-                              (itemsCompleted * 1.f / owners.size()) * 100.0,
+                              (itemsCompleted * 1.f / sortedOwners.size()) * 100.0,
                               itemsCompleted,
-                              owners.size());
-                    reportedTs.store(GetTimeMillis(), std::memory_order::memory_order_relaxed);
+                              sortedOwners.size());
+                    reportedTs.store(GetTimeMillis(), std::memory_order_relaxed);
                 }
-            });
+            }
+            shards[shard] = std::move(shardView);
         });
     }
-    workerPool.join();
-    mergeWorker.join();
+    g.WaitForCompletion();
 
-    auto itemsCompleted = tasksCompleted.load();
-    LogPrintf("Reward consolidation: 100%% completed (%d/%d, time: %dms)\n",
+    auto mergeTime = GetTimeMicros();
+    for (auto &shardView : shards) {
+        if (interruptOnShutdown && ShutdownRequested()) {
+            break;
+        }
+        if (shardView) {
+            shardView->Flush();
+        }
+    }
+
+    auto itemsCompleted = rewardConsolidationCompleted.load();
+    {
+        std::unique_lock lock{cs_rewardConsolidationStats};
+        auto &stats = rewardConsolidationStats;
+        stats.running = false;
+        stats.calculationTime = mergeTime - rewardsTime;
+        stats.mergeTime = GetTimeMicros() - mergeTime;
+    }
+    LogPrintf("Reward consolidation: 100%% completed (%d/%d, time: %dms, merge: %dms)\n",
               itemsCompleted,
               itemsCompleted,
-              MILLI * (GetTimeMicros() - rewardsTime));
+              MILLI * (GetTimeMicros() - rewardsTime),
+              MILLI * (GetTimeMicros() - mergeTime));
 }
 
 template <typename GovVar>
@@ -1728,13 +1832,11 @@ static Res PoolSplits(CCustomCSView &view,
             }
 
             std::vector<std::pair<CScript, CAmount>> balancesToMigrate;
-            // only needed for ConsolidateRewards, but kept here to ensure same behaviour as old code
-            uint64_t totalAccounts = 0;
-            view.ForEachBalance([&, oldPoolId = oldPoolId](const CScript &owner, CTokenAmount balance) {
-                if (oldPoolId.v == balance.nTokenId.v && balance.nValue > 0) {
+            // Holders come in owner order, same as the full balance scan did
+            view.ForEachTokenHolder(oldPoolId, [&](const CScript &owner, const CTokenAmount &balance) {
+                if (balance.nValue > 0) {
                     balancesToMigrate.emplace_back(owner, balance.nValue);
                 }
-                totalAccounts++;
                 return true;
             });
 
@@ -1752,9 +1854,8 @@ static Res PoolSplits(CCustomCSView &view,
                     ownersToConsolidate.emplace(owner);
                 }
                 auto nWorkers = RewardConsolidationWorkersCount();
-                LogPrintf("Pool migration: Consolidating rewards (count: %d, total: %d, concurrency: %d)..\n",
+                LogPrintf("Pool migration: Consolidating rewards (count: %d, concurrency: %d)..\n",
                           ownersToConsolidate.size(),
-                          totalAccounts,
                           nWorkers);
                 ConsolidateRewards(view, pindex->nHeight, ownersToConsolidate, false, nWorkers);
             }
@@ -2482,23 +2583,21 @@ static void ExecuteTokenSplits(const CBlockIndex *pindex,
 
         std::map<CScript, std::pair<CTokenAmount, CTokenAmount>> balanceUpdates;
 
-        view.ForEachBalance([&, multiplier = multiplier](const CScript &owner, const CTokenAmount &balance) {
-            if (oldTokenId.v == balance.nTokenId.v) {
-                const auto newBalance = CalculateNewAmount(multiplier, balance.nValue);
-                balanceUpdates.emplace(owner,
-                                       std::pair<CTokenAmount, CTokenAmount>{
-                                           {newTokenId, newBalance},
-                                           balance
-                });
-                totalBalance += newBalance;
+        view.ForEachTokenHolder(oldTokenId, [&, multiplier = multiplier](const CScript &owner, const CTokenAmount &balance) {
+            const auto newBalance = CalculateNewAmount(multiplier, balance.nValue);
+            balanceUpdates.emplace(owner,
+                                   std::pair<CTokenAmount, CTokenAmount>{
+                                       {newTokenId, newBalance},
+                                       balance
+            });
+            totalBalance += newBalance;
 
-                auto newBalanceStr = CTokenAmount{newTokenId, newBalance}.ToString();
-                LogPrint(BCLog::TOKENSPLIT,
-                         "TokenSplit: T (%s: %s => %s)\n",
-                         ScriptToString(owner),
-                         balance.ToString(),
-                         newBalanceStr);
-            }
+            auto newBalanceStr = CTokenAmount{newTokenId, newBalance}.ToString();
+            LogPrint(BCLog::TOKENSPLIT,
+                     "TokenSplit: T (%s: %s => %s)\n",
+                     ScriptToString(owner),
+                     balance.ToString(),
+                     newBalanceStr);
             return true;
         });
 
@@ -2640,7 +2739,7 @@ static Res PaybackLoanWithTokenOrDUSDCollateral(
 
     const auto height = blockCtx.GetHeight();
     const auto &consensus = blockCtx.GetConsensus();
-    auto attributes = mnview.GetAttributes();
+    auto attributes = mnview.GetMutableAttributes();
 
     if (!IsVaultPriceValid(mnview, vaultId, height)) {
         return DeFiErrors::LoanAssetPriceInvalid();
@@ -3585,7 +3684,7 @@ static Res ConvertAllLoanTokenForTokenLock(const CBlock &block,
         }
     }
 
-    auto attributes = cache.GetAttributes();
+    auto attributes = cache.GetMutableAttributes();
     // get tokens with matched with creationTx
     // get list of pools, matched with creationTx
 
@@ -3639,12 +3738,14 @@ static Res ConvertAllLoanTokenForTokenLock(const CBlock &block,
 
     // need to consolidate all before token split, otherwise commission might not be converted
     std::unordered_set<CScript, CScriptHasher> poolOwnersToMigrate;
-    cache.ForEachBalance([&](const CScript &owner, CTokenAmount balance) {
-        if (poolsForConsolidation.count(balance.nTokenId) > 0 && balance.nValue > 0) {
-            poolOwnersToMigrate.emplace(owner);
-        }
-        return true;
-    });
+    for (const auto &poolId : poolsForConsolidation) {
+        cache.ForEachTokenHolder(poolId, [&](const CScript &owner, const CTokenAmount &balance) {
+            if (balance.nValue > 0) {
+                poolOwnersToMigrate.emplace(owner);
+            }
+            return true;
+        });
+    }
     auto nWorkers = RewardConsolidationWorkersCount();
     LogPrintf(
         "Token Lock: Consolidating rewards. total: %d, concurrency: %d..\n", poolOwnersToMigrate.size(), nWorkers);
@@ -3752,20 +3853,32 @@ static Res LockTokensOfBalancesCollAndPools(const CBlock &block,
     LogPrintf("locking %.2f%% of loan tokens in balances and pools\n", lockRatio * 100.0 / COIN);
     const auto contractAddressValue = blockCtx.GetConsensus().smartContracts.at(SMART_CONTRACT_TOKENLOCK);
     auto res = Res::Ok();
-    std::vector<std::pair<CScript, DCT_ID>> ownersWithTokens;
-    cache.ForEachBalance([&](const CScript &owner, const CTokenAmount &amount) {
-        if (owner == blockCtx.GetConsensus().burnAddress || owner == contractAddressValue) {
-            return true;  // no lock from burn or lock address
-        }
+    // Locks are applied in balance key order, pool rounding depends on it
+    std::vector<std::pair<TBytes, std::pair<CScript, DCT_ID>>> holders;
+    std::set<uint32_t> tokensToScan(tokensToBeLocked.begin(), tokensToBeLocked.end());
+    tokensToScan.insert(affectedPools.begin(), affectedPools.end());
+    for (const auto id : tokensToScan) {
+        const auto entries = tokensToBeLocked.count(id) + affectedPools.count(id);
+        cache.ForEachTokenHolder(DCT_ID{id}, [&](const CScript &owner, const CTokenAmount &amount) {
+            if (owner == blockCtx.GetConsensus().burnAddress || owner == contractAddressValue) {
+                return true;  // no lock from burn or lock address
+            }
+            if (amount.nValue > 0) {
+                auto key = DbTypeToBytes(BalanceKey{owner, amount.nTokenId});
+                for (size_t i = 0; i < entries; ++i) {
+                    holders.emplace_back(key, std::make_pair(owner, amount.nTokenId));
+                }
+            }
+            return true;
+        });
+    }
+    std::stable_sort(holders.begin(), holders.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
 
-        if (tokensToBeLocked.count(amount.nTokenId.v) && amount.nValue > 0) {
-            ownersWithTokens.emplace_back(owner, amount.nTokenId);
-        }
-        if (affectedPools.count(amount.nTokenId.v) && amount.nValue > 0) {
-            ownersWithTokens.emplace_back(owner, amount.nTokenId);
-        }
-        return true;
-    });
+    std::vector<std::pair<CScript, DCT_ID>> ownersWithTokens;
+    ownersWithTokens.reserve(holders.size());
+    for (auto &[key, entry] : holders) {
+        ownersWithTokens.push_back(std::move(entry));
+    }
 
     uint64_t reportedTs = 0;
     uint64_t done = 0;
@@ -3917,7 +4030,7 @@ static Res LockTokensOfBalancesCollAndPools(const CBlock &block,
     addView.Flush();
 
     CDataStructureV0 releaseKey{AttributeTypes::Live, ParamIDs::Economy, EconomyKeys::TokenLockRatio};
-    auto attributes = cache.GetAttributes();
+    auto attributes = cache.GetMutableAttributes();
     attributes->SetValue(releaseKey, lockRatio);
     cache.SetVariable(*attributes);
     cache.Flush();
@@ -3935,7 +4048,7 @@ static void ProcessTokenLock(const CBlock &block,
         return;
     }
 
-    const auto attributes = cache.GetAttributes();
+    const auto attributes = cache.GetMutableAttributes();
     CDataStructureV0 lockedTokenKey{AttributeTypes::Live, ParamIDs::Economy, EconomyKeys::LockedTokens};
     const auto lockedTokens = attributes->GetValue(lockedTokenKey, CBalances{});
     if (!lockedTokens.balances.empty()) {
@@ -4000,7 +4113,7 @@ static void ProcessTokenSplits(const CBlockIndex *pindex,
     if (pindex->nHeight < consensus.DF16FortCanningCrunchHeight) {
         return;
     }
-    const auto attributes = cache.GetAttributes();
+    const auto attributes = cache.GetMutableAttributes();
 
     CDataStructureV0 splitKey{AttributeTypes::Oracles, OracleIDs::Splits, static_cast<uint32_t>(pindex->nHeight)};
     bool splitSuccess = true;
@@ -4021,7 +4134,7 @@ static void ProcessFuturesDUSD(const CBlockIndex *pindex, CCustomCSView &cache,
         return;
     }
 
-    auto attributes = cache.GetAttributes();
+    auto attributes = cache.GetMutableAttributes();
 
     CDataStructureV0 activeKey{AttributeTypes::Param, ParamIDs::DFIP2206F, DFIPKeys::Active};
     CDataStructureV0 blockKey{AttributeTypes::Param, ParamIDs::DFIP2206F, DFIPKeys::BlockPeriod};
@@ -4069,32 +4182,26 @@ static void ProcessFuturesDUSD(const CBlockIndex *pindex, CCustomCSView &cache,
             },
             {static_cast<uint32_t>(pindex->nHeight), {}, std::numeric_limits<uint32_t>::max()});
 
+        CFuturesSettlementBatch batch(cache, pindex);
+
         for (const auto &[key, amount] : refunds) {
             cache.EraseFuturesDUSD(key);
 
             const CTokenAmount source{dfiID, amount};
 
-            CAccountsHistoryWriter subView(cache,
-                                           pindex->nHeight,
-                                           GetNextAccPosition(),
-                                           pindex->GetBlockHash(),
-                                           uint8_t(CustomTxType::FutureSwapRefund));
-            subView.SubBalance(*contractAddressValue, source);
-            subView.Flush();
-
-            CAccountsHistoryWriter addView(cache,
-                                           pindex->nHeight,
-                                           GetNextAccPosition(),
-                                           pindex->GetBlockHash(),
-                                           uint8_t(CustomTxType::FutureSwapRefund));
-            addView.AddBalance(key.owner, source);
-            addView.Flush();
+            batch.NewEntry(CustomTxType::FutureSwapRefund);
+            batch.SubBalance(*contractAddressValue, source);
+
+            batch.NewEntry(CustomTxType::FutureSwapRefund);
+            batch.AddBalance(key.owner, source);
 
             LogPrint(
                 BCLog::FUTURESWAP, "%s: Refund Owner %s value %s\n", __func__, key.owner.GetHex(), source.ToString());
             balances.Sub(source);
         }
 
+        batch.Apply();
+
         if (!refunds.empty()) {
             attributes->SetValue(liveKey, std::move(balances));
         }
@@ -4119,23 +4226,26 @@ static void ProcessFuturesDUSD(const CBlockIndex *pindex, CCustomCSView &cache,
 
     auto swapCounter{0};
 
+    std::optional<DCT_ID> dusdID;
+
+    CFuturesSettlementBatch batch(cache, pindex);
+
     cache.ForEachFuturesDUSD(
         [&](const CFuturesUserKey &key, const CAmount &amount) {
-            CAccountsHistoryWriter view(cache,
-                                        pindex->nHeight,
-                                        GetNextAccPosition(),
-                                        pindex->GetBlockHash(),
-                                        uint8_t(CustomTxType::FutureSwapExecution));
+            batch.NewEntry(CustomTxType::FutureSwapExecution);
 
             deletionPending.insert(key);
 
-            const auto tokenDUSD = view.GetToken("DUSD");
-            assert(tokenDUSD);
+            if (!dusdID) {
+                const auto tokenDUSD = cache.GetToken("DUSD");
+                assert(tokenDUSD);
+                dusdID = tokenDUSD->first;
+            }
 
             const auto total = MultiplyAmounts(amount, discountPrice);
-            view.AddMintedTokens(tokenDUSD->first, total);
-            CTokenAmount destination{tokenDUSD->first, total};
-            view.AddBalance(key.owner, destination);
+            batch.AddMintedTokens(*dusdID, total);
+            CTokenAmount destination{*dusdID, total};
+            batch.AddBalance(key.owner, destination);
             burned.Add({dfiID, amount});
             minted.Add(destination);
             ++swapCounter;
@@ -4145,12 +4255,12 @@ static void ProcessFuturesDUSD(const CBlockIndex *pindex, CCustomCSView &cache,
                      amount,
                      destination.ToString());
 
-            view.Flush();
-
             return true;
         },
         {static_cast<uint32_t>(pindex->nHeight), {}, std::numeric_limits<uint32_t>::max()});
 
+    batch.Apply();
+
     for (const auto &key : deletionPending) {
         cache.EraseFuturesDUSD(key);
     }
@@ -4171,7 +4281,7 @@ static void ProcessNegativeInterest(const CBlockIndex *pindex, CCustomCSView &ca
         return;
     }
 
-    auto attributes = cache.GetAttributes();
+    auto attributes = cache.GetMutableAttributes();
 
     DCT_ID dusd{};
     const auto token = cache.GetTokenGuessId("DUSD", dusd);
@@ -4183,23 +4293,38 @@ static void ProcessNegativeInterest(const CBlockIndex *pindex, CCustomCSView &ca
     auto negativeInterestBalances = attributes->GetValue(negativeInterestKey, CBalances{});
     negativeInterestKey.key = EconomyKeys::NegativeIntCurrent;
 
-    cache.ForEachLoanTokenAmount([&](const CVaultId &vaultId, const CBalances &balances) {
-        for (const auto &[tokenId, amount] : balances.balances) {
-            if (tokenId == dusd) {
-                const auto rate = cache.GetInterestRate(vaultId, tokenId, pindex->nHeight);
-                if (!rate) {
-                    continue;
-                }
+    const auto addNegativeInterest = [&](const CVaultId &vaultId, const CAmount amount) {
+        const auto rate = cache.GetInterestRate(vaultId, dusd, pindex->nHeight);
+        if (!rate) {
+            return;
+        }
 
-                const auto totalInterest = TotalInterest(*rate, pindex->nHeight);
-                if (totalInterest < 0) {
-                    negativeInterestBalances.Add(
-                        {tokenId, amount > std::abs(totalInterest) ? std::abs(totalInterest) : amount});
+        const auto totalInterest = TotalInterest(*rate, pindex->nHeight);
+        if (totalInterest < 0) {
+            negativeInterestBalances.Add({dusd, amount > std::abs(totalInterest) ? std::abs(totalInterest) : amount});
+        }
+    };
+
+    if (cache.IsLoanInterestTallyReady()) {
+        // Only vaults with a negative interest component can contribute
+        cache.ForEachNegativeInterestVault(
+            [&](const CVaultId &vaultId) {
+                if (const auto balances = cache.GetLoanTokens(vaultId)) {
+                    if (const auto it = balances->balances.find(dusd); it != balances->balances.end()) {
+                        addNegativeInterest(vaultId, it->second);
+                    }
                 }
+                return true;
+            },
+            dusd);
+    } else {
+        cache.ForEachLoanTokenAmount([&](const CVaultId &vaultId, const CBalances &balances) {
+            if (const auto it = balances.balances.find(dusd); it != balances.balances.end()) {
+                addNegativeInterest(vaultId, it->second);
             }
-        }
-        return true;
-    });
+            return true;
+        });
+    }
 
     if (!negativeInterestBalances.balances.empty()) {
         attributes->SetValue(negativeInterestKey, negativeInterestBalances);
@@ -4207,11 +4332,55 @@ static void ProcessNegativeInterest(const CBlockIndex *pindex, CCustomCSView &ca
     }
 }
 
+static void ProcessLoanInterestTally(const CBlockIndex *pindex,
+                                     CCustomCSView &cache,
+                                     const Consensus::Params &consensus) {
+    if (pindex->nHeight < consensus.DF18FortCanningGreatWorldHeight || cache.IsLoanInterestTallyReady()) {
+        return;
+    }
+
+    auto time = GetTimeMillis();
+    cache.BuildLoanInterestTally();
+    LogPrintf("Loan interest tally built (height: %d, time: %dms)\n", pindex->nHeight, GetTimeMillis() - time);
+}
+
+// Masternode state changes are only read from the start of a live vote tally on
+static void PruneMasternodeStateChanges(const CBlockIndex *pindex, CCustomCSView &cache) {
+    std::optional<uint32_t> oldestChange;
+    cache.ForEachMasternodeStateChange(
+        [&](uint32_t height, const uint256 &) {
+            oldestChange = height;
+            return false;
+        },
+        0);
+    if (!oldestChange) {
+        return;
+    }
+
+    auto pruneHeight = static_cast<uint32_t>(pindex->nHeight);
+    cache.ForEachProposal(
+        [&](const CProposalId &propId, const CProposalObject &prop) {
+            if (prop.status != CProposalStatusType::Voting) {
+                return false;
+            }
+            if (const auto tally = cache.GetProposalVoteTally(propId, prop.cycle)) {
+                pruneHeight = std::min(pruneHeight, tally->startHeight);
+            }
+            return true;
+        },
+        CProposalStatusType::Voting);
+    if (*oldestChange < pruneHeight) {
+        cache.EraseMasternodeStateChanges(pruneHeight);
+    }
+}
+
 static void ProcessProposalEvents(const CBlockIndex *pindex, CCustomCSView &cache, const Consensus::Params &consensus) {
     if (pindex->nHeight < consensus.DF20GrandCentralHeight) {
         return;
     }
 
+    PruneMasternodeStateChanges(pindex, cache);
+
     CDataStructureV0 enabledKey{AttributeTypes::Param, ParamIDs::Feature, DFIPKeys::GovernanceEnabled};
 
     auto attributes = cache.GetAttributes();
@@ -4232,49 +4401,92 @@ static void ProcessProposalEvents(const CBlockIndex *pindex, CCustomCSView &cach
         cache.AddCommunityBalance(CommunityAccountType::CommunityDevFunds, balance.nValue);
     }
 
-    std::set<uint256> activeMasternodes;
+    const auto isActiveMinter = [&](const CMasternode &node) {
+        return node.IsActive(pindex->nHeight, cache) && node.mintedBlocks;
+    };
+    const auto isActiveVoter = [&](const uint256 &mnId) {
+        const auto node = cache.GetMasternode(mnId);
+        return node && isActiveMinter(*node);
+    };
+
+    // Counted once per block, only when a cycle ends
+    std::optional<uint32_t> activeMasternodes;
     cache.ForEachCycleProposal(
         [&](const CProposalId &propId, const CProposalObject &prop) {
             if (prop.status != CProposalStatusType::Voting) {
                 return true;
             }
 
-            if (activeMasternodes.empty()) {
-                cache.ForEachMasternode([&](const uint256 &mnId, CMasternode node) {
-                    if (node.IsActive(pindex->nHeight, cache) && node.mintedBlocks) {
-                        activeMasternodes.insert(mnId);
+            if (!activeMasternodes) {
+                activeMasternodes = 0;
+                cache.ForEachMasternode([&](const uint256 &, CMasternode node) {
+                    if (isActiveMinter(node)) {
+                        ++*activeMasternodes;
                     }
                     return true;
                 });
-                if (activeMasternodes.empty()) {
-                    return false;
-                }
+            }
+            if (!*activeMasternodes) {
+                return false;
             }
 
-            uint32_t voteYes = 0, voteNeutral = 0;
+            // Active voters in vote order
             std::set<uint256> voters{};
-            cache.ForEachProposalVote(
-                [&](const CProposalId &pId, uint8_t cycle, const uint256 &mnId, CProposalVoteType vote) {
-                    if (pId != propId || cycle != prop.cycle) {
-                        return false;
-                    }
-                    if (activeMasternodes.count(mnId)) {
-                        voters.insert(mnId);
-                        if (vote == CProposalVoteType::VoteYes) {
-                            ++voteYes;
-                        } else if (vote == CProposalVoteType::VoteNeutral) {
-                            ++voteNeutral;
+            const auto forEachVoter = [&](const std::function<void(const uint256 &, CProposalVoteType)> &callback) {
+                cache.ForEachProposalVote(
+                    [&](const CProposalId &pId, uint8_t cycle, const uint256 &mnId, CProposalVoteType vote) {
+                        if (pId != propId || cycle != prop.cycle) {
+                            return false;
+                        }
+                        if (isActiveVoter(mnId)) {
+                            callback(mnId, vote);
+                        }
+                        return true;
+                    },
+                    CMnVotePerCycle{propId, prop.cycle});
+            };
+
+            uint32_t voteYes = 0, voteNeutral = 0, voteCount = 0;
+            if (auto tally = cache.GetProposalVoteTally(propId, prop.cycle)) {
+                // Voters were active when voting, only a resign or update may have deactivated them since
+                std::set<uint256> changed;
+                cache.ForEachMasternodeStateChange(
+                    [&](uint32_t, const uint256 &mnId) {
+                        if (!changed.insert(mnId).second) {
+                            return true;
+                        }
+                        if (const auto vote = cache.GetProposalVote(propId, prop.cycle, mnId)) {
+                            if (!isActiveVoter(mnId)) {
+                                tally->Add(*vote, -1);
+                            }
                         }
+                        return true;
+                    },
+                    tally->startHeight);
+                voteYes = tally->yes;
+                voteNeutral = tally->neutral;
+                voteCount = tally->Total();
+            } else {
+                forEachVoter([&](const uint256 &mnId, CProposalVoteType vote) {
+                    voters.insert(mnId);
+                    if (vote == CProposalVoteType::VoteYes) {
+                        ++voteYes;
+                    } else if (vote == CProposalVoteType::VoteNeutral) {
+                        ++voteNeutral;
                     }
-                    return true;
-                },
-                CMnVotePerCycle{propId, prop.cycle});
+                });
+                voteCount = voters.size();
+            }
 
             // Redistributes fee among voting masternodes
             CDataStructureV0 feeRedistributionKey{
                 AttributeTypes::Governance, GovernanceIDs::Proposals, GovernanceKeys::FeeRedistribution};
 
-            if (voters.size() > 0 && attributes->GetValue(feeRedistributionKey, false)) {
+            if (voteCount > 0 && attributes->GetValue(feeRedistributionKey, false)) {
+                if (voters.empty()) {
+                    forEachVoter([&](const uint256 &mnId, CProposalVoteType) { voters.insert(mnId); });
+                }
+
                 // return half fee among voting masternodes, the rest is burned at creation
                 auto feeBack = prop.fee - prop.feeBurnAmount;
                 auto amountPerVoter = DivideAmounts(feeBack, voters.size() * COIN);
@@ -4322,19 +4534,19 @@ static void ProcessProposalEvents(const CBlockIndex *pindex, CCustomCSView &cach
                 }
             }
 
-            if (lround(voters.size() * 10000.f / activeMasternodes.size()) <= prop.quorum) {
+            if (lround(voteCount * 10000.f / *activeMasternodes) <= prop.quorum) {
                 cache.UpdateProposalStatus(propId, pindex->nHeight, CProposalStatusType::Rejected);
                 return true;
             }
 
             if (pindex->nHeight < consensus.DF22MetachainHeight &&
-                lround(voteYes * 10000.f / voters.size()) <= prop.approvalThreshold) {
+                lround(voteYes * 10000.f / voteCount) <= prop.approvalThreshold) {
                 cache.UpdateProposalStatus(propId, pindex->nHeight, CProposalStatusType::Rejected);
                 return true;
             } else if (pindex->nHeight >= consensus.DF22MetachainHeight) {
-                auto onlyNeutral = voters.size() == voteNeutral;
+                auto onlyNeutral = voteCount == voteNeutral;
                 if (onlyNeutral ||
-                    lround(voteYes * 10000.f / (voters.size() - voteNeutral)) <= prop.approvalThreshold) {
+                    lround(voteYes * 10000.f / (voteCount - voteNeutral)) <= prop.approvalThreshold) {
                     cache.UpdateProposalStatus(propId, pindex->nHeight, CProposalStatusType::Rejected);
                     return true;
                 }
@@ -4407,7 +4619,7 @@ static void ProcessGrandCentralEvents(const CBlockIndex *pindex,
         return;
     }
 
-    auto attributes = cache.GetAttributes();
+    auto attributes = cache.GetMutableAttributes();
 
     CDataStructureV0 key{AttributeTypes::Param, ParamIDs::Foundation, DFIPKeys::Members};
     attributes->SetValue(key, consensus.foundationMembers);
@@ -4531,7 +4743,7 @@ static Res ProcessEVMQueue(const CBlock &block,
         return res;
     }
 
-    auto attributes = cache.GetAttributes();
+    auto attributes = cache.GetMutableAttributes();
 
     auto stats = attributes->GetValue(CEvmBlockStatsLive::Key, CEvmBlockStatsLive{});
 
@@ -4617,6 +4829,9 @@ Res ProcessDeFiEventFallible(const CBlock &block,
         }
     }
 
+    // Record rewards settled by the events above
+    cache.GetHistoryWriters().FlushPoolRewards();
+
     // Construct undo
     FlushCacheCreateUndo(pindex, mnview, cache, uint256S(std::string(64, '1')));
 
@@ -4633,6 +4848,9 @@ void ProcessDeFiEvent(const CBlock &block,
     auto &mnview = blockCtx.GetView();
     CCustomCSView cache(mnview);
 
+    // One time build of the per token interest tally, upgrades existing chains as well
+    ProcessLoanInterestTally(pindex, cache, consensus);
+
     // calculate rewards to current block
     ProcessRewardEvents(pindex, cache, consensus);
 
@@ -4685,6 +4903,9 @@ void ProcessDeFiEvent(const CBlock &block,
     // Refund null pool swap amounts
     ProcessNullPoolSwapRefund(pindex, cache, consensus);
 
+    // Record rewards settled by all events, not only the reward events
+    cache.GetHistoryWriters().FlushPoolRewards();
+
     // construct undo
     FlushCacheCreateUndo(pindex, mnview, cache, uint256());
 }
@@ -4708,7 +4929,7 @@ bool ExecuteTokenMigrationEVM(std::size_t mnview_ptr, const TokenAmount oldAmoun
 
     CDataStructureV0 lockedKey{AttributeTypes::Live, ParamIDs::Economy, EconomyKeys::LockedTokens};
     CDataStructureV0 releaseKey{AttributeTypes::Live, ParamIDs::Economy, EconomyKeys::TokenLockRatio};
-    auto attributes = cache->GetAttributes();
+    auto attributes = cache->GetMutableAttributes();
     const auto lockRatio = attributes->GetValue(releaseKey, CAmount{});
     const auto lockedTokens = attributes->GetValue(lockedKey, CBalances{});
     if (lockRatio > 0 && lockedTokens.balances.count(DCT_ID{oldAmount.id}) > 0) {
@@ -6,6 +6,10 @@
 #define DEFI_DFI_VALIDATION_H
 
 #include <amount.h>
+#include <dfi/customtx.h>
+#include <dfi/historywriter.h>
+
+#include <optional>
 
 struct CAuctionBatch;
 class CBlock;
@@ -21,6 +25,49 @@ constexpr CAmount DEFAULT_FS_LIQUIDITY_BLOCK_PERIOD = 28 * 2880;
 constexpr CAmount DEFAULT_LIQUIDITY_CALC_SAMPLING_PERIOD = 120;
 constexpr CAmount DEFAULT_AVERAGE_LIQUIDITY_PERCENTAGE = COIN / 10;
 
+struct RewardConsolidationStats {
+    bool running{};
+    int height{};
+    uint64_t owners{};
+    uint64_t completed{};
+    uint64_t shards{};
+    int64_t startTime{};  // millis
+    int64_t calculationTime{};  // micros
+    int64_t mergeTime{};  // micros
+    uint64_t runs{};
+};
+
+RewardConsolidationStats GetRewardConsolidationStats();
+
+// Collects the balance changes of a futures settlement and applies them to the
+// block cache in one pass. Every contract still gets its own history entry and
+// account position, matching what a per-contract CAccountsHistoryWriter records.
+// Debits are applied to the cache as they come, so one that can't be covered
+// fails on its own like it did in its own view.
+class CFuturesSettlementBatch {
+    CCustomCSView &cache;
+    const uint32_t height;
+    const uint256 blockHash;
+    CHistoryWriters writers;
+
+    std::optional<uint32_t> txn;
+    uint8_t type{};
+
+    std::map<CScript, TAmounts> credits;
+    TAmounts mintedTokens;
+
+    void FlushEntry();
+
+public:
+    CFuturesSettlementBatch(CCustomCSView &cache, const CBlockIndex *pindex);
+
+    void NewEntry(const CustomTxType entryType);
+    void AddBalance(const CScript &owner, const CTokenAmount &amount);
+    Res SubBalance(const CScript &owner, const CTokenAmount &amount);
+    void AddMintedTokens(const DCT_ID &id, const CAmount amount);
+    void Apply();
+};
+
 using CreationTxs = std::map<uint32_t, std::pair<uint256, std::vector<std::pair<DCT_ID, uint256>>>>;
 
 void ProcessDeFiEvent(const CBlock &block,
@@ -60,4 +60,8 @@ inline rust::slice<const uint8_t> ffi_from_string_to_slice(const std::string &st
     return rust::slice<const uint8_t>(reinterpret_cast<const uint8_t *>(str.c_str()), str.size());
 }
 
+inline rust::slice<const uint8_t> ffi_from_bytes_to_slice(const std::vector<uint8_t> &bytes) {
+    return rust::slice<const uint8_t>(bytes.data(), bytes.size());
+}
+
 #endif  // DEFI_FFI_FFIHELPERS_H
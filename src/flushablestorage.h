@@ -14,11 +14,15 @@
 #include <map>
 #include <memusage.h>
 
+#include <mutex>
 #include <optional>
+#include <set>
 
 extern CCriticalSection cs_main;
 
 using TBytes = std::vector<unsigned char>;
+// Bytes borrowed from a key, a value or a storage iterator
+using TBytesSpan = Span<const unsigned char>;
 using MapKV = std::map<TBytes, std::optional<TBytes>>;
 
 template<typename T>
@@ -30,9 +34,9 @@ static TBytes DbTypeToBytes(const T& value) {
 }
 
 template<typename T>
-static bool BytesToDbType(const TBytes& bytes, T& value) {
+static bool BytesToDbType(TBytesSpan bytes, T& value) {
     try {
-        VectorReader stream(SER_DISK, CLIENT_VERSION, bytes, 0);
+        SpanReader stream(SER_DISK, CLIENT_VERSION, bytes);
         stream >> value;
 //        assert(stream.size() == 0); // will fail with partial key matching
     }
@@ -42,7 +46,13 @@ static bool BytesToDbType(const TBytes& bytes, T& value) {
     return true;
 }
 
-// Key-Value storage iterator interface
+template<typename T>
+static bool BytesToDbType(const TBytes& bytes, T& value) {
+    return BytesToDbType(MakeSpan(bytes), value);
+}
+
+// Key-Value storage iterator interface. Keys and values are borrowed from
+// the iterator and only valid until it is moved or destroyed.
 class CStorageKVIterator {
 public:
     virtual ~CStorageKVIterator() = default;
@@ -50,8 +60,8 @@ public:
     virtual void Next() = 0;
     virtual void Prev() = 0;
     virtual bool Valid() = 0;
-    virtual TBytes Key() = 0;
-    virtual TBytes Value() = 0;
+    virtual TBytesSpan Key() = 0;
+    virtual TBytesSpan Value() = 0;
 };
 
 // Represents an empty iterator
@@ -62,8 +72,8 @@ public:
     void Next() override {}
     void Prev() override {}
     bool Valid() override { return false; }
-    TBytes Key() override { return {}; }
-    TBytes Value() override { return {}; }
+    TBytesSpan Key() override { return {}; }
+    TBytesSpan Value() override { return {}; }
 };
 
 // Key-Value storage interface
@@ -72,13 +82,123 @@ public:
     virtual ~CStorageKV() = default;
     virtual bool Exists(const TBytes& key) const = 0;
     virtual bool Write(const TBytes& key, const TBytes& value) = 0;
+    // Storages that buffer writes can take ownership of the serialized pair instead of copying it
+    virtual bool Write(TBytes&& key, TBytes&& value) {
+        return Write(static_cast<const TBytes&>(key), static_cast<const TBytes&>(value));
+    }
     virtual bool Erase(const TBytes& key) = 0;
     virtual bool Read(const TBytes& key, TBytes& value) const = 0;
     virtual std::unique_ptr<CStorageKVIterator> NewIterator() = 0;
     virtual size_t SizeEstimate() const = 0;
     virtual bool Flush() = 0;
+    // Approximate bytes taken by the keys in [begin, end), an empty end has no bound. 0 if unknown
+    virtual uint64_t ApproximateSize(const TBytes& begin, const TBytes& end) const { return 0; }
 };
 
+// Smallest key past all the keys starting with prefix, empty if there is none
+inline TBytes PrefixEnd(TBytes prefix) {
+    while (!prefix.empty() && prefix.back() == 0xff) {
+        prefix.pop_back();
+    }
+    if (!prefix.empty()) {
+        ++prefix.back();
+    }
+    return prefix;
+}
+
+// Bytes taken by the entries of map in [begin, end), an empty end has no bound
+inline uint64_t MapKVSize(const MapKV& map, const TBytes& begin, const TBytes& end) {
+    uint64_t size{};
+    for (auto it = map.lower_bound(begin); it != map.end() && (end.empty() || it->first < end); ++it) {
+        size += it->first.size() + (it->second ? it->second->size() : 0);
+    }
+    return size;
+}
+
+// Splits the keys from begin to the end of prefix into at most count ranges of
+// similar size and returns the first key of every range but the first one.
+// Key space is divided on the bytes following prefix, parts holding more than
+// their share are divided further. Without size estimates every non empty part
+// of the first division weighs the same.
+inline std::vector<TBytes> SplitKeyRange(CStorageKV& storage, const TBytes& begin, const TBytes& prefix, size_t count) {
+    static constexpr size_t MAX_SPLIT_DEPTH = 3;
+
+    // Keys starting with key, from start on
+    struct Part {
+        TBytes key;
+        TBytes start;
+        TBytes end;
+        uint64_t size;
+    };
+    const auto divide = [&](const TBytes& parent, std::vector<Part>& parts) {
+        for (size_t byte = 0; byte <= 0xff; ++byte) {
+            auto key = parent;
+            key.push_back(static_cast<unsigned char>(byte));
+            auto end = PrefixEnd(key);
+            if (!end.empty() && end <= begin) {
+                continue;
+            }
+            auto start = key < begin ? begin : key;
+            const auto size = storage.ApproximateSize(start, end);
+            parts.push_back({std::move(key), std::move(start), std::move(end), size});
+        }
+    };
+
+    std::vector<Part> parts;
+    if (count < 2) {
+        return {};
+    }
+    divide(prefix, parts);
+
+    uint64_t total{};
+    for (const auto& part : parts) {
+        total += part.size;
+    }
+    if (total == 0) {
+        auto it = storage.NewIterator();
+        for (auto& part : parts) {
+            it->Seek(part.start);
+            part.size = it->Valid() && (part.end.empty() || it->Key() < MakeSpan(part.end));
+            total += part.size;
+        }
+    } else {
+        for (size_t depth = 1; depth < MAX_SPLIT_DEPTH; ++depth) {
+            std::vector<Part> divided;
+            bool changed{};
+            for (auto& part : parts) {
+                if (part.size <= total / count || part.key.size() != prefix.size() + depth) {
+                    divided.push_back(std::move(part));
+                    continue;
+                }
+                divide(part.key, divided);
+                changed = true;
+            }
+            parts = std::move(divided);
+            if (!changed) {
+                break;
+            }
+            total = 0;
+            for (const auto& part : parts) {
+                total += part.size;
+            }
+        }
+    }
+
+    std::vector<TBytes> bounds;
+    uint64_t taken{};
+    for (auto& part : parts) {
+        if (part.size == 0) {
+            continue;
+        }
+        // every range but the first one starts where the share of the previous ones is used up
+        if (taken > 0 && taken >= (bounds.size() + 1) * total / count && bounds.size() + 1 < count) {
+            bounds.push_back(std::move(part.start));
+        }
+        taken += part.size;
+    }
+    return bounds;
+}
+
 // doesn't serialize/deserialize vector size
 template<typename T>
 struct RawTBytes {
@@ -103,15 +223,18 @@ inline RawTBytes<T> refTBytes(T& val) {
     return RawTBytes<T>{val};
 }
 
-// LevelDB glue layer Iterator
+// LevelDB glue layer Iterator, keys and values point into LevelDB's own buffers
 class CStorageLevelDBIterator : public CStorageKVIterator {
 public:
-    explicit CStorageLevelDBIterator(std::unique_ptr<CDBIterator>&& it) : it{std::move(it)} { }
+    explicit CStorageLevelDBIterator(std::unique_ptr<CDBIterator>&& it) : it{std::move(it)} {
+        const auto& key = this->it->GetObfuscateKey();
+        obfuscated = std::any_of(key.begin(), key.end(), [](unsigned char byte) { return byte != 0; });
+    }
     CStorageLevelDBIterator(const CStorageLevelDBIterator&) = delete;
     ~CStorageLevelDBIterator() override = default;
 
     void Seek(const TBytes& key) override {
-        it->Seek(refTBytes(key)); // lower_bound in fact
+        it->SeekRaw(MakeSpan(key)); // lower_bound in fact
     }
     void Next() override {
         it->Next();
@@ -122,18 +245,26 @@ public:
     bool Valid() override {
         return it->Valid();
     }
-    TBytes Key() override {
-        TBytes key;
-        auto rawKey = refTBytes(key);
-        return it->GetKey(rawKey) ? key : TBytes{};
+    TBytesSpan Key() override {
+        return it->GetKeyRaw();
     }
-    TBytes Value() override {
-        TBytes value;
-        auto rawValue = refTBytes(value);
-        return it->GetValue(rawValue) ? value : TBytes{};
+    TBytesSpan Value() override {
+        if (!obfuscated) {
+            return it->GetValueRaw();
+        }
+        // values of an obfuscated database have to be copied to be deobfuscated
+        const auto raw = it->GetValueRaw();
+        const auto& key = it->GetObfuscateKey();
+        value.assign(raw.begin(), raw.end());
+        for (size_t i = 0; i < value.size(); ++i) {
+            value[i] ^= key[i % key.size()];
+        }
+        return MakeSpan(value);
     }
 private:
     std::unique_ptr<CDBIterator> it;
+    bool obfuscated;
+    TBytes value;
 };
 
 // LevelDB glue layer storage
@@ -151,6 +282,8 @@ public:
 
     ~CStorageLevelDB() override = default;
 
+    using CStorageKV::Write;
+
     bool Exists(const TBytes& key) const override {
         if (snapshot) {
             return db->Exists(refTBytes(key), options);
@@ -186,6 +319,11 @@ public:
         if (snapshot) return 0;
         return batch.SizeEstimate();
     }
+    uint64_t ApproximateSize(const TBytes& begin, const TBytes& end) const override {
+        // Estimates come from the table files, so pending writes and snapshots are not accounted for
+        static const TBytes lastKey(16, 0xff);
+        return db->EstimateSize(refTBytes(begin), refTBytes(end.empty() ? lastKey : end));
+    }
     std::unique_ptr<CStorageKVIterator> NewIterator() override {
         if (snapshot) {
             return std::make_unique<CStorageLevelDBIterator>(std::unique_ptr<CDBIterator>(db->NewIterator(options)));
@@ -223,10 +361,33 @@ private:
 
 // Flushable storage
 
+// Keys and key ranges read from the layers below a storage, what its
+// content depends on. Ranges are the [first, last] keys an iterator was
+// positioned at, no last key means the iterator ran off the end.
+struct CStorageReadSet {
+    std::set<TBytes> keys;
+    std::vector<std::pair<TBytes, std::optional<TBytes>>> ranges;
+
+    bool Intersects(const std::set<TBytes>& changed) const {
+        for (const auto& key : keys) {
+            if (changed.count(key)) {
+                return true;
+            }
+        }
+        for (const auto& [first, last] : ranges) {
+            auto it = changed.lower_bound(first);
+            if (it != changed.end() && (!last || *it <= *last)) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
 // Flushable Key-Value Storage Iterator
 class CFlushableStorageKVIterator : public CStorageKVIterator {
 public:
-    explicit CFlushableStorageKVIterator(std::unique_ptr<CStorageKVIterator>&& pIt, MapKV& map) : map(map), pIt(std::move(pIt)) {
+    explicit CFlushableStorageKVIterator(std::unique_ptr<CStorageKVIterator>&& pIt, const MapKV& map, CStorageReadSet* readSet = nullptr, std::mutex* readSetMutex = nullptr) : map(map), pIt(std::move(pIt)), readSet(readSet), readSetMutex(readSetMutex) {
         itState = Invalid;
     }
     CFlushableStorageKVIterator(const CFlushableStorageKVIterator&) = delete;
@@ -234,11 +395,27 @@ public:
 
     void Seek(const TBytes& key) override {
         pIt->Seek(key);
-        mIt = Advance(map.lower_bound(key), map.end(), std::greater<TBytes>{}, {});
+        mIt = Advance(map.lower_bound(key), map.end(), std::greater<TBytesSpan>{}, {});
+        if (readSet) {
+            {
+                std::lock_guard lock{*readSetMutex};
+                range = readSet->ranges.size();
+                readSet->ranges.emplace_back(key, key);
+            }
+            TrackRange(false);
+        }
     }
     void Next() override {
         assert(Valid());
-        mIt = Advance(mIt, map.end(), std::greater<TBytes>{}, Key());
+        if (itState == Map) {
+            mIt = Advance(mIt, map.end(), std::greater<TBytesSpan>{}, MakeSpan(mIt->first));
+        } else {
+            // map entries left are all past the parent key, so step the parent
+            // instead of keeping a copy of its key to compare against
+            pIt->Next();
+            mIt = Advance(mIt, map.end(), std::greater<TBytesSpan>{}, {});
+        }
+        TrackRange(false);
     }
     void Prev() override {
         assert(Valid());
@@ -247,43 +424,56 @@ public:
             ++tmp;
         }
         auto it = std::reverse_iterator<decltype(tmp)>(tmp);
-        auto end = Advance(it, map.rend(), std::less<TBytes>{}, Key());
+        // the parent key does not outlive stepping the parent
+        TBytes parentKey;
+        TBytesSpan prevKey;
+        if (itState == Map) {
+            prevKey = MakeSpan(mIt->first);
+        } else {
+            const auto key = pIt->Key();
+            parentKey.assign(key.begin(), key.end());
+            prevKey = MakeSpan(parentKey);
+        }
+        auto end = Advance(it, map.rend(), std::less<TBytesSpan>{}, prevKey);
         if (end == map.rend()) {
             mIt = map.begin();
         } else {
             auto offset = mIt == map.end() ? 1 : 0;
             std::advance(mIt, -std::distance(it, end) - offset);
         }
+        TrackRange(true);
     }
     bool Valid() override {
         return itState != Invalid;
     }
-    TBytes Key() override {
+    TBytesSpan Key() override {
         assert(Valid());
-        return itState == Map ? mIt->first : pIt->Key();
+        return itState == Map ? MakeSpan(mIt->first) : pIt->Key();
     }
-    TBytes Value() override {
+    TBytesSpan Value() override {
         assert(Valid());
-        return itState == Map ? *mIt->second : pIt->Value();
+        return itState == Map ? MakeSpan(*mIt->second) : pIt->Value();
     }
 private:
+    // prevKey has to stay valid while the parent is stepped, so it is either
+    // a map key or a copy
     template<typename TIterator, typename Compare>
-    TIterator Advance(TIterator it, TIterator end, Compare comp, TBytes prevKey) {
+    TIterator Advance(TIterator it, TIterator end, Compare comp, std::optional<TBytesSpan> prevKey) {
 
         while (it != end || pIt->Valid()) {
-            while (it != end && (!pIt->Valid() || !comp(it->first, pIt->Key()))) {
-                if (prevKey.empty() || comp(it->first, prevKey)) {
+            while (it != end && (!pIt->Valid() || !comp(MakeSpan(it->first), pIt->Key()))) {
+                if (!prevKey || comp(MakeSpan(it->first), *prevKey)) {
                     if (it->second) {
                         itState = Map;
                         return it;
                     } else {
-                        prevKey = it->first;
+                        prevKey = MakeSpan(it->first);
                     }
                 }
                 ++it;
             }
             if (pIt->Valid()) {
-                if (prevKey.empty() || comp(pIt->Key(), prevKey)) {
+                if (!prevKey || comp(pIt->Key(), *prevKey)) {
                     itState = Parent;
                     return it;
                 }
@@ -299,10 +489,86 @@ private:
     void NextParent(std::reverse_iterator<MapKV::const_iterator>&) {
         pIt->Prev();
     }
+    // Widens the tracked range to the current position
+    void TrackRange(bool backward) {
+        if (!readSet) {
+            return;
+        }
+        std::lock_guard lock{*readSetMutex};
+        auto& [first, last] = readSet->ranges[range];
+        if (backward) {
+            if (!Valid()) {
+                first.clear();
+            } else if (auto key = Key(); key < MakeSpan(first)) {
+                first.assign(key.begin(), key.end());
+            }
+        } else if (!Valid()) {
+            last.reset();
+        } else if (auto key = Key(); last && MakeSpan(*last) < key) {
+            last->assign(key.begin(), key.end());
+        }
+    }
     const MapKV& map;
     MapKV::const_iterator mIt;
     std::unique_ptr<CStorageKVIterator> pIt;
     enum IteratorState { Invalid, Map, Parent } itState;
+    CStorageReadSet* readSet;
+    std::mutex* readSetMutex;
+    size_t range{};
+};
+
+// Read only Key-Value Storage of a database snapshot and the changes pending on top of it
+// when the snapshot was taken. The changes are frozen, so every view checked out from the
+// same snapshot shares them instead of copying.
+class CFrozenStorageKV : public CStorageKV {
+public:
+    CFrozenStorageKV(std::unique_ptr<CStorageLevelDB> &db_, std::shared_ptr<const MapKV> changed_) : db(std::move(db_)), changed(std::move(changed_)) {
+        assert(changed);
+    }
+    CFrozenStorageKV(const CFrozenStorageKV&) = delete;
+    ~CFrozenStorageKV() override = default;
+
+    using CStorageKV::Write;
+
+    bool Exists(const TBytes& key) const override {
+        auto it = changed->find(key);
+        if (it != changed->end()) {
+            return bool(it->second);
+        }
+        return db->Exists(key);
+    }
+    bool Write(const TBytes&, const TBytes&) override {
+        throw std::runtime_error("Cannot Write on frozen storage");
+    }
+    bool Erase(const TBytes&) override {
+        throw std::runtime_error("Cannot Erase on frozen storage");
+    }
+    bool Read(const TBytes& key, TBytes& value) const override {
+        auto it = changed->find(key);
+        if (it == changed->end()) {
+            return db->Read(key, value);
+        } else if (it->second) {
+            value = it->second.value();
+            return true;
+        }
+        return false;
+    }
+    bool Flush() override {
+        throw std::runtime_error("Cannot Flush on frozen storage");
+    }
+    size_t SizeEstimate() const override {
+        return 0;
+    }
+    uint64_t ApproximateSize(const TBytes& begin, const TBytes& end) const override {
+        return db->ApproximateSize(begin, end) + MapKVSize(*changed, begin, end);
+    }
+    std::unique_ptr<CStorageKVIterator> NewIterator() override {
+        return std::make_unique<CFlushableStorageKVIterator>(db->NewIterator(), *changed);
+    }
+
+private:
+    std::unique_ptr<CStorageLevelDB> db;
+    std::shared_ptr<const MapKV> changed;
 };
 
 // Flushable Key-Value Storage
@@ -311,8 +577,8 @@ public:
     // Normal constructor
     explicit CFlushableStorageKV(CStorageKV& db_) : db(db_) {}
 
-    // Snapshot constructor
-    explicit CFlushableStorageKV(std::unique_ptr<CStorageLevelDB> &db_, MapKV changed) : snapshotDB(std::move(db_)), db(*snapshotDB), changed(std::move(changed)), snapshot(true) {}
+    // Snapshot constructor, changes are kept in this layer and never flushed to the snapshot
+    explicit CFlushableStorageKV(std::unique_ptr<CFrozenStorageKV> db_) : snapshotDB(std::move(db_)), db(*snapshotDB), snapshot(true) {}
 
     CFlushableStorageKV(const CFlushableStorageKV&) = delete;
     ~CFlushableStorageKV() override = default;
@@ -322,12 +588,22 @@ public:
         if (it != changed.end()) {
             return bool(it->second);
         }
+        if (readSet) {
+            std::lock_guard lock{readSetMutex};
+            readSet->keys.insert(key);
+        }
         return db.Exists(key);
     }
+    using CStorageKV::Write;
+
     bool Write(const TBytes& key, const TBytes& value) override {
         changed[key] = value;
         return true;
     }
+    bool Write(TBytes&& key, TBytes&& value) override {
+        changed.insert_or_assign(std::move(key), std::move(value));
+        return true;
+    }
     bool Erase(const TBytes& key) override {
         changed[key] = {};
         return true;
@@ -335,6 +611,10 @@ public:
     bool Read(const TBytes& key, TBytes& value) const override {
         auto it = changed.find(key);
         if (it == changed.end()) {
+            if (readSet) {
+                std::lock_guard lock{readSetMutex};
+                readSet->keys.insert(key);
+            }
             return db.Read(key, value);
         } else if (it->second) {
             value = it->second.value();
@@ -347,6 +627,11 @@ public:
         if (snapshot) {
             throw std::runtime_error("Cannot Flush on storage based off a snapshot");
         }
+        // Nested views hand their nodes over to the parent layer without copying keys or values
+        if (auto parent = dynamic_cast<CFlushableStorageKV*>(&db)) {
+            parent->Merge(changed);
+            return true;
+        }
         for (const auto& it : changed) {
             if (!it.second) {
                 if (!db.Erase(it.first)) {
@@ -362,28 +647,53 @@ public:
     size_t SizeEstimate() const override {
         return memusage::DynamicUsage(changed);
     }
+    uint64_t ApproximateSize(const TBytes& begin, const TBytes& end) const override {
+        return db.ApproximateSize(begin, end) + MapKVSize(changed, begin, end);
+    }
     std::unique_ptr<CStorageKVIterator> NewIterator() override {
-        return std::make_unique<CFlushableStorageKVIterator>(db.NewIterator(), changed);
+        return std::make_unique<CFlushableStorageKVIterator>(db.NewIterator(), changed, readSet, &readSetMutex);
     }
 
     MapKV& GetRaw() {
         return changed;
     }
 
+    // Records reads that fall through to the layers below into readSet,
+    // readSet has to outlive this storage and its iterators. Reads may be
+    // tracked from several threads, like parallel scans of a snapshot.
+    void TrackReads(CStorageReadSet* set) {
+        readSet = set;
+    }
+
+    // Moves all entries of a child layer into this one, child entries win on equal keys.
+    // Map nodes are spliced, so neither keys nor values are reallocated.
+    void Merge(MapKV& other) {
+        changed.merge(other);
+        // only keys already present in this layer are left behind
+        for (auto& [key, value] : other) {
+            auto it = changed.find(key);
+            assert(it != changed.end());
+            it->second = std::move(value);
+        }
+        other.clear();
+    }
+
     [[nodiscard]] CStorageLevelDB* GetStorageLevelDB() const {
         const auto storageLevelDB = dynamic_cast<CStorageLevelDB*>(&db);
         assert(storageLevelDB);
         return storageLevelDB;
     }
 
-    std::pair<MapKV, const leveldb::Snapshot*> CreateSnapshotData() {
-        return {changed, GetStorageLevelDB()->CreateLevelDBSnapshot()};
+    std::pair<std::shared_ptr<const MapKV>, const leveldb::Snapshot*> CreateSnapshotData() {
+        return {std::make_shared<const MapKV>(changed), GetStorageLevelDB()->CreateLevelDBSnapshot()};
     }
 
 private:
-    std::unique_ptr<CStorageLevelDB> snapshotDB;
+    std::unique_ptr<CFrozenStorageKV> snapshotDB;
     CStorageKV& db;
     MapKV changed;
+    CStorageReadSet* readSet{};
+    mutable std::mutex readSetMutex;
 
     // Whether this view is using a snapshot
     bool snapshot{};
@@ -421,7 +731,13 @@ class CStorageIteratorWrapper {
     std::unique_ptr<CStorageKVIterator> it;
 
     void UpdateValidity() {
-        valid = it->Valid() && BytesToDbType(it->Key(), key) && key.first == By::prefix();
+        if (!it->Valid()) {
+            valid = false;
+            return;
+        }
+        // keys of other prefixes are not deserialized
+        const auto bytes = it->Key();
+        valid = bytes.size() > 0 && bytes[0] == By::prefix() && BytesToDbType(bytes, key);
     }
 
     struct Resolver {
@@ -494,6 +810,18 @@ CStorageIteratorWrapper<By, KeyType> NewKVIterator(const KeyType& key, MapKV& ma
     return it;
 }
 
+// Range of the keys of By, from start up to the first key past the range
+template<typename By, typename KeyType>
+struct CScanRange {
+    KeyType start;
+    // none for the last range
+    std::optional<TBytes> end;
+
+    bool Contains(const KeyType& key) const {
+        return !end || DbTypeToBytes(std::make_pair(By::prefix(), key)) < *end;
+    }
+};
+
 class CStorageView {
 public:
     // Normal constructors
@@ -518,7 +846,7 @@ public:
     bool Write(const KeyType& key, const ValueType& value) {
         auto vKey = DbTypeToBytes(key);
         auto vValue = DbTypeToBytes(value);
-        return DB().Write(vKey, vValue);
+        return DB().Write(std::move(vKey), std::move(vValue));
     }
     template<typename By, typename KeyType, typename ValueType>
     bool WriteBy(const KeyType& key, const ValueType& value) {
@@ -568,6 +896,30 @@ public:
         }
     }
 
+    // Splits the keys of By from start on into at most count ranges of similar size,
+    // every range starts at an existing key
+    template<typename By, typename KeyType>
+    std::vector<CScanRange<By, KeyType>> SplitRange(const KeyType& start, size_t count) {
+        auto last = DbTypeToBytes(std::make_pair(By::prefix(), start));
+        std::vector<CScanRange<By, KeyType>> ranges{{start, {}}};
+        auto it = DB().NewIterator();
+        for (const auto& bound : SplitKeyRange(DB(), last, {By::prefix()}, count)) {
+            it->Seek(bound);
+            std::pair<uint8_t, KeyType> key;
+            if (!it->Valid() || !BytesToDbType(it->Key(), key) || key.first != By::prefix()) {
+                break;
+            }
+            TBytes first(it->Key().begin(), it->Key().end());
+            if (first <= last) {
+                continue;
+            }
+            ranges.back().end = first;
+            ranges.push_back({std::move(key.second), {}});
+            last = std::move(first);
+        }
+        return ranges;
+    }
+
     virtual bool Flush() { return DB().Flush(); }
     size_t SizeEstimate() const { return DB().SizeEstimate(); }
 
@@ -24,6 +24,12 @@
 /** WWW-Authenticate to present with 401 Unauthorized response */
 static const char* WWW_AUTH_HEADER_DATA = "Basic realm=\"jsonrpc\"";
 
+/** Header a client sets to "1" (or "json") for a streamed reply, or to "ndjson" for one record per line */
+static const char* RPC_STREAM_HEADER = "x-rpcstream";
+
+/** Size at which buffered output of a streamed reply is handed to the http thread */
+static const size_t RPC_STREAM_CHUNK_SIZE = 64 << 10;
+
 /** Simple one-shot callback timer to be used by the RPC mechanism to e.g.
  * re-lock the wallet.
  */
@@ -68,6 +74,120 @@ static std::unique_ptr<HTTPRPCTimerInterface> httpRPCTimerInterface;
 /* The host to be used for CORS header */
 static std::string corsOriginHost;
 
+/**
+ * Streams the result of a list RPC to the client as it is produced, using a
+ * chunked reply. In JSON mode the body is byte for byte the reply JSONRPCReply
+ * would produce; in NDJSON mode each array element, or each key of an object
+ * result as {"key":value}, is written on its own line, and an error raised
+ * after the stream started is appended as a final {"error":...} line.
+ */
+class HTTPRPCResultStream : public JSONRPCResultStream
+{
+public:
+    HTTPRPCResultStream(HTTPRequest* _req, std::string _method, bool _ndjson) :
+        req(_req), method(std::move(_method)), ndjson(_ndjson) {}
+
+    bool Start(const std::string& _method, UniValue::VType _type) override
+    {
+        if (started || _method != method || (_type != UniValue::VARR && _type != UniValue::VOBJ)) {
+            return false;
+        }
+        started = true;
+        type = _type;
+        req->WriteHeader("Content-Type", ndjson ? "application/x-ndjson" : "application/json");
+        req->StartChunkedReply(HTTP_OK);
+        if (!ndjson) {
+            buffer = type == UniValue::VARR ? "{\"result\":[" : "{\"result\":{";
+        }
+        return true;
+    }
+
+    bool IsStarted() const override { return started; }
+
+    bool Write(const std::string& key, const UniValue& value) override
+    {
+        assert(started);
+        if (!open) {
+            return false;
+        }
+        if (ndjson) {
+            if (type == UniValue::VOBJ) {
+                buffer += "{" + UniValue(key).write() + ":" + value.write() + "}\n";
+            } else {
+                buffer += value.write() + "\n";
+            }
+        } else {
+            if (!first) {
+                buffer += ",";
+            }
+            if (type == UniValue::VOBJ) {
+                buffer += UniValue(key).write() + ":";
+            }
+            buffer += value.write();
+        }
+        first = false;
+        if (buffer.size() >= RPC_STREAM_CHUNK_SIZE) {
+            Flush();
+        }
+        return open;
+    }
+
+    /** Complete the reply with the outcome of the call, returns the number of bytes written */
+    size_t Finish(const UniValue& error, const UniValue& id)
+    {
+        assert(started);
+        if (!ndjson) {
+            buffer += type == UniValue::VARR ? "]" : "}";
+            buffer += ",\"error\":" + error.write() + ",\"id\":" + id.write() + "}\n";
+        } else if (!error.isNull()) {
+            buffer += "{\"error\":" + error.write() + "}\n";
+        }
+        Flush();
+        req->EndChunkedReply();
+        return written;
+    }
+
+private:
+    void Flush()
+    {
+        if (open && !buffer.empty()) {
+            open = req->WriteReplyChunk(buffer);
+            written += buffer.size();
+        }
+        buffer.clear();
+    }
+
+    HTTPRequest* req;
+    const std::string method;
+    const bool ndjson;
+    bool started{false};
+    bool open{true};
+    bool first{true};
+    UniValue::VType type{UniValue::VNULL};
+    std::string buffer;
+    size_t written{0};
+};
+
+/** Result of a call that was not streamed, in NDJSON form */
+static std::string NDJSONReply(const UniValue& result)
+{
+    std::string strReply;
+    if (result.isArray()) {
+        for (const auto& value : result.getValues()) {
+            strReply += value.write() + "\n";
+        }
+    } else if (result.isObject()) {
+        const auto& keys = result.getKeys();
+        const auto& values = result.getValues();
+        for (size_t i = 0; i < keys.size(); ++i) {
+            strReply += "{" + UniValue(keys[i]).write() + ":" + values[i].write() + "}\n";
+        }
+    } else {
+        strReply = result.write() + "\n";
+    }
+    return strReply;
+}
+
 static void JSONErrorReply(HTTPRequest* req, const UniValue& objError, const UniValue& id)
 {
     // Send error reply from json-rpc error object
@@ -218,14 +338,41 @@ static bool HTTPReq_JSONRPC(HTTPRequest* req, const std::string &)
         RPCMetadata::FromHTTPHeader(jreq.metadata, func);
 
         std::string strReply;
+        bool ndjson = false;
         // singleton request
         if (valRequest.isObject()) {
             jreq.parse(valRequest);
 
-            UniValue result = tableRPC.execute(jreq);
+            // List RPCs may write their result as they go when the client asked for a stream
+            std::shared_ptr<HTTPRPCResultStream> stream;
+            if (const auto [present, mode] = req->GetHeader(RPC_STREAM_HEADER); present) {
+                ndjson = mode == "ndjson";
+                if (ndjson || mode == "1" || mode == "json") {
+                    stream = std::make_shared<HTTPRPCResultStream>(req, jreq.strMethod, ndjson);
+                    jreq.stream = stream;
+                }
+            }
+
+            UniValue result, streamError;
+            try {
+                result = tableRPC.execute(jreq);
+            } catch (const UniValue& objError) {
+                if (!stream || !stream->IsStarted()) throw;
+                streamError = objError;
+            } catch (const std::exception& e) {
+                if (!stream || !stream->IsStarted()) throw;
+                streamError = JSONRPCError(RPC_PARSE_ERROR, e.what());
+            }
+
+            if (stream && stream->IsStarted()) {
+                // The status line is already out, errors can only go into the body
+                const auto size = stream->Finish(streamError, jreq.id);
+                if (statsRPC.isActive()) statsRPC.add(jreq.strMethod, GetTimeMillis() - time, size);
+                return streamError.isNull();
+            }
 
             // Send reply
-            strReply = JSONRPCReply(result, NullUniValue, jreq.id);
+            strReply = ndjson ? NDJSONReply(result) : JSONRPCReply(result, NullUniValue, jreq.id);
 
         // array of requests
         } else if (valRequest.isArray())
@@ -233,7 +380,7 @@ static bool HTTPReq_JSONRPC(HTTPRequest* req, const std::string &)
         else
             throw JSONRPCError(RPC_PARSE_ERROR, "Top-level object parse error");
 
-        req->WriteHeader("Content-Type", "application/json");
+        req->WriteHeader("Content-Type", ndjson ? "application/x-ndjson" : "application/json");
         req->WriteReply(HTTP_OK, strReply);
 
         if (statsRPC.isActive()) statsRPC.add(jreq.strMethod, GetTimeMillis() - time, strReply.length());
@@ -43,6 +43,23 @@
 /** Maximum size of http request (request line + headers) */
 static const size_t MAX_HEADERS_SIZE = 8192;
 
+/** Maximum bytes of a chunked reply queued but not yet sent to the client */
+static const size_t MAX_PENDING_REPLY_CHUNKS_SIZE = 4 << 20;
+
+/** Progress of a chunked reply, shared between the worker writing it and the main http thread */
+struct HTTPChunkedReply
+{
+    Mutex cs;
+    std::condition_variable cond;
+    /** Bytes written by the worker */
+    size_t queued GUARDED_BY(cs){0};
+    /** Bytes handed to libevent */
+    size_t submitted GUARDED_BY(cs){0};
+    /** Bytes sent to the client */
+    size_t sent GUARDED_BY(cs){0};
+    bool closed GUARDED_BY(cs){false};
+};
+
 /** HTTP request work item */
 class HTTPWorkItem final : public HTTPClosure
 {
@@ -538,6 +555,9 @@ HTTPRequest::HTTPRequest(struct evhttp_request* _req) : req(_req),
 }
 HTTPRequest::~HTTPRequest()
 {
+    if (!replySent && chunkedReply) {
+        EndChunkedReply();
+    }
     if (!replySent) {
         // Keep track of whether reply was sent to avoid request leaks
         LogPrintf("%s: Unhandled request\n", __func__);
@@ -619,6 +639,109 @@ void HTTPRequest::WriteReply(int nStatus, const std::string& strReply)
     req = nullptr; // transferred back to main thread
 }
 
+/** Called in the main http thread once all chunks handed to libevent are sent */
+static void http_reply_chunks_sent_cb(struct evhttp_connection*, void* arg)
+{
+    auto reply = static_cast<HTTPChunkedReply*>(arg);
+    LOCK(reply->cs);
+    reply->sent = reply->submitted;
+    reply->cond.notify_all();
+}
+
+/** Called in the main http thread when the connection of a chunked reply closes */
+static void http_reply_closed_cb(struct evhttp_connection*, void* arg)
+{
+    auto reply = static_cast<HTTPChunkedReply*>(arg);
+    LOCK(reply->cs);
+    reply->closed = true;
+    reply->cond.notify_all();
+}
+
+void HTTPRequest::StartChunkedReply(int nStatus)
+{
+    assert(!replySent && !chunkedReply && req);
+    if (ShutdownRequested()) {
+        WriteHeader("Connection", "close");
+    }
+    chunkedReply = std::make_shared<HTTPChunkedReply>();
+    auto req_copy = req;
+    auto reply = chunkedReply;
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, reply, nStatus]{
+        evhttp_send_reply_start(req_copy, nStatus, nullptr);
+        // The reply lives until EndChunkedReply, which unsets the callback again
+        if (evhttp_connection* conn = evhttp_request_get_connection(req_copy)) {
+            evhttp_connection_set_closecb(conn, http_reply_closed_cb, reply.get());
+        } else {
+            LOCK(reply->cs);
+            reply->closed = true;
+            reply->cond.notify_all();
+        }
+    });
+    ev->trigger(nullptr);
+}
+
+bool HTTPRequest::WriteReplyChunk(const std::string& chunk)
+{
+    assert(!replySent && chunkedReply && req);
+    auto reply = chunkedReply;
+    {
+        WAIT_LOCK(reply->cs, lock);
+        while (!reply->closed && reply->queued - reply->sent > MAX_PENDING_REPLY_CHUNKS_SIZE) {
+            if (ShutdownRequested()) {
+                return false;
+            }
+            reply->cond.wait_for(lock, std::chrono::milliseconds{100});
+        }
+        if (reply->closed) {
+            return false;
+        }
+        reply->queued += chunk.size();
+    }
+    auto req_copy = req;
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, reply, chunk]{
+        {
+            LOCK(reply->cs);
+            if (reply->closed) {
+                return;
+            }
+            reply->submitted += chunk.size();
+        }
+        struct evbuffer* evb = evbuffer_new();
+        assert(evb);
+        evbuffer_add(evb, chunk.data(), chunk.size());
+        evhttp_send_reply_chunk_with_cb(req_copy, evb, http_reply_chunks_sent_cb, reply.get());
+        evbuffer_free(evb);
+    });
+    ev->trigger(nullptr);
+    return true;
+}
+
+void HTTPRequest::EndChunkedReply()
+{
+    assert(!replySent && chunkedReply && req);
+    auto req_copy = req;
+    auto reply = chunkedReply;
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, reply]{
+        if (evhttp_connection* conn = evhttp_request_get_connection(req_copy)) {
+            evhttp_connection_set_closecb(conn, nullptr, nullptr);
+        }
+        evhttp_send_reply_end(req_copy);
+        // Re-enable reading from the socket, as in WriteReply.
+        if (event_get_version_number() >= 0x02010600 && event_get_version_number() < 0x02020001) {
+            evhttp_connection* conn = evhttp_request_get_connection(req_copy);
+            if (conn) {
+                bufferevent* bev = evhttp_connection_get_bufferevent(conn);
+                if (bev) {
+                    bufferevent_enable(bev, EV_READ | EV_WRITE);
+                }
+            }
+        }
+    });
+    ev->trigger(nullptr);
+    replySent = true;
+    req = nullptr; // transferred back to main thread
+}
+
 CService HTTPRequest::GetPeer() const
 {
     evhttp_connection* con = evhttp_request_get_connection(req);
@@ -8,6 +8,7 @@
 #include <string>
 #include <stdint.h>
 #include <functional>
+#include <memory>
 
 static const int DEFAULT_HTTP_THREADS=4;
 static const int DEFAULT_HTTP_WORKQUEUE=16;
@@ -17,6 +18,7 @@ struct evhttp_request;
 struct event_base;
 class CService;
 class HTTPRequest;
+struct HTTPChunkedReply;
 
 /** Initialize HTTP server.
  * Call this before RegisterHTTPHandler or EventBase().
@@ -59,6 +61,7 @@ class HTTPRequest
 private:
     struct evhttp_request* req;
     bool replySent;
+    std::shared_ptr<HTTPChunkedReply> chunkedReply;
 
 public:
     explicit HTTPRequest(struct evhttp_request* req);
@@ -115,6 +118,28 @@ public:
      * main thread, do not call any other HTTPRequest methods after calling this.
      */
     void WriteReply(int nStatus, const std::string& strReply = "");
+
+    /**
+     * Start a reply with chunked transfer encoding, its body is then written
+     * with WriteReplyChunk and completed with EndChunkedReply.
+     *
+     * @note call this instead of WriteReply, headers have to be written before.
+     */
+    void StartChunkedReply(int nStatus);
+
+    /**
+     * Write the next part of a chunked reply. Blocks while the parts written
+     * before and not yet sent to the client exceed a few megabytes, so
+     * producers go at the pace of the client.
+     * Returns false once the client is gone, later parts are dropped.
+     */
+    bool WriteReplyChunk(const std::string& chunk);
+
+    /**
+     * Complete a chunked reply. Like WriteReply this gives the request back
+     * to the main thread, do not call any other HTTPRequest methods after.
+     */
+    void EndChunkedReply();
 };
 
 /** Event handler closure.
@@ -464,6 +464,9 @@ void SetupServerArgs()
 #endif
     gArgs.AddArg("-txindex", strprintf("Maintain a full transaction index, used by the getrawtransaction rpc call (default: %u)", DEFAULT_TXINDEX), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     gArgs.AddArg("-acindex", strprintf("Maintain a full account history index, tracking all accounts balances changes. Used by the listaccounthistory, getaccounthistory and accounthistorycount rpc calls (default: %u)", DEFAULT_ACINDEX), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-acindexcovering", strprintf("Store account history values in the height ordered index as well, speeds up account history listings over all accounts at the cost of disk space. Changing it rewrites the account and burn history indexes once on the next startup (default: %u)", DEFAULT_ACINDEX_COVERING), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-rewardhistoryindex", strprintf("Record pool rewards paid to each account in the account history index. Used by listaccounthistory instead of recalculating rewards, complete history requires -reindex, requires -acindex (default: %u)", DEFAULT_REWARDHISTORYINDEX), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-undoretention=<n>", strprintf("Keep DeFi undo data for the last <n> blocks only, older data is pruned gradually while connecting blocks. Blocks older than <n> can't be disconnected, 0 keeps it down to the last checkpoint (default: %u, minimum: %u)", DEFAULT_UNDO_RETENTION, MIN_UNDO_RETENTION), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     gArgs.AddArg("-vaultindex", strprintf("Maintain a full vault history index, tracking all vault changes. Used by the listvaulthistory rpc call (default: %u)", DEFAULT_VAULTINDEX), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     gArgs.AddArg("-blockfilterindex=<type>",
                  strprintf("Maintain an index of compact filters by block (default: %s, values: %s).", DEFAULT_BLOCKFILTERINDEX, ListBlockFilterTypes()) +
@@ -662,7 +665,8 @@ void SetupServerArgs()
     gArgs.AddArg("-rpcallowcors=<host>", "Allow CORS requests from the given host origin. Include scheme and port (eg: -rpcallowcors=http://127.0.0.1:5000)", ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     gArgs.AddArg("-rpcstats", strprintf("Log RPC stats. (default: %u)", DEFAULT_RPC_STATS), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     gArgs.AddArg("-consolidaterewards=<token-or-pool-symbol>", "Consolidate rewards on startup. Accepted multiple times for each token symbol", ArgsManager::ALLOW_ANY, OptionsCategory::DEBUG_TEST);
-    gArgs.AddArg("-rpccache=<0/1/2>", "Cache rpc results - uses additional memory to hold on to the last results per block, but faster (0=none, 1=all, 2=smart)", ArgsManager::ALLOW_ANY, OptionsCategory::DEBUG_TEST);
+    gArgs.AddArg("-rpccache=<0/1/2>", "Cache rpc results - uses additional memory to hold on to the last results per block, but faster (0=none, 1=all, 2=smart, also keeps results across blocks that did not change the state they read)", ArgsManager::ALLOW_ANY, OptionsCategory::DEBUG_TEST);
+    gArgs.AddArg("-rpccachesize=<n>", strprintf("Limit the memory held by cached rpc results to <n> MiB (default: %u)", DEFAULT_RPC_CACHE_SIZE), ArgsManager::ALLOW_ANY, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-negativeinterest", "(experimental) Track negative interest values", ArgsManager::ALLOW_ANY, OptionsCategory::HIDDEN);
     gArgs.AddArg("-rpc-governance-accept-neutral", "Allow voting with neutral votes for JellyFish purpose", ArgsManager::ALLOW_ANY, OptionsCategory::HIDDEN);
     gArgs.AddArg("-dftxworkers=<n>", strprintf("No. of parallel workers associated with the DfTx related work pool. Stock splits, parallel processing of the chain where appropriate, etc use this worker pool (default: %d)", DEFAULT_DFTX_WORKERS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
@@ -918,12 +922,11 @@ static bool AppInitServers()
     auto rpcCacheMode = [=](){
         switch (rpcCacheModeVal) {
         case 1: return RPCResultCache::RPCCacheMode::All;
-        // For the moment, there is smart is dumb, just redirects to all.
-        // Future implementations could be smarter based on size / latency.
-        case 2: return RPCResultCache::RPCCacheMode::All;
+        case 2: return RPCResultCache::RPCCacheMode::Smart;
         default: return RPCResultCache::RPCCacheMode::None;
     }}();
-    GetRPCResultCache().Init(rpcCacheMode);
+    const auto rpcCacheSize = std::max<int64_t>(0, gArgs.GetArg("-rpccachesize", DEFAULT_RPC_CACHE_SIZE));
+    GetRPCResultCache().Init(rpcCacheMode, static_cast<size_t>(rpcCacheSize) << 20);
     GetMemoizedResultCache().Init(rpcCacheMode);
 
     RPCServer::OnStarted(&OnRPCStarted);
@@ -1291,6 +1294,18 @@ bool AppInitParameterInteraction()
         fPruneMode = true;
     }
 
+    const auto undoRetention = gArgs.GetArg("-undoretention", DEFAULT_UNDO_RETENTION);
+    if (undoRetention < 0) {
+        return InitError(_("Undo retention cannot be configured with a negative value.").translated);
+    }
+    if (undoRetention && undoRetention < MIN_UNDO_RETENTION) {
+        return InitError(strprintf(_("Undo retention configured below the minimum of %d blocks.").translated, MIN_UNDO_RETENTION));
+    }
+    nUndoRetention = static_cast<uint32_t>(std::min<int64_t>(undoRetention, std::numeric_limits<uint32_t>::max()));
+    if (nUndoRetention) {
+        LogPrintf("Undo data retained for the last %d blocks.\n", nUndoRetention);
+    }
+
     nConnectTimeout = gArgs.GetArg("-timeout", DEFAULT_CONNECT_TIMEOUT);
     if (nConnectTimeout <= 0) {
         nConnectTimeout = DEFAULT_CONNECT_TIMEOUT;
@@ -1925,16 +1940,20 @@ bool AppInitMain(InitInterfaces& interfaces)
                 // Ensure we are on latest DB version
                 pcustomcsview->SetDbVersion(CCustomCSView::DbVersion);
 
+                // Build token holders index before any block is connected
+                pcustomcsview->InitTokenHoldersIndex();
+
                 // make account history db
                 paccountHistoryDB.reset();
                 if (gArgs.GetBoolArg("-acindex", DEFAULT_ACINDEX)) {
                     paccountHistoryDB = std::make_unique<CAccountHistoryStorage>(GetDataDir() / "history", nCacheSizes.customCacheSize, false, fReset || fReindexChainState);
-                    paccountHistoryDB->CreateMultiIndexIfNeeded();
+                    paccountHistoryDB->CreateMultiIndexIfNeeded(gArgs.GetBoolArg("-acindexcovering", DEFAULT_ACINDEX_COVERING));
+                    paccountHistoryDB->InitPoolRewardHistory(gArgs.GetBoolArg("-rewardhistoryindex", DEFAULT_REWARDHISTORYINDEX), pcustomcsview->GetLastHeight() + 1);
                 }
 
                 pburnHistoryDB.reset();
                 pburnHistoryDB = std::make_unique<CBurnHistoryStorage>(GetDataDir() / "burn", nCacheSizes.customCacheSize, false, fReset || fReindexChainState);
-                pburnHistoryDB->CreateMultiIndexIfNeeded();
+                pburnHistoryDB->CreateMultiIndexIfNeeded(gArgs.GetBoolArg("-acindexcovering", DEFAULT_ACINDEX_COVERING));
 
                 // Create vault history DB
                 pvaultHistoryDB.reset();
@@ -2217,8 +2236,8 @@ bool AppInitMain(InitInterfaces& interfaces)
                     return false;
                 }
 
-                pcustomcsview->ForEachBalance([&, tokenId = token->first](const CScript &owner, CTokenAmount balance) {
-                    if (tokenId.v == balance.nTokenId.v && balance.nValue > 0) {
+                pcustomcsview->ForEachTokenHolder(token->first, [&](const CScript &owner, CTokenAmount balance) {
+                    if (balance.nValue > 0) {
                         ownersToConsolidate.emplace(owner);
                     }
                     return true;
@@ -1295,36 +1295,46 @@ namespace pos {
                     std::unique_lock l{pos::cs_MNLastBlockCreationAttemptTs};
                     pos::Staker::mapMNLastBlockCreationAttemptTs[masternodeID] = GetTime();
                 }
-                CheckContextState ctxState{subNode};
-                // Search backwards in time first
-                if (currentTime > lastSearchTime) {
-                    for (uint32_t t = 0; t < currentTime - lastSearchTime; ++t) {
+                // Check blockTime candidates first, first + step, ... in batches
+                const auto searchKernel = [&](const int64_t first, const int64_t count, const int64_t step) {
+                    std::vector<pos::KernelCandidate> candidates;
+                    candidates.reserve(pos::KERNEL_SEARCH_BATCH);
+
+                    for (int64_t t{}; t < count;) {
                         if (ShutdownRequested()) {
                             break;
                         }
 
-                        blockTime = (static_cast<uint32_t>(currentTime) - t);
-
-                        if (pos::CheckKernelHash(stakeModifier,
-                                                 nBits,
-                                                 creationHeight,
-                                                 blockTime,
-                                                 blockHeight,
-                                                 masternodeID,
-                                                 chainparams.GetConsensus(),
-                                                 subNodeBlockTime,
-                                                 ctxState)) {
+                        candidates.clear();
+                        for (; t < count && candidates.size() < pos::KERNEL_SEARCH_BATCH; ++t) {
+                            candidates.push_back({static_cast<uint32_t>(first + step * t), subNode, subNodeBlockTime});
+                        }
+
+                        if (const auto index = pos::SearchKernelHash(stakeModifier,
+                                                                     nBits,
+                                                                     creationHeight,
+                                                                     blockHeight,
+                                                                     masternodeID,
+                                                                     chainparams.GetConsensus(),
+                                                                     candidates)) {
+                            blockTime = candidates[*index].coinstakeTime;
+
                             LogPrint(BCLog::STAKING,
                                      "MakeStake: kernel found. height: %d time: %d\n",
                                      blockHeight,
                                      blockTime);
 
-                            found = true;
-                            break;
+                            return true;
                         }
 
                         std::this_thread::yield();  // give a slot to other threads
                     }
+                    return false;
+                };
+
+                // Search backwards in time first
+                if (currentTime > lastSearchTime) {
+                    found = searchKernel(currentTime, currentTime - lastSearchTime, -1);
                 }
 
                 if (!found) {
@@ -1332,33 +1342,7 @@ namespace pos {
                     int64_t searchTime = lastSearchTime > currentTime ? lastSearchTime : currentTime;
 
                     // Search forwards in time
-                    for (uint32_t t = 1; t <= futureTime - searchTime; ++t) {
-                        if (ShutdownRequested()) {
-                            break;
-                        }
-
-                        blockTime = (static_cast<uint32_t>(searchTime) + t);
-
-                        if (pos::CheckKernelHash(stakeModifier,
-                                                 nBits,
-                                                 creationHeight,
-                                                 blockTime,
-                                                 blockHeight,
-                                                 masternodeID,
-                                                 chainparams.GetConsensus(),
-                                                 subNodeBlockTime,
-                                                 ctxState)) {
-                            LogPrint(BCLog::STAKING,
-                                     "MakeStake: kernel found. height: %d time: %d\n",
-                                     blockHeight,
-                                     blockTime);
-
-                            found = true;
-                            break;
-                        }
-
-                        std::this_thread::yield();  // give a slot to other threads
-                    }
+                    found = searchKernel(searchTime + 1, futureTime - searchTime, 1);
                 }
             },
             blockHeight);
@@ -1,6 +1,8 @@
 #include <pos_kernel.h>
 #include <amount.h>
 #include <arith_uint256.h>
+#include <crypto/common.h>
+#include <crypto/sha256.h>
 #include <key.h>
 #include <validation.h>
 
@@ -72,6 +74,59 @@ namespace pos {
         return (hashProofOfStake / static_cast<uint64_t>( GetMnCollateralAmount( static_cast<int>(creationHeight) ) ) ) <= targetProofOfStake;
     }
 
+    std::optional<size_t> SearchKernelHash(const uint256& stakeModifier, uint32_t nBits, int64_t creationHeight, uint64_t blockHeight,
+                                           const uint256& masternodeID, const Consensus::Params& params, const std::vector<KernelCandidate>& candidates) {
+        // Single node kernels are rare enough to check them one by one
+        if (blockHeight < static_cast<uint64_t>(params.DF10EunosPayaHeight)) {
+            for (size_t i{}; i < candidates.size(); ++i) {
+                const auto& candidate = candidates[i];
+                if (CheckKernelHash(stakeModifier, nBits, creationHeight, candidate.coinstakeTime, blockHeight, masternodeID,
+                                    params, candidate.subNodeBlockTime, CheckContextState{candidate.subNode})) {
+                    return i;
+                }
+            }
+            return {};
+        }
+
+        arith_uint256 targetProofOfStake;
+        targetProofOfStake.SetCompact(nBits);
+        const auto collateral = GetMnCollateralAmount(static_cast<int>(creationHeight));
+
+        // Kernel is serialized once, time and sub node are patched in per candidate
+        CDataStream ss(SER_GETHASH, 0);
+        ss << stakeModifier << int64_t{} << collateral << masternodeID << uint8_t{};
+        const std::vector<unsigned char> kernel(ss.begin(), ss.end());
+        const auto size = kernel.size();
+        const auto timeOffset = stakeModifier.size();
+
+        std::vector<unsigned char> input(KERNEL_SEARCH_BATCH * size);
+        std::vector<unsigned char> output(KERNEL_SEARCH_BATCH * 32);
+
+        for (size_t first{}; first < candidates.size(); first += KERNEL_SEARCH_BATCH) {
+            const auto count = std::min(KERNEL_SEARCH_BATCH, candidates.size() - first);
+            for (size_t i{}; i < count; ++i) {
+                auto dst = input.data() + i * size;
+                memcpy(dst, kernel.data(), size);
+                WriteLE64(dst + timeOffset, candidates[first + i].coinstakeTime);
+                dst[size - 1] = candidates[first + i].subNode;
+            }
+            SHA256DMulti(output.data(), input.data(), size, count);
+
+            for (size_t i{}; i < count; ++i) {
+                const auto& candidate = candidates[first + i];
+                uint256 hash;
+                memcpy(hash.begin(), output.data() + i * 32, 32);
+                const auto coinDayWeight = CalcCoinDayWeight(params, candidate.coinstakeTime, candidate.subNodeBlockTime);
+
+                // Increase target by coinDayWeight.
+                if ((UintToArith256(hash) / static_cast<uint64_t>(collateral)) <= targetProofOfStake * coinDayWeight) {
+                    return first + i;
+                }
+            }
+        }
+        return {};
+    }
+
     uint256 ComputeStakeModifier(const uint256& prevStakeModifier, const CKeyID& key) {
         // Calculate hash
         CDataStream ss(SER_GETHASH, 0);
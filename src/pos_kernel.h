@@ -8,6 +8,9 @@
 #include <amount.h>
 #include <pos.h>
 
+#include <optional>
+#include <vector>
+
 class CWallet;
 class COutPoint;
 class CBlock;
@@ -30,6 +33,21 @@ namespace pos {
     bool CheckKernelHash(const uint256& stakeModifier, uint32_t nBits, int64_t creationHeight, int64_t coinstakeTime, uint64_t blockHeight,
                          const uint256& masternodeID, const Consensus::Params& params, const int64_t subNodeBlockTime, const CheckContextState ctxState);
 
+/// Candidate kernel of a batched search
+    struct KernelCandidate {
+        int64_t coinstakeTime;
+        uint8_t subNode;
+        int64_t subNodeBlockTime;
+    };
+
+    /// Number of candidates hashed together by SearchKernelHash
+    static constexpr size_t KERNEL_SEARCH_BATCH = 64;
+
+/// Check candidates in order, returns the index of the first one meeting the hash target.
+/// Same result as CheckKernelHash per candidate, kernels are hashed in parallel SHA256 lanes.
+    std::optional<size_t> SearchKernelHash(const uint256& stakeModifier, uint32_t nBits, int64_t creationHeight, uint64_t blockHeight,
+                                           const uint256& masternodeID, const Consensus::Params& params, const std::vector<KernelCandidate>& candidates);
+
 /// Stake Modifier (hash modifier of proof-of-stake)
     uint256 ComputeStakeModifier(const uint256& prevStakeModifier, const CKeyID& key);
 }
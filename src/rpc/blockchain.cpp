@@ -1700,6 +1700,10 @@ UniValue MempoolInfoToJSON(const CTxMemPool& pool)
     ret.pushKV("maxmempool", (int64_t) maxmempool);
     ret.pushKV("mempoolminfee", ValueFromAmount(std::max(pool.GetMinFee(maxmempool), ::minRelayTxFee).GetFeePerK()));
     ret.pushKV("minrelaytxfee", ValueFromAmount(::minRelayTxFee.GetFeePerK()));
+    const auto [revalidated, skipped] = pool.getDeFiRevalidationStats();
+    ret.pushKV("defirevalidated", revalidated);
+    ret.pushKV("defiskipped", skipped);
+    ret.pushKV("defitracesusage", (int64_t)pool.getDeFiTracesUsage());
 
     return ret;
 }
@@ -1717,7 +1721,10 @@ static UniValue getmempoolinfo(const JSONRPCRequest& request)
             "  \"usage\": xxxxx,              (numeric) Total memory usage for the mempool\n"
             "  \"maxmempool\": xxxxx,         (numeric) Maximum memory usage for the mempool\n"
             "  \"mempoolminfee\": xxxxx       (numeric) Minimum fee rate in " + CURRENCY_UNIT + "/kB for tx to be accepted. Is the maximum of minrelaytxfee and minimum mempool fee\n"
-            "  \"minrelaytxfee\": xxxxx       (numeric) Current minimum relay fee for transactions\n"
+            "  \"minrelaytxfee\": xxxxx,      (numeric) Current minimum relay fee for transactions\n"
+            "  \"defirevalidated\": xxxxx,    (numeric) Entries validated again against the DeFi state on accounts view rebuilds\n"
+            "  \"defiskipped\": xxxxx,        (numeric) Entries carried over unchanged on accounts view rebuilds\n"
+            "  \"defitracesusage\": xxxxx     (numeric) Memory usage of the DeFi state read and written by entries, not counted in usage and maxmempool\n"
             "}\n"
                 },
                 RPCExamples{
@@ -5,9 +5,12 @@
 
 #include <chainparams.h>
 #include <crypto/ripemd160.h>
+#include <dfi/snapshotmanager.h>
+#include <dfi/threadpool.h>
 #include <httpserver.h>
 #include <outputtype.h>
 #include <rpc/blockchain.h>
+#include <rpc/resultcache.h>
 #include <rpc/server.h>
 #include <rpc/util.h>
 #include <script/descriptor.h>
@@ -410,6 +413,38 @@ static UniValue RPCLockedMemoryInfo()
     return obj;
 }
 
+static UniValue RPCSnapshotMemoryInfo()
+{
+    UniValue obj(UniValue::VOBJ);
+    if (!psnapshotManager) {
+        return obj;
+    }
+    const auto info = psnapshotManager->GetMemoryInfo();
+    obj.pushKV("height", info.height);
+    UniValue checkedOut(UniValue::VOBJ);
+    checkedOut.pushKV("view", info.checkedOut.at(SnapshotType::VIEW));
+    checkedOut.pushKV("history", info.checkedOut.at(SnapshotType::HISTORY));
+    checkedOut.pushKV("vault", info.checkedOut.at(SnapshotType::VAULT));
+    obj.pushKV("checkedout", checkedOut);
+    obj.pushKV("layers", uint64_t(info.layers));
+    obj.pushKV("used", uint64_t(info.memoryUsage));
+    return obj;
+}
+
+static UniValue RPCResultCacheInfo()
+{
+    const auto stats = GetRPCResultCache().GetStats();
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("entries", uint64_t(stats.entries));
+    obj.pushKV("used", uint64_t(stats.memoryUsage));
+    obj.pushKV("budget", uint64_t(stats.memoryBudget));
+    obj.pushKV("hits", stats.hits);
+    obj.pushKV("misses", stats.misses);
+    obj.pushKV("evictions", stats.evictions);
+    obj.pushKV("invalidations", stats.invalidations);
+    return obj;
+}
+
 #ifdef HAVE_MALLOC_INFO
 static std::string RPCMallocInfo()
 {
@@ -451,6 +486,25 @@ static UniValue getmemoryinfo(const JSONRPCRequest& request)
             "    \"locked\": xxxxxx,       (numeric) Amount of bytes that succeeded locking. If this number is smaller than total, locking pages failed at some point and key data could be swapped to disk.\n"
             "    \"chunks_used\": xxxxx,   (numeric) Number allocated chunks\n"
             "    \"chunks_free\": xxxxx,   (numeric) Number unused chunks\n"
+            "  },\n"
+            "  \"snapshots\": {            (json object) Information about DeFi state snapshots used by RPC\n"
+            "    \"height\": xxxxx,        (numeric) Height of the current snapshot, -1 if there is none\n"
+            "    \"checkedout\": {         (json object) Number of snapshots in use by type\n"
+            "      \"view\": xxxxx,\n"
+            "      \"history\": xxxxx,\n"
+            "      \"vault\": xxxxx\n"
+            "    },\n"
+            "    \"layers\": xxxxx,        (numeric) Number of pending change layers held, shared by views of the same block\n"
+            "    \"used\": xxxxx           (numeric) Number of bytes held by the pending change layers\n"
+            "  },\n"
+            "  \"rpccache\": {             (json object) Information about cached RPC results\n"
+            "    \"entries\": xxxxx,       (numeric) Number of cached results\n"
+            "    \"used\": xxxxx,          (numeric) Approximate number of bytes held by cached results\n"
+            "    \"budget\": xxxxx,        (numeric) Number of bytes cached results are kept within\n"
+            "    \"hits\": xxxxx,          (numeric) Number of requests served from the cache\n"
+            "    \"misses\": xxxxx,        (numeric) Number of cacheable requests computed\n"
+            "    \"evictions\": xxxxx,     (numeric) Number of results dropped to stay within the budget\n"
+            "    \"invalidations\": xxxxx  (numeric) Number of results dropped by block changes\n"
             "  }\n"
             "}\n"
                     },
@@ -468,6 +522,8 @@ static UniValue getmemoryinfo(const JSONRPCRequest& request)
     if (mode == "stats") {
         UniValue obj(UniValue::VOBJ);
         obj.pushKV("locked", RPCLockedMemoryInfo());
+        obj.pushKV("snapshots", RPCSnapshotMemoryInfo());
+        obj.pushKV("rpccache", RPCResultCacheInfo());
         return obj;
     } else if (mode == "mallocinfo") {
 #ifdef HAVE_MALLOC_INFO
@@ -480,6 +536,46 @@ static UniValue getmemoryinfo(const JSONRPCRequest& request)
     }
 }
 
+static UniValue getthreadpoolstats(const JSONRPCRequest& request)
+{
+            RPCHelpMan{"getthreadpoolstats",
+                "Returns task counters of the DeFi transaction worker threads.\n",
+                {},
+                RPCResult{
+            "{\n"
+            "  \"threads\": xxxxx,         (numeric) Number of worker threads\n"
+            "  \"consensus\": {            (json object) Block validation and connection tasks\n"
+            "    \"posted\": xxxxx,        (numeric) Number of tasks queued\n"
+            "    \"completed\": xxxxx      (numeric) Number of tasks run\n"
+            "  },\n"
+            "  \"rpc\": {                  (json object) RPC tasks, same fields as consensus\n"
+            "    ...\n"
+            "  },\n"
+            "  \"stolen\": xxxxx           (numeric) Number of tasks taken over from the queue of another worker\n"
+            "}\n"
+                },
+                RPCExamples{
+                    HelpExampleCli("getthreadpoolstats", "")
+            + HelpExampleRpc("getthreadpoolstats", "")
+                },
+            }.Check(request);
+
+    const auto metrics = DfTxTaskPool ? DfTxTaskPool->GetMetrics() : TaskPoolMetrics{};
+    const auto priorityStats = [&](TaskPriority priority) {
+        const auto index = static_cast<size_t>(priority);
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("posted", metrics.posted[index]);
+        obj.pushKV("completed", metrics.completed[index]);
+        return obj;
+    };
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("threads", uint64_t(metrics.threads));
+    obj.pushKV("consensus", priorityStats(TaskPriority::Consensus));
+    obj.pushKV("rpc", priorityStats(TaskPriority::RPC));
+    obj.pushKV("stolen", metrics.stolen);
+    return obj;
+}
+
 static void EnableOrDisableLogCategories(UniValue cats, bool enable) {
     cats = cats.get_array();
     for (unsigned int i = 0; i < cats.size(); ++i) {
@@ -645,6 +741,7 @@ static const CRPCCommand commands[] =
 { //  category              name                      actor (function)         argNames
   //  --------------------- ------------------------  -----------------------  ----------
     { "control",            "getmemoryinfo",          &getmemoryinfo,          {"mode"} },
+    { "control",            "getthreadpoolstats",     &getthreadpoolstats,     {} },
     { "control",            "logging",                &logging,                {"include", "exclude"}},
     { "util",               "validateaddress",        &validateaddress,        {"address"} },
     { "util",               "createmultisig",         &createmultisig,         {"nrequired","keys","address_type"} },
@@ -6,6 +6,7 @@
 #ifndef DEFI_RPC_REQUEST_H
 #define DEFI_RPC_REQUEST_H
 
+#include <memory>
 #include <string>
 #include <univalue.h>
 #include <dfi/coinselect.h>
@@ -59,6 +60,22 @@ struct RPCMetadata {
 };
     // UniValue metadata;
 
+/**
+ * Incremental output for array or object results, offered by the transport
+ * when the client asked for a streamed reply. Only the handler of the method
+ * the stream was opened for may start it, and only once.
+ */
+class JSONRPCResultStream
+{
+public:
+    virtual ~JSONRPCResultStream() = default;
+    /** Start streaming a result of the given type; false if the stream is not available to this method */
+    virtual bool Start(const std::string& method, UniValue::VType type) = 0;
+    virtual bool IsStarted() const = 0;
+    /** Write one element of the result, the key is ignored for arrays; false once the client is gone */
+    virtual bool Write(const std::string& key, const UniValue& value) = 0;
+};
+
 class JSONRPCRequest
 {
 public:
@@ -70,6 +87,7 @@ public:
     std::string authUser;
     std::string peerAddr;
     RPCMetadata metadata;
+    std::shared_ptr<JSONRPCResultStream> stream;
 
     JSONRPCRequest() : id(NullUniValue), params(NullUniValue), fHelp(false), metadata(RPCMetadata::CreateDefault()) {}
     void parse(const UniValue& valRequest);
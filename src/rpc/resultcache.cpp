@@ -1,11 +1,104 @@
 #include <rpc/resultcache.h>
 #include <rpc/util.h>
+#include <dfi/masternodes.h>
 #include <logging.h>
 #include <validation.h>
 
-void RPCResultCache::Init(RPCCacheMode mode) {
+namespace {
+// Reads and cache hits of the RPC call running on this thread
+struct RPCReadContext {
+    // Smart mode and a method whose result only depends on the view snapshot
+    bool tracked{};
+    CStorageReadSet reads;
+    // Oldest cache generation a snapshot or a cache hit of the call was taken at
+    std::optional<uint64_t> generation;
+    // Prefixes read by the cached results served within the call
+    RPCResultCache::Prefixes hitPrefixes;
+    // A result served within the call did not track its reads
+    bool untrackedHit{};
+
+    void SetGeneration(uint64_t value) {
+        if (!generation || value < *generation) {
+            generation = value;
+        }
+    }
+};
+
+thread_local std::unique_ptr<RPCReadContext> g_readContext;
+}
+
+static RPCResultCache::Prefixes ReadPrefixes(const CStorageReadSet &reads) {
+    RPCResultCache::Prefixes prefixes;
+    for (const auto &key : reads.keys) {
+        if (!key.empty()) {
+            prefixes.set(key[0]);
+        }
+    }
+    // Iterators left the range on its next key, or ran off the end of the storage
+    for (const auto &[first, last] : reads.ranges) {
+        const size_t begin = first.empty() ? 0 : first[0];
+        const size_t end = !last ? prefixes.size() - 1 : last->empty() ? 0 : (*last)[0];
+        for (auto prefix = begin; prefix <= end; ++prefix) {
+            prefixes.set(prefix);
+        }
+    }
+    return prefixes;
+}
+
+// Approximate memory held by a result
+static size_t UniValueUsage(const UniValue &value) {
+    size_t usage = sizeof(UniValue) + value.getValStr().size();
+    if (value.isObject()) {
+        for (const auto &key : value.getKeys()) {
+            usage += sizeof(std::string) + key.size();
+        }
+    }
+    if (value.isObject() || value.isArray()) {
+        for (const auto &item : value.getValues()) {
+            usage += UniValueUsage(item);
+        }
+    }
+    return usage;
+}
+
+RPCResultCache::ReadScope::ReadScope(const std::string &method) {
+    if (g_readContext) {
+        return;
+    }
+    auto &cache = GetRPCResultCache();
+    g_readContext = std::make_unique<RPCReadContext>();
+    g_readContext->tracked = cache.mode == RPCCacheMode::Smart && cache.trackedMethods.count(method);
+    owner = true;
+}
+
+RPCResultCache::ReadScope::~ReadScope() {
+    if (owner) {
+        g_readContext.reset();
+    }
+}
+
+void RPCResultCache::Init(RPCCacheMode mode, size_t memoryBudget) {
     std::unique_lock l{aMutex};
     this->mode = mode;
+    this->memoryBudget = memoryBudget;
+    // Methods reading the chain height are left out, every block changes it
+    trackedMethods = {
+        "getgov",
+        "getloanscheme",
+        "getloantokens",
+        "getlockedtokens",
+        "getoracledata",
+        "listcollateraltokens",
+        "listfixedintervalprices",
+        "listgovs",
+        "listloanschemes",
+        "listloantokens",
+        "listlockedtokens",
+        "listoracles",
+        "listpendingdusdswaps",
+        "listpendingfutureswaps",
+        "listpoolpairs",
+    };
 }
 
 std::string GetKey(const JSONRPCRequest &request) {
@@ -14,45 +107,128 @@ std::string GetKey(const JSONRPCRequest &request) {
     return ss.str();
 }
 
-bool RPCResultCache::InvalidateCaches() {
+void RPCResultCache::Erase(std::map<std::string, Entry>::iterator it) {
+    stats.memoryUsage -= it->second.memoryUsage;
+    lruList.erase(it->second.lru);
+    cacheMap.erase(it);
+}
+
+bool RPCResultCache::InvalidateCaches(const std::optional<Prefixes> &changed) {
+    std::unique_lock l{aMutex};
+    ++generation;
+    const auto selective = changed && mode == RPCCacheMode::Smart;
+    size_t dropped{};
+    for (auto it = cacheMap.begin(); it != cacheMap.end();) {
+        const auto &prefixes = it->second.prefixes;
+        if (!selective || !prefixes || (*prefixes & *changed).any()) {
+            Erase(it++);
+            ++dropped;
+        } else {
+            ++it;
+        }
+    }
+    stats.invalidations += dropped;
+    LogPrint(BCLog::RPCCACHE, "RPCCache: invalidate: dropped: %d, kept: %d\n", dropped, cacheMap.size());
+    return dropped != 0;
+}
+
+uint64_t RPCResultCache::GetGeneration() {
+    std::unique_lock l{aMutex};
+    return generation;
+}
+
+void RPCResultCache::TrackSnapshot(CCustomCSView &view, uint64_t generation) {
+    const auto context = g_readContext.get();
+    if (!context) {
+        return;
+    }
+    context->SetGeneration(generation);
+    if (context->tracked) {
+        view.GetStorage().TrackReads(&context->reads);
+    }
+}
+
+RPCResultCache::Stats RPCResultCache::GetStats() {
     std::unique_lock l{aMutex};
-    auto height = GetLastValidatedHeight();
-    if (cacheHeight != height) {
-        LogPrint(BCLog::RPCCACHE, "RPCCache: clear\n");
-        if (cacheMap.size()) cacheMap.clear();
-        cacheHeight = height;
-        return true;
+    auto result = stats;
+    result.entries = cacheMap.size();
+    result.memoryBudget = memoryBudget;
+    return result;
+}
+
+RPCResultCache::Prefixes RPCResultCache::ChangedPrefixes(const MapKV &changed) {
+    Prefixes prefixes;
+    for (const auto &[key, value] : changed) {
+        if (!key.empty()) {
+            prefixes.set(key[0]);
+        }
     }
-    return false;
+    return prefixes;
 }
 
 std::optional<UniValue> RPCResultCache::TryGet(const JSONRPCRequest &request) {
     auto cacheMode = mode;
     if (cacheMode == RPCCacheMode::None) return {};
-    if (cacheMode == RPCCacheMode::Smart &&
-        smartModeList.find(request.strMethod) == smartModeList.end()) return {};
     auto key = GetKey(request);
-    UniValue val;
     {
         std::unique_lock l{aMutex};
         if (auto res = cacheMap.find(key); res != cacheMap.end()) {
+            auto &entry = res->second;
+            ++stats.hits;
+            lruList.splice(lruList.begin(), lruList, entry.lru);
+            if (const auto context = g_readContext.get()) {
+                context->SetGeneration(generation);
+                if (entry.prefixes) {
+                    context->hitPrefixes |= *entry.prefixes;
+                } else {
+                    context->untrackedHit = true;
+                }
+            }
             if (LogAcceptCategory(BCLog::RPCCACHE)) {
-                LogPrint(BCLog::RPCCACHE, "RPCCache: hit: key: %d/%s, val: %s\n", cacheHeight, key, res->second.write());
+                LogPrint(BCLog::RPCCACHE, "RPCCache: hit: key: %d/%s, val: %s\n", generation, key, entry.value.write());
             }
-            return res->second;
+            return entry.value;
         }
+        ++stats.misses;
     }
     return {};
 }
 
 const UniValue& RPCResultCache::Set(const JSONRPCRequest &request, const UniValue &value) {
+    if (mode == RPCCacheMode::None) return value;
+    // Streamed straight to the client, nothing was collected
+    if (request.stream && request.stream->IsStarted()) return value;
     auto key = GetKey(request);
+
+    const auto context = g_readContext.get();
+    std::optional<Prefixes> prefixes;
+    if (context && context->tracked && context->generation && !context->untrackedHit &&
+        trackedMethods.count(request.strMethod)) {
+        prefixes = ReadPrefixes(context->reads) | context->hitPrefixes;
+    }
+    const auto usage = sizeof(Entry) + 2 * key.size() + UniValueUsage(value);
     {
         std::unique_lock l{aMutex};
+        // Computed on a snapshot a block change has invalidated since
+        if (context && context->generation && *context->generation != generation) {
+            return value;
+        }
+        if (usage > memoryBudget) {
+            return value;
+        }
         if (LogAcceptCategory(BCLog::RPCCACHE)) {
-            LogPrint(BCLog::RPCCACHE, "RPCCache: set: key: %d/%s, val: %s\n", cacheHeight, key, value.write());
+            LogPrint(BCLog::RPCCACHE, "RPCCache: set: key: %d/%s, tracked: %d, val: %s\n", generation, key, bool(prefixes), value.write());
+        }
+        if (auto it = cacheMap.find(key); it != cacheMap.end()) {
+            Erase(it);
+        }
+        lruList.push_front(key);
+        cacheMap.emplace(key, Entry{value, prefixes, usage, lruList.begin()});
+        stats.memoryUsage += usage;
+        while (stats.memoryUsage > memoryBudget) {
+            Erase(cacheMap.find(lruList.back()));
+            ++stats.evictions;
         }
-        cacheMap[key] = value;
     }
     return value;
 }
@@ -71,10 +247,10 @@ int GetLastValidatedHeight() {
     return res;
 }
 
-void SetLastValidatedHeight(int height) {
+void SetLastValidatedHeight(int height, const std::optional<RPCResultCache::Prefixes> &changed) {
     LogPrint(BCLog::RPCCACHE, "RPCCache: set height: %d\n", height);
     g_lastValidatedHeight.store(height, std::memory_order_release);
-    GetRPCResultCache().InvalidateCaches();
+    GetRPCResultCache().InvalidateCaches(changed);
 }
 
 void MemoizedResultCache::Init(RPCResultCache::RPCCacheMode mode) {
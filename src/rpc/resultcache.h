@@ -2,7 +2,10 @@
 #define DEFI_RPC_RESULTCACHE_H
 
 #include <atomic>
+#include <bitset>
 #include <dfi/balances.h>
+#include <dfi/snapshotmanager.h>
+#include <list>
 #include <map>
 #include <memory>
 #include <optional>
@@ -21,6 +24,11 @@ struct CGetBurnInfoResult {
     CBalances paybackFee;
 };
 
+class CCustomCSView;
+
+//! Default for -rpccachesize, in MiB
+static const int64_t DEFAULT_RPC_CACHE_SIZE = 64;
+
 class RPCResultCache {
 public:
     enum RPCCacheMode {
@@ -29,24 +37,76 @@ public:
         All
     };
 
-    void Init(RPCCacheMode mode);
+    // Storage key prefixes, the first byte of a key
+    using Prefixes = std::bitset<256>;
+
+    struct Stats {
+        uint64_t hits{};
+        uint64_t misses{};
+        // Entries dropped to stay within the memory budget
+        uint64_t evictions{};
+        // Entries dropped by block changes
+        uint64_t invalidations{};
+        size_t entries{};
+        size_t memoryUsage{};
+        size_t memoryBudget{};
+    };
+
+    // Collects the view snapshot reads of an RPC call, so that in Smart mode its results
+    // are only dropped by blocks changing what they read. Calls made from within a call
+    // share the outermost scope.
+    class ReadScope {
+        bool owner{};
+
+    public:
+        explicit ReadScope(const std::string &method);
+        ~ReadScope();
+        ReadScope(const ReadScope &) = delete;
+        ReadScope &operator=(const ReadScope &) = delete;
+    };
+
+    void Init(RPCCacheMode mode, size_t memoryBudget = DEFAULT_RPC_CACHE_SIZE << 20);
     std::optional<UniValue> TryGet(const JSONRPCRequest &request);
     const UniValue& Set(const JSONRPCRequest &request, const UniValue &value);
-    bool InvalidateCaches();
+    // Drops the entries a block change may affect. Without the changed prefixes, or outside
+    // of Smart mode, every entry is dropped.
+    bool InvalidateCaches(const std::optional<Prefixes> &changed = {});
+    // Counter of invalidations, results computed on a snapshot taken before the
+    // last invalidation are not cached
+    uint64_t GetGeneration();
+    // Called for every view snapshot checked out by an RPC call
+    void TrackSnapshot(CCustomCSView &view, uint64_t generation);
+    Stats GetStats();
+
+    static Prefixes ChangedPrefixes(const MapKV &changed);
 
 private:
+    struct Entry {
+        UniValue value;
+        // Prefixes read, no value means the result may depend on any change
+        std::optional<Prefixes> prefixes;
+        size_t memoryUsage{};
+        std::list<std::string>::iterator lru;
+    };
+
+    void Erase(std::map<std::string, Entry>::iterator it);
+
     AtomicMutex aMutex;
-    std::set<std::string> smartModeList{};
+    // Methods whose results only depend on the view snapshot they read
+    std::set<std::string> trackedMethods{};
     RPCCacheMode mode{RPCCacheMode::None};
-    std::map<std::string, UniValue> cacheMap{};
-    int cacheHeight{0};
-
+    std::map<std::string, Entry> cacheMap{};
+    // Most recently used entries first
+    std::list<std::string> lruList{};
+    uint64_t generation{0};
+    size_t memoryBudget{};
+    Stats stats{};
 };
 
 RPCResultCache& GetRPCResultCache();
 
 int GetLastValidatedHeight();
-void SetLastValidatedHeight(int height);
+void SetLastValidatedHeight(int height, const std::optional<RPCResultCache::Prefixes> &changed = {});
 
 struct CMemoizedResultValue {
     int height;
@@ -7,6 +7,7 @@
 
 #include <fs.h>
 #include <key_io.h>
+#include <rpc/resultcache.h>
 #include <rpc/util.h>
 #include <shutdown.h>
 #include <sync.h>
@@ -449,6 +450,7 @@ static bool ExecuteCommand(const CRPCCommand& command, const JSONRPCRequest& req
     try
     {
         RPCCommandExecution execution(request.strMethod);
+        RPCResultCache::ReadScope readScope(request.strMethod);
         // Execute, convert arguments to array if necessary
         if (request.params.isObject()) {
             return command.actor(transformNamedArguments(request, command.argNames), result, last_handler);
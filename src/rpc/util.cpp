@@ -755,3 +755,44 @@ std::vector<CScript> EvalDescriptorStringOrObject(const UniValue& scanobject, Fl
     }
     return ret;
 }
+
+RPCResultWriter::RPCResultWriter(const JSONRPCRequest& request, UniValue::VType type)
+{
+    if (request.stream && request.stream->Start(request.strMethod, type)) {
+        stream = request.stream.get();
+    } else {
+        result = UniValue(type);
+    }
+}
+
+bool RPCResultWriter::push_back(const UniValue& value)
+{
+    ++count;
+    if (stream) {
+        return stream->Write({}, value);
+    }
+    result.push_back(value);
+    return true;
+}
+
+bool RPCResultWriter::pushKV(const std::string& key, const UniValue& value)
+{
+    ++count;
+    if (stream) {
+        return stream->Write(key, value);
+    }
+    result.pushKV(key, value);
+    return true;
+}
+
+bool RPCResultWriter::pushKVs(const UniValue& obj)
+{
+    const auto& keys = obj.getKeys();
+    const auto& values = obj.getValues();
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (!pushKV(keys[i], values[i])) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -262,4 +262,29 @@ private:
     const RPCExamples m_examples;
 };
 
+/**
+ * Builds the result of a list RPC, or writes it straight to the client
+ * when the request carries a result stream.
+ */
+class RPCResultWriter
+{
+public:
+    RPCResultWriter(const JSONRPCRequest& request, UniValue::VType type);
+
+    /** Append an element; false once the client is gone and iteration should stop */
+    bool push_back(const UniValue& value);
+    bool pushKV(const std::string& key, const UniValue& value);
+    bool pushKVs(const UniValue& obj);
+
+    size_t size() const { return count; }
+    bool IsStreaming() const { return stream != nullptr; }
+    /** The collected result, or null if it was streamed */
+    const UniValue& get() const { return result; }
+
+private:
+    UniValue result;
+    JSONRPCResultStream* stream{nullptr};
+    size_t count{0};
+};
+
 #endif // DEFI_RPC_UTIL_H
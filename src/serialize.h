@@ -216,6 +216,9 @@ template<typename X> const X& ReadWriteAsHelper(const X& x) { return x; }
     }                                                                 \
     void Unserialize(VectorReader& s) override {                      \
         SerializationOp(s, CSerActionUnserialize());                  \
+    }                                                                 \
+    void Unserialize(SpanReader& s) override {                        \
+        SerializationOp(s, CSerActionUnserialize());                  \
     }
 
 #ifndef CHAR_EQUALS_INT8
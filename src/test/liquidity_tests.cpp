@@ -1,8 +1,11 @@
 #include <chainparams.h>
+#include <dfi/accountshistory.h>
 #include <dfi/govvariables/attributes.h>
 #include <dfi/masternodes.h>
 #include <dfi/mn_checks.h>
 #include <dfi/poolpairs.h>
+#include <dfi/threadpool.h>
+#include <dfi/validation.h>
 #include <validation.h>
 
 #include <test/setup_common.h>
@@ -511,4 +514,231 @@ BOOST_AUTO_TEST_CASE(owner_rewards)
     });
 }
 
+BOOST_AUTO_TEST_CASE(owner_rewards_runs)
+{
+    CCustomCSView mnview(*pcustomcsview);
+
+    DCT_ID idA, idB, idPool;
+    std::tie(idA, idB, idPool) = CreatePoolNTokens(mnview, "RA", "RB");
+    const CScript owner(1), provider(2);
+    BOOST_REQUIRE(AddPoolLiquidity(mnview, idPool, 3 * COIN, 5 * COIN, owner));
+    BOOST_REQUIRE(AddPoolLiquidity(mnview, idPool, 7 * COIN, 11 * COIN, provider));
+
+    mnview.SetRewardPct(idPool, 1, COIN / 3);
+    mnview.SetDailyReward(10, 7 * COIN);
+    mnview.SetDailyReward(500, 3 * COIN);
+
+    for (const uint32_t height : {20, 21, 333}) {
+        auto pool = mnview.GetPoolPair(idPool);
+        BOOST_REQUIRE(pool);
+        pool->swapEvent = true;
+        pool->blockCommissionA = height * 1000;
+        pool->blockCommissionB = height * 3;
+        BOOST_REQUIRE(mnview.SetPoolPair(idPool, height, *pool));
+    }
+
+    // rewards paid block by block
+    CCustomCSView expected(mnview);
+    expected.CalculatePoolRewards(
+        idPool,
+        [&]() -> CAmount { return expected.GetBalance(owner, idPool).nValue; },
+        1,
+        1000,
+        [&](RewardType, CTokenAmount amount, uint32_t) { expected.AddBalance(owner, amount); });
+
+    // rewards paid per run of unchanged pool state
+    BOOST_CHECK(mnview.CalculateOwnerRewards(owner, 1000));
+
+    BOOST_CHECK(mnview.GetBalance(owner, DCT_ID{0}).nValue > 0);
+    for (const auto id : {DCT_ID{0}, idA, idB}) {
+        BOOST_CHECK_EQUAL(mnview.GetBalance(owner, id).nValue, expected.GetBalance(owner, id).nValue);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(consolidate_rewards_shards)
+{
+    if (!DfTxTaskPool) {
+        InitDfTxGlobalTaskPool();
+    }
+    CCustomCSView mnview(*pcustomcsview);
+
+    DCT_ID idA, idB, idPool;
+    std::tie(idA, idB, idPool) = CreatePoolNTokens(mnview, "CA", "CB");
+    std::unordered_set<CScript, CScriptHasher> owners;
+    for (int i = 1; i <= 50; ++i) {
+        const CScript owner(1000 + i);
+        BOOST_REQUIRE(AddPoolLiquidity(mnview, idPool, i * COIN, 2 * i * COIN, owner));
+        owners.insert(owner);
+    }
+
+    mnview.SetRewardPct(idPool, 1, COIN / 3);
+    mnview.SetDailyReward(10, 7 * COIN);
+    for (const uint32_t height : {20, 21, 333}) {
+        auto pool = mnview.GetPoolPair(idPool);
+        BOOST_REQUIRE(pool);
+        pool->swapEvent = true;
+        pool->blockCommissionA = height * 1000;
+        pool->blockCommissionB = height * 3;
+        BOOST_REQUIRE(mnview.SetPoolPair(idPool, height, *pool));
+    }
+
+    CAccountHistoryStorage serialHistory(GetDataDir() / "consolidate_serial", 1 << 20, true, true);
+    CAccountHistoryStorage shardedHistory(GetDataDir() / "consolidate_sharded", 1 << 20, true, true);
+    serialHistory.InitPoolRewardHistory(true, 1);
+    shardedHistory.InitPoolRewardHistory(true, 1);
+
+    CCustomCSView serial(mnview, &serialHistory, nullptr, nullptr);
+    for (const auto &owner : owners) {
+        BOOST_REQUIRE(serial.CalculateOwnerRewards(owner, 1000));
+    }
+    serial.GetHistoryWriters().FlushPoolRewards();
+
+    CCustomCSView sharded(mnview, &shardedHistory, nullptr, nullptr);
+    ConsolidateRewards(sharded, 1000, owners, false, 3);
+    sharded.GetHistoryWriters().FlushPoolRewards();
+
+    // same balances as settling the owners one by one
+    for (const auto &owner : owners) {
+        BOOST_CHECK(sharded.GetBalance(owner, DCT_ID{0}).nValue > 0);
+        for (const auto id : {DCT_ID{0}, idA, idB, idPool}) {
+            BOOST_CHECK_EQUAL(sharded.GetBalance(owner, id).nValue, serial.GetBalance(owner, id).nValue);
+        }
+        BOOST_CHECK_EQUAL(sharded.GetBalancesHeight(owner), serial.GetBalancesHeight(owner));
+    }
+
+    // and the same reward history
+    auto history = [](CAccountHistoryStorage &storage) {
+        std::map<TBytes, TBytes> result;
+        storage.ForEachPoolRewardHistory(
+            [&](const PoolRewardHistoryKey &key, CLazySerialize<PoolRewardHistoryValue> value) {
+                result.emplace(DbTypeToBytes(key), DbTypeToBytes(value.get()));
+                return true;
+            },
+            {CScript{}, ~0u, DCT_ID{0}});
+        return result;
+    };
+    BOOST_CHECK_EQUAL(history(shardedHistory).size(), owners.size());
+    BOOST_CHECK(history(shardedHistory) == history(serialHistory));
+
+    const auto stats = GetRewardConsolidationStats();
+    BOOST_CHECK(!stats.running);
+    BOOST_CHECK_EQUAL(stats.height, 1000);
+    BOOST_CHECK_EQUAL(stats.owners, owners.size());
+    BOOST_CHECK_EQUAL(stats.completed, owners.size());
+    BOOST_CHECK_EQUAL(stats.shards, 12U);
+}
+
+BOOST_AUTO_TEST_CASE(composite_swap_paths)
+{
+    CCustomCSView mnview(*pcustomcsview);
+    const auto &consensus = Params().GetConsensus();
+    const auto height = static_cast<uint32_t>(consensus.DF20GrandCentralHeight);
+
+    const auto idA = CreateToken(mnview, "PA");
+    const auto idB = CreateToken(mnview, "PB");
+    const auto idC = CreateToken(mnview, "PC");
+    const auto idD = CreateToken(mnview, "PD");
+
+    const CScript provider = CScript(11);
+    auto createPool = [&](DCT_ID tokenA, DCT_ID tokenB, CAmount amountA, CAmount amountB) {
+        const auto idPool = CreateToken(mnview, "P" + tokenA.ToString() + "-" + tokenB.ToString(), (uint8_t)CToken::TokenFlags::Default | (uint8_t)CToken::TokenFlags::DAT | (uint8_t)CToken::TokenFlags::LPS);
+        CPoolPair pool{};
+        pool.idTokenA = tokenA;
+        pool.idTokenB = tokenB;
+        pool.commission = 1000000;
+        pool.status = true;
+        BOOST_REQUIRE(mnview.SetPoolPair(idPool, 1, pool));
+        BOOST_REQUIRE(AddPoolLiquidity(mnview, idPool, amountA, amountB, provider));
+        return idPool;
+    };
+
+    const auto poolAB = createPool(idA, idB, 1000 * COIN, 1000 * COIN);
+    const auto poolBC = createPool(idB, idC, 1000 * COIN, 2000 * COIN);
+    const auto poolCD = createPool(idC, idD, 1000 * COIN, 1000 * COIN);
+    const auto poolAC = createPool(idA, idC, 1000 * COIN, 1000 * COIN);
+    const auto poolBD = createPool(idB, idD, 1000 * COIN, 1000 * COIN);
+
+    const auto fromPools = mnview.GetPoolPairsByToken(idA);
+    BOOST_REQUIRE_EQUAL(fromPools.size(), 2);
+    BOOST_CHECK(fromPools.at(idB) == poolAB);
+    BOOST_CHECK(fromPools.at(idC) == poolAC);
+
+    CPoolSwapMessage obj;
+    obj.from = CScript(12);
+    obj.to = obj.from;
+    obj.idTokenFrom = idA;
+    obj.idTokenTo = idD;
+    obj.amountFrom = 10 * COIN;
+    obj.maxPrice = PoolPrice::getMaxValid();
+
+    // Paths are listed direct first, then over common tokens, then over bridging pools in pool ID order
+    CPoolSwap poolSwap(obj, height);
+    const std::vector<std::vector<DCT_ID>> expectedPaths{
+        {poolAB, poolBD},
+        {poolAC, poolCD},
+        {poolAB, poolBC, poolCD},
+        {poolAC, poolBC, poolBD},
+    };
+    BOOST_CHECK(poolSwap.CalculatePoolPaths(mnview) == expectedPaths);
+
+    // Best path picked by scoring matches the best simulated swap
+    std::vector<DCT_ID> bestPath;
+    CAmount bestResult{-1};
+    for (const auto &path : expectedPaths) {
+        CPoolSwap simulated(obj, height);
+        CCustomCSView dummy(mnview);
+        BOOST_REQUIRE(simulated.ExecuteSwap(dummy, path, consensus, true));
+        if (simulated.GetResult().nValue > bestResult) {
+            bestPath = path;
+            bestResult = simulated.GetResult().nValue;
+        }
+    }
+    BOOST_CHECK(bestPath == expectedPaths[2]);
+    BOOST_CHECK(CPoolSwap(obj, height).CalculateSwaps(mnview, consensus, true) == bestPath);
+
+    // Executing without funds falls back to simulating each path for its errors
+    CPoolSwap unfunded(obj, height);
+    BOOST_CHECK(unfunded.CalculateSwaps(mnview, consensus).empty());
+    BOOST_CHECK_EQUAL(unfunded.errors.size(), expectedPaths.size());
+
+    BOOST_REQUIRE(mnview.AddBalance(obj.from, {idA, obj.amountFrom}));
+    CPoolSwap funded(obj, height);
+    BOOST_CHECK(funded.CalculateSwaps(mnview, consensus) == bestPath);
+    BOOST_CHECK(funded.errors.empty());
+    BOOST_CHECK_EQUAL(mnview.GetBalance(obj.from, idA).nValue, obj.amountFrom);
+}
+
+BOOST_AUTO_TEST_CASE(composite_swap_bridge_order)
+{
+    CCustomCSView mnview(*pcustomcsview);
+    const DCT_ID idE{60001}, idF{60002}, idX1{60003}, idX2{60004}, idY{60005};
+
+    auto createPool = [&](DCT_ID idPool, DCT_ID tokenA, DCT_ID tokenB) {
+        CPoolPair pool{};
+        pool.idTokenA = tokenA;
+        pool.idTokenB = tokenB;
+        pool.status = true;
+        BOOST_REQUIRE(mnview.SetPoolPair(idPool, 1, pool));
+        return idPool;
+    };
+    const auto poolEX1 = createPool(DCT_ID{70001}, idE, idX1);
+    const auto poolEX2 = createPool(DCT_ID{70002}, idE, idX2);
+    const auto poolYF = createPool(DCT_ID{70003}, idY, idF);
+    // VARINT(300) is 0x81 0x2c and VARINT(16512) is 0x80 0x80 0x00
+    const auto bridge1 = createPool(DCT_ID{300}, idX1, idY);
+    const auto bridge2 = createPool(DCT_ID{16512}, idX2, idY);
+    BOOST_CHECK(DbTypeToBytes(bridge2) < DbTypeToBytes(bridge1));
+
+    CPoolSwapMessage obj;
+    obj.idTokenFrom = idE;
+    obj.idTokenTo = idF;
+
+    // Bridges are listed in pool ID key order, as a scan over all pools lists them
+    const std::vector<std::vector<DCT_ID>> expectedPaths{
+        {poolEX2, bridge2, poolYF},
+        {poolEX1, bridge1, poolYF},
+    };
+    BOOST_CHECK(CPoolSwap(obj, 1).CalculatePoolPaths(mnview) == expectedPaths);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
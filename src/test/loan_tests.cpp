@@ -1,7 +1,10 @@
 #include <chainparams.h>
+#include <dfi/accountshistory.h>
 #include <dfi/loan.h>
 #include <dfi/masternodes.h>
 #include <dfi/mn_checks.h>
+#include <dfi/validation.h>
+#include <validation.h>
 
 #include <test/setup_common.h>
 #include <boost/test/unit_test.hpp>
@@ -381,6 +384,101 @@ BOOST_AUTO_TEST_CASE(loan_total_interest_calculation)
     BOOST_CHECK_EQUAL(totalInterest.amount.GetLow64(), 4 * rate->interestPerBlock.amount.GetLow64());
 }
 
+BOOST_AUTO_TEST_CASE(loan_interest_tally)
+{
+    // Activate negative interest rate
+    const_cast<int&>(Params().GetConsensus().DF18FortCanningGreatWorldHeight) = 1;
+
+    CCustomCSView mnview(*pcustomcsview);
+
+    const std::string scheme_id("sch1");
+    CreateScheme(mnview, scheme_id, 150, 1 * COIN);
+
+    const CAmount tokenInterest = 5 * COIN;
+    const auto token_id = CreateLoanToken(mnview, "TST", "TEST", "", tokenInterest);
+    const auto other_id = CreateLoanToken(mnview, "OTH", "OTHER", "", tokenInterest);
+
+    const auto vault_a = NextTx();
+    const auto vault_b = NextTx();
+
+    // Vault interest stored before the tally is built is picked up by the build
+    BOOST_REQUIRE(mnview.AddLoanToken(vault_a, {token_id, 10 * COIN}));
+    BOOST_REQUIRE(mnview.IncreaseInterest(1, vault_a, scheme_id, token_id, tokenInterest, 0));
+    BOOST_CHECK(!mnview.IsLoanInterestTallyReady());
+
+    mnview.BuildLoanInterestTally();
+    BOOST_CHECK(mnview.IsLoanInterestTallyReady());
+
+    const auto checkTally = [&](const uint32_t height) {
+        std::map<DCT_ID, std::pair<CInterestAmount, CInterestAmount>> scanned;
+        std::map<DCT_ID, std::set<CVaultId>> negatives;
+        mnview.ForEachVaultInterestV3([&](const CVaultId &vaultId, DCT_ID id, const CInterestRateV3 &rate) {
+            auto &[interest, perBlock] = scanned[id];
+            interest = InterestAddition(interest, TotalInterestCalculation(rate, height));
+            perBlock = InterestAddition(perBlock, rate.interestPerBlock);
+            if (rate.interestPerBlock.negative || rate.interestToHeight.negative) {
+                negatives[id].insert(vaultId);
+            }
+            return true;
+        });
+
+        for (const auto &id : {token_id, other_id}) {
+            const auto &[interest, perBlock] = scanned[id];
+            const auto tally = mnview.GetLoanInterestTally(id).value_or(CInterestRateV3{});
+            const auto tallyInterest = TotalInterestCalculation(tally, height);
+            BOOST_CHECK_EQUAL(tallyInterest.negative, interest.negative);
+            BOOST_CHECK(tallyInterest.amount == interest.amount);
+            BOOST_CHECK_EQUAL(tally.interestPerBlock.negative, perBlock.negative);
+            BOOST_CHECK(tally.interestPerBlock.amount == perBlock.amount);
+
+            std::set<CVaultId> indexed;
+            mnview.ForEachNegativeInterestVault([&](const CVaultId &vaultId) {
+                indexed.insert(vaultId);
+                return true;
+            }, id);
+            BOOST_CHECK(indexed == negatives[id]);
+        }
+    };
+
+    checkTally(1);
+    checkTally(10);
+
+    BOOST_REQUIRE(mnview.AddLoanToken(vault_b, {token_id, 3 * COIN}));
+    BOOST_REQUIRE(mnview.IncreaseInterest(4, vault_b, scheme_id, token_id, tokenInterest, 0));
+    BOOST_REQUIRE(mnview.AddLoanToken(vault_b, {other_id, 7 * COIN}));
+    BOOST_REQUIRE(mnview.IncreaseInterest(5, vault_b, scheme_id, other_id, tokenInterest, 0));
+    checkTally(5);
+    checkTally(20);
+
+    // Payback part of the loan and interest
+    BOOST_REQUIRE(mnview.SubLoanToken(vault_a, {token_id, 4 * COIN}));
+    BOOST_REQUIRE(mnview.DecreaseInterest(8, vault_a, scheme_id, token_id, 4 * COIN, 1));
+    checkTally(8);
+
+    // Negative token interest flips the sign of the interest per block
+    BOOST_REQUIRE(mnview.IncreaseInterest(9, vault_b, scheme_id, token_id, -10 * COIN, 0));
+    checkTally(9);
+    checkTally(200);
+
+    BOOST_REQUIRE(mnview.IncreaseInterest(300, vault_b, scheme_id, token_id, -10 * COIN, 0));
+    checkTally(300);
+
+    // Closing a vault removes all of its interest
+    BOOST_REQUIRE(mnview.EraseInterest(vault_b, 301));
+    checkTally(301);
+    BOOST_CHECK(!mnview.GetLoanInterestTally(other_id));
+
+    // A rebuild arrives at the same tally
+    const auto tally = mnview.GetLoanInterestTally(token_id);
+    BOOST_REQUIRE(tally);
+    mnview.BuildLoanInterestTally();
+    const auto rebuilt = mnview.GetLoanInterestTally(token_id);
+    BOOST_REQUIRE(rebuilt);
+    BOOST_CHECK(TotalInterestCalculation(*tally, 400).amount == TotalInterestCalculation(*rebuilt, 400).amount);
+    BOOST_CHECK(tally->interestPerBlock.amount == rebuilt->interestPerBlock.amount);
+    checkTally(400);
+}
+
 BOOST_AUTO_TEST_CASE(collateralization_ratio)
 {
     CCustomCSView mnview(*pcustomcsview);
@@ -463,6 +561,16 @@ BOOST_AUTO_TEST_CASE(collateralization_ratio)
     auto colls = mnview.GetVaultAssets(vault_id, *collaterals, 10, 0);
     BOOST_REQUIRE(colls.ok);
     BOOST_CHECK_EQUAL(colls.val->ratio(), 78);
+
+    // same result with prices shared between vault checks
+    CVaultPriceCache priceCache;
+    for (int i = 0; i < 2; ++i) {
+        auto cached = mnview.GetVaultAssets(vault_id, *collaterals, 10, 0, false, true, &priceCache);
+        BOOST_REQUIRE(cached.ok);
+        BOOST_CHECK_EQUAL(cached.val->ratio(), 78);
+        BOOST_CHECK_EQUAL(cached.val->totalCollaterals, colls.val->totalCollaterals);
+        BOOST_CHECK_EQUAL(cached.val->totalLoans, colls.val->totalLoans);
+    }
 }
 
 BOOST_AUTO_TEST_CASE(auction_batch_creator)
@@ -529,4 +637,64 @@ BOOST_AUTO_TEST_CASE(auction_batch_creator)
     }
 }
 
+BOOST_AUTO_TEST_CASE(futures_settlement_batch)
+{
+    const auto tip = WITH_LOCK(cs_main, return ::ChainActive().Tip());
+    const CScript contract = CScript(100), owner1 = CScript(101), owner2 = CScript(102), owner3 = CScript(103);
+    const CTokenAmount payment{DCT_ID{1}, 5 * COIN};
+    const CTokenAmount refund{DCT_ID{0}, 6 * COIN};
+
+    CAccountHistoryStorage unbatchedHistory(GetDataDir() / "futures_unbatched", 1 << 20, true, true);
+    CAccountHistoryStorage batchedHistory(GetDataDir() / "futures_batched", 1 << 20, true, true);
+    CCustomCSView unbatched(*pcustomcsview, &unbatchedHistory, nullptr, nullptr);
+    CCustomCSView batched(*pcustomcsview, &batchedHistory, nullptr, nullptr);
+
+    // the contract address covers only one of the two refunds
+    for (auto view : {&unbatched, &batched}) {
+        BOOST_REQUIRE(view->AddBalance(contract, {DCT_ID{0}, 10 * COIN}));
+    }
+
+    // settlement as done before batching, a history writer view per entry
+    const auto unbatchedEntry = [&](CustomTxType type, const std::function<void(CCustomCSView &)> &apply) {
+        CAccountsHistoryWriter view(unbatched, tip->nHeight, GetNextAccPosition(), tip->GetBlockHash(), uint8_t(type));
+        apply(view);
+        view.Flush();
+    };
+    unbatchedEntry(CustomTxType::FutureSwapExecution, [&](CCustomCSView &view) { view.AddBalance(owner3, payment); });
+    for (const auto &owner : {owner1, owner2}) {
+        unbatchedEntry(CustomTxType::FutureSwapRefund, [&](CCustomCSView &view) { view.SubBalance(contract, refund); });
+        unbatchedEntry(CustomTxType::FutureSwapRefund, [&](CCustomCSView &view) { view.AddBalance(owner, refund); });
+    }
+
+    CFuturesSettlementBatch batch(batched, tip);
+    batch.NewEntry(CustomTxType::FutureSwapExecution);
+    batch.AddBalance(owner3, payment);
+    for (const auto &owner : {owner1, owner2}) {
+        batch.NewEntry(CustomTxType::FutureSwapRefund);
+        BOOST_CHECK_EQUAL(batch.SubBalance(contract, refund).ok, owner == owner1);
+        batch.NewEntry(CustomTxType::FutureSwapRefund);
+        batch.AddBalance(owner, refund);
+    }
+    batch.Apply();
+
+    for (const auto &owner : {contract, owner1, owner2, owner3}) {
+        for (const auto id : {DCT_ID{0}, DCT_ID{1}}) {
+            BOOST_CHECK_EQUAL(batched.GetBalance(owner, id).nValue, unbatched.GetBalance(owner, id).nValue);
+        }
+    }
+    BOOST_CHECK_EQUAL(batched.GetBalance(contract, DCT_ID{0}).nValue, 4 * COIN);
+
+    // the same history entries in the same order, apart from account positions
+    auto history = [](CAccountHistoryStorage &storage) {
+        std::vector<std::pair<TBytes, TBytes>> result;
+        storage.ForEachAccountHistory([&](const AccountHistoryKey &key, AccountHistoryValue value) {
+            result.emplace_back(DbTypeToBytes(std::make_pair(key.owner, key.blockHeight)), DbTypeToBytes(value));
+            return true;
+        });
+        return result;
+    };
+    BOOST_CHECK_EQUAL(history(batchedHistory).size(), 4U);
+    BOOST_CHECK(history(batchedHistory) == history(unbatchedHistory));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
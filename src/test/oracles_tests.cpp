@@ -9,6 +9,7 @@
 #include <dfi/oracles.h>
 #include <rpc/rawtransaction_util.h>
 #include <dfi/masternodes.h>
+#include <dfi/mn_checks.h>
 
 #include <string>
 
@@ -129,4 +130,36 @@ BOOST_FIXTURE_TEST_SUITE(oracles_tests, OraclesTestingSetup)
         BOOST_ASSERT_MSG(dataRes.ok, dataRes.msg.c_str());
     }
 
+    BOOST_AUTO_TEST_CASE(aggregate_prices_test) {
+        CCustomCSView mnview(*pcustomcsview);
+        const int64_t time = 1000000;
+
+        std::vector<unsigned char> tmp{'a', 'b', 'c'};
+        CScript oracleAddress{tmp.begin(), tmp.end()};
+        COracle oracle1, oracle2;
+        static_cast<CAppointOracleMessage&>(oracle1) = {oracleAddress, 1, {{"DFI", "USD"}, {"TOK", "USD"}}};
+        static_cast<CAppointOracleMessage&>(oracle2) = {oracleAddress, 3, {{"DFI", "USD"}, {"BTC", "EUR"}}};
+
+        COracleId oracleId1{rawVector1}, oracleId2{rawVector2};
+        BOOST_REQUIRE(mnview.AppointOracle(oracleId1, oracle1));
+        BOOST_REQUIRE(mnview.AppointOracle(oracleId2, oracle2));
+        BOOST_REQUIRE(mnview.SetOracleData(oracleId1, time, {{"DFI", {{"USD", 2 * COIN}}}, {"TOK", {{"USD", 5 * COIN}}}}));
+        BOOST_REQUIRE(mnview.SetOracleData(oracleId2, time, {{"DFI", {{"USD", 4 * COIN}}}}));
+        BOOST_REQUIRE(mnview.SetOracleData(oracleId2, time - 7200, {{"BTC", {{"EUR", 9 * COIN}}}}));
+
+        const auto prices = GetAggregatePrices(mnview, time);
+        BOOST_CHECK_EQUAL(prices.size(), 3U);
+        for (const auto &[token, currency] : std::vector<CTokenCurrencyPair>{
+                 {"DFI", "USD"}, {"TOK", "USD"}, {"BTC", "EUR"}, {"DUSD", "USD"}, {"ETH", "USD"}}) {
+            const auto expected = GetAggregatePrice(mnview, token, currency, time);
+            const auto aggregated = GetAggregatePrice(prices, token, currency);
+            BOOST_CHECK_EQUAL(aggregated.ok, expected.ok);
+            BOOST_CHECK_EQUAL(aggregated.msg, expected.msg);
+            if (expected) {
+                BOOST_CHECK_EQUAL(*aggregated.val, *expected.val);
+            }
+        }
+        BOOST_CHECK_EQUAL(*GetAggregatePrice(prices, "DFI", "USD").val, (2 * COIN + 4 * COIN * 3) / 4);
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
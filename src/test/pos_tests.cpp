@@ -70,6 +70,39 @@ BOOST_AUTO_TEST_CASE(calc_kernel)
 //    BOOST_CHECK(pos::ComputeStakeModifier(prevStakeModifier, keyID) == targetStakeModifier);
 }
 
+BOOST_AUTO_TEST_CASE(search_kernel)
+{
+    uint256 stakeModifier = uint256S("1234567890abcdef1234567890abcdef1234567890abcdef1234567890abcdef");
+    uint256 mnID = uint256S("fedcba0987654321fedcba0987654321fedcba0987654321fedcba0987654321");
+    const auto& params = Params().GetConsensus();
+    const int64_t coinstakeTime = 10000000;
+
+    std::vector<pos::KernelCandidate> candidates;
+    for (uint8_t subNode = 0; subNode < 4; ++subNode) {
+        for (int64_t t = 0; t < 37; ++t) {
+            candidates.push_back({coinstakeTime + t, subNode, coinstakeTime - t * 3600});
+        }
+    }
+
+    // Batched search finds the same first kernel as checking candidates one by one
+    for (const uint64_t blockHeight : {uint64_t{0}, static_cast<uint64_t>(params.DF10EunosPayaHeight)}) {
+        for (const uint32_t target : {0x1effffffu, 0x1d00ffffu, 0x1c00ffffu, 0x1b00ffffu, 0x00ffffffu}) {
+            for (size_t first = 0; first < candidates.size(); first += 5) {
+                const std::vector<pos::KernelCandidate> search(candidates.begin() + first, candidates.end());
+
+                std::optional<size_t> expected;
+                for (size_t i = 0; i < search.size() && !expected; ++i) {
+                    if (pos::CheckKernelHash(stakeModifier, target, 1, search[i].coinstakeTime, blockHeight, mnID, params,
+                                             search[i].subNodeBlockTime, CheckContextState{search[i].subNode})) {
+                        expected = i;
+                    }
+                }
+                BOOST_CHECK(pos::SearchKernelHash(stakeModifier, target, 1, blockHeight, mnID, params, search) == expected);
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(check_stake_modifier)
 {
     uint256 masternodeID = testMasternodeKeys.begin()->first;
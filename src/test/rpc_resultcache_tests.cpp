@@ -0,0 +1,128 @@
+#include <dfi/masternodes.h>
+#include <rpc/resultcache.h>
+#include <test/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <univalue.h>
+
+static JSONRPCRequest CacheRequest(const std::string &method, int param = 0)
+{
+    JSONRPCRequest request;
+    request.strMethod = method;
+    request.params = UniValue(UniValue::VARR);
+    request.params.push_back(param);
+    return request;
+}
+
+static RPCResultCache::Prefixes CachePrefixes(std::initializer_list<uint8_t> prefixes)
+{
+    RPCResultCache::Prefixes result;
+    for (const auto prefix : prefixes) {
+        result.set(prefix);
+    }
+    return result;
+}
+
+// Runs a cached call reading the given key of the view
+static void CacheCall(const JSONRPCRequest &request, uint8_t prefix, const std::string &value)
+{
+    auto &cache = GetRPCResultCache();
+    RPCResultCache::ReadScope scope(request.strMethod);
+    CCustomCSView view(*pcustomcsview);
+    cache.TrackSnapshot(view, cache.GetGeneration());
+    std::string read;
+    view.Read(std::make_pair(prefix, std::string{"key"}), read);
+    cache.Set(request, UniValue(value));
+}
+
+BOOST_FIXTURE_TEST_SUITE(rpc_resultcache_tests, TestingSetup)
+
+BOOST_AUTO_TEST_CASE(rpc_resultcache_dependencies)
+{
+    auto &cache = GetRPCResultCache();
+    cache.Init(RPCResultCache::Smart);
+
+    const auto tracked = CacheRequest("listpoolpairs");
+    const auto untracked = CacheRequest("listtokens");
+    CacheCall(tracked, 'i', "pools");
+    CacheCall(untracked, 'i', "tokens");
+
+    const auto before = cache.GetStats();
+    BOOST_CHECK(cache.TryGet(tracked));
+    BOOST_CHECK(cache.TryGet(untracked));
+
+    // Block changes elsewhere only drop results that could not track their reads
+    cache.InvalidateCaches(CachePrefixes({'a', 'b'}));
+    BOOST_REQUIRE(cache.TryGet(tracked));
+    BOOST_CHECK_EQUAL(cache.TryGet(tracked)->get_str(), "pools");
+    BOOST_CHECK(!cache.TryGet(untracked));
+
+    // Changes to a prefix read drop the result
+    cache.InvalidateCaches(CachePrefixes({'i'}));
+    BOOST_CHECK(!cache.TryGet(tracked));
+
+    // Unknown change sets drop everything
+    CacheCall(tracked, 'i', "pools");
+    cache.InvalidateCaches();
+    BOOST_CHECK(!cache.TryGet(tracked));
+
+    const auto after = cache.GetStats();
+    BOOST_CHECK_EQUAL(after.hits - before.hits, 4);
+    BOOST_CHECK_EQUAL(after.misses - before.misses, 3);
+    BOOST_CHECK_EQUAL(after.invalidations - before.invalidations, 3);
+    BOOST_CHECK_EQUAL(after.entries, 0);
+    BOOST_CHECK_EQUAL(after.memoryUsage, 0);
+
+    // Outside of Smart mode every block drops everything
+    cache.Init(RPCResultCache::All);
+    CacheCall(tracked, 'i', "pools");
+    cache.InvalidateCaches(CachePrefixes({'a'}));
+    BOOST_CHECK(!cache.TryGet(tracked));
+
+    cache.Init(RPCResultCache::None);
+}
+
+BOOST_AUTO_TEST_CASE(rpc_resultcache_stale_snapshot)
+{
+    auto &cache = GetRPCResultCache();
+    cache.Init(RPCResultCache::Smart);
+
+    // A result computed on a snapshot taken before a block change is not cached
+    const auto request = CacheRequest("listpoolpairs");
+    {
+        RPCResultCache::ReadScope scope(request.strMethod);
+        CCustomCSView view(*pcustomcsview);
+        cache.TrackSnapshot(view, cache.GetGeneration());
+        cache.InvalidateCaches(CachePrefixes({'a'}));
+        cache.Set(request, UniValue("stale"));
+    }
+    BOOST_CHECK(!cache.TryGet(request));
+
+    cache.Init(RPCResultCache::None);
+}
+
+BOOST_AUTO_TEST_CASE(rpc_resultcache_budget)
+{
+    auto &cache = GetRPCResultCache();
+    cache.Init(RPCResultCache::Smart, 4096);
+
+    const auto before = cache.GetStats();
+    const std::string value(512, 'x');
+    for (int i = 0; i < 16; ++i) {
+        CacheCall(CacheRequest("listpoolpairs", i), 'i', value);
+        // Keep the first result recently used
+        BOOST_CHECK(cache.TryGet(CacheRequest("listpoolpairs", 0)));
+    }
+
+    const auto after = cache.GetStats();
+    BOOST_CHECK_LE(after.memoryUsage, 4096);
+    BOOST_CHECK_GT(after.evictions - before.evictions, 0);
+    BOOST_CHECK(!cache.TryGet(CacheRequest("listpoolpairs", 1)));
+    BOOST_CHECK(cache.TryGet(CacheRequest("listpoolpairs", 15)));
+
+    cache.InvalidateCaches();
+    cache.Init(RPCResultCache::None);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
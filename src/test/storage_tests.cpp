@@ -3,8 +3,14 @@
 
 #include <interfaces/chain.h>
 #include <key_io.h>
+#include <dfi/accountshistory.h>
+#include <dfi/govvariables/attributes.h>
+#include <dfi/historywriter.h>
 #include <dfi/masternodes.h>
 #include <dfi/mn_checks.h>
+#include <dfi/parallelscan.h>
+#include <dfi/snapshotmanager.h>
+#include <dfi/vaulthistory.h>
 #include <rpc/rawtransaction_util.h>
 #include <test/setup_common.h>
 
@@ -63,7 +69,8 @@ std::map<TBytes, TBytes> TakeSnapshot(CStorageKV const & storage)
     TBytes key;
     auto it = const_cast<CStorageKV&>(storage).NewIterator();
     for(it->Seek(key); it->Valid(); it->Next()) {
-        result.emplace(it->Key(),it->Value());
+        auto k = it->Key(), v = it->Value();
+        result.emplace(TBytes(k.begin(), k.end()), TBytes(v.begin(), v.end()));
     }
     return result;
 }
@@ -122,6 +129,480 @@ BOOST_AUTO_TEST_CASE(undo)
     BOOST_CHECK(snapStart == TakeSnapshot(base_raw));
 }
 
+BOOST_AUTO_TEST_CASE(undoCompactFormat)
+{
+    CUndo undo;
+    undo.before[ToBytes("balancekey1")] = TBytes{0x10, 0x27, 0, 0, 0, 0, 0, 0};                   // small amount
+    undo.before[ToBytes("balancekey2")] = TBytes{0xf0, 0xd8, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}; // negative amount
+    undo.before[ToBytes("balancekey3")] = TBytes{0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x7f}; // too large for a varint
+    undo.before[ToBytes("balance")] = {};
+    undo.before[ToBytes("other")] = ToBytes("value");
+    undo.before[TBytes{}] = TBytes{};
+
+    CDataStream compact(SER_DISK, CLIENT_VERSION);
+    compact << undo;
+    CDataStream legacy(SER_DISK, CLIENT_VERSION);
+    legacy << undo.before;
+    BOOST_CHECK_LT(compact.size(), legacy.size());
+
+    // Both formats read back the same records
+    CUndo fromCompact, fromLegacy;
+    compact >> fromCompact;
+    legacy >> fromLegacy;
+    BOOST_CHECK(fromCompact.before == undo.before);
+    BOOST_CHECK(fromLegacy.before == undo.before);
+    BOOST_CHECK(compact.empty());
+    BOOST_CHECK(legacy.empty());
+
+    // Records are pruned oldest first, a batch at a time
+    CCustomCSView mnview(*pcustomcsview);
+    for (uint32_t height = 1; height <= 10; ++height) {
+        mnview.SetUndo(UndoKey{height, uint256S("0x1")}, undo);
+        mnview.SetUndo(UndoKey{height, uint256S("0x2")}, undo);
+    }
+    BOOST_CHECK_EQUAL(mnview.PruneUndos(5, 3), 3U);
+    BOOST_CHECK(!mnview.GetUndo(UndoKey{2, uint256S("0x1")}));
+    BOOST_CHECK(mnview.GetUndo(UndoKey{2, uint256S("0x2")}));
+    BOOST_CHECK_EQUAL(mnview.PruneUndos(5, 100), 5U);
+    BOOST_CHECK_EQUAL(mnview.PruneUndos(5, 100), 0U);
+    BOOST_CHECK(mnview.GetUndo(UndoKey{5, uint256S("0x1")})->before == undo.before);
+
+    // Merkle roots hash the legacy encoding of undo records
+    const UndoKey undoKey{1, uint256S("0x3")};
+    CCustomCSView compactView(*pcustomcsview), legacyView(*pcustomcsview);
+    compactView.SetUndo(undoKey, undo);
+    legacyView.GetStorage().Write(DbTypeToBytes(std::make_pair(CUndosView::ByUndoKey::prefix(), undoKey)),
+                                  DbTypeToBytes(undo.before));
+    BOOST_CHECK(compactView.GetStorage().GetRaw() != legacyView.GetStorage().GetRaw());
+    BOOST_CHECK_EQUAL(compactView.MerkleRoot(), legacyView.MerkleRoot());
+}
+
+BOOST_AUTO_TEST_CASE(snapshotFrozenLayer)
+{
+    pcustomcsview->Write("frozenkey1", "value1");
+    pcustomcsview->Write("frozenkey2", "value2");
+
+    auto [view1, history1, vault1] = GetSnapshots();
+    auto [view2, history2, vault2] = GetSnapshots();
+
+    // Both views share the pending changes of the same block
+    auto info = psnapshotManager->GetMemoryInfo();
+    BOOST_CHECK_EQUAL(info.checkedOut.at(SnapshotType::VIEW), 2);
+    BOOST_CHECK_EQUAL(info.layers, 1U);
+    BOOST_CHECK_GT(info.memoryUsage, 0U);
+
+    // Writes stay in the view they were made in
+    BOOST_CHECK(view1->Write("frozenkey1", "changed"));
+    BOOST_CHECK(view1->Erase("frozenkey2"));
+    pcustomcsview->Write("frozenkey3", "value3");
+
+    std::string value;
+    BOOST_CHECK(view1->Read("frozenkey1", value));
+    BOOST_CHECK_EQUAL(value, "changed");
+    BOOST_CHECK(!view1->Exists("frozenkey2"));
+    BOOST_CHECK(view2->Read("frozenkey1", value));
+    BOOST_CHECK_EQUAL(value, "value1");
+    BOOST_CHECK(view2->Read("frozenkey2", value));
+    BOOST_CHECK_EQUAL(value, "value2");
+    BOOST_CHECK(!view2->Exists("frozenkey3"));
+    BOOST_CHECK_THROW(view1->Flush(), std::runtime_error);
+
+    view1.reset();
+    view2.reset();
+    history1.reset();
+    history2.reset();
+    vault1.reset();
+    vault2.reset();
+    info = psnapshotManager->GetMemoryInfo();
+    BOOST_CHECK_EQUAL(info.checkedOut.at(SnapshotType::VIEW), 0);
+    BOOST_CHECK_EQUAL(info.checkedOut.at(SnapshotType::HISTORY), 0);
+
+    pcustomcsview->Erase("frozenkey1");
+    pcustomcsview->Erase("frozenkey2");
+    pcustomcsview->Erase("frozenkey3");
+}
+
+BOOST_AUTO_TEST_CASE(flushableMerge)
+{
+    const std::string key1{"mergekey1"}, key2{"mergekey2"}, key3{"mergekey3"}, key4{"mergekey4"};
+    const std::string value0{"value0"}, value1{"value1"}, value2{"value2"};
+
+    pcustomcsview->Write(key1, value0);
+    pcustomcsview->Write(key2, value0);
+
+    CCustomCSView blockview(*pcustomcsview);
+    BOOST_CHECK(blockview.Write(key1, value1));
+    BOOST_CHECK(blockview.Write(key3, value1));
+    {
+        CCustomCSView txview(blockview);
+        BOOST_CHECK(txview.Write(key1, value2)); // overwrite pending change
+        BOOST_CHECK(txview.Erase(key2));         // erase parent record
+        BOOST_CHECK(txview.Erase(key3));         // erase pending change
+        BOOST_CHECK(txview.Write(key4, value2)); // insert
+        BOOST_CHECK(txview.Flush());
+        BOOST_CHECK(txview.GetStorage().GetRaw().empty());
+    }
+
+    std::string value;
+    BOOST_CHECK(blockview.Read(key1, value) && value == value2);
+    BOOST_CHECK(!blockview.Read(key2, value));
+    BOOST_CHECK(!blockview.Read(key3, value));
+    BOOST_CHECK(blockview.Read(key4, value) && value == value2);
+    BOOST_CHECK_EQUAL(blockview.GetStorage().GetRaw().size(), 4U);
+
+    BOOST_CHECK(blockview.Flush());
+    BOOST_CHECK(pcustomcsview->Read(key1, value) && value == value2);
+    BOOST_CHECK(!pcustomcsview->Read(key2, value));
+    BOOST_CHECK(!pcustomcsview->Read(key3, value));
+    BOOST_CHECK(pcustomcsview->Read(key4, value) && value == value2);
+}
+
+BOOST_AUTO_TEST_CASE(mergeIteratorOrder)
+{
+    const std::string key1{"orderkey1"}, key2{"orderkey2"}, key3{"orderkey3"}, key5{"orderkey5"};
+    const std::string value0{"value0"}, value1{"value1"};
+    const auto first = DbTypeToBytes(key1), last = DbTypeToBytes(key5);
+
+    pcustomcsview->Write(key1, value0);
+    pcustomcsview->Write(key3, value0);
+    pcustomcsview->Write(key5, value0);
+
+    CCustomCSView view(*pcustomcsview);
+    BOOST_CHECK(view.Write(key2, value1)); // between parent records
+    BOOST_CHECK(view.Write(key3, value1)); // shadows parent record
+    BOOST_CHECK(view.Erase(key5));         // hides parent record
+
+    const std::vector<std::pair<std::string, std::string>> expected{{key1, value0}, {key2, value1}, {key3, value1}};
+    auto check = [](CStorageKVIterator& it, const std::pair<std::string, std::string>& entry) {
+        BOOST_REQUIRE(it.Valid());
+        std::string key, value;
+        BOOST_CHECK(BytesToDbType(it.Key(), key) && key == entry.first);
+        BOOST_CHECK(BytesToDbType(it.Value(), value) && value == entry.second);
+    };
+
+    auto it = view.GetStorage().NewIterator();
+    it->Seek(first);
+    for (const auto& entry : expected) {
+        check(*it, entry);
+        it->Next();
+    }
+    BOOST_CHECK(!it->Valid() || it->Key() > MakeSpan(last));
+
+    it->Seek(DbTypeToBytes(key3));
+    for (auto entry = expected.rbegin(); entry != expected.rend(); ++entry) {
+        check(*it, *entry);
+        it->Prev();
+    }
+    BOOST_CHECK(!it->Valid() || it->Key() < MakeSpan(first));
+}
+
+BOOST_AUTO_TEST_CASE(trackReads)
+{
+    const std::string key1{"readkey1"}, key2{"readkey2"}, key3{"readkey3"}, key5{"readkey5"}, key9{"readkey9"};
+    const std::string value{"value"};
+    pcustomcsview->Write(key1, value);
+    pcustomcsview->Write(key3, value);
+    pcustomcsview->Write(key5, value);
+
+    CStorageReadSet reads;
+    CCustomCSView view(*pcustomcsview);
+    view.GetStorage().TrackReads(&reads);
+
+    std::string read;
+    BOOST_CHECK(view.Write(key2, value));
+    BOOST_CHECK(view.Read(key2, read)); // own write, no dependency
+    BOOST_CHECK(view.Read(key1, read));
+    BOOST_CHECK(!view.Exists(key9));
+    {
+        // reads of nested views fall through the tracked layer
+        CCustomCSView nested(view);
+        auto it = nested.GetStorage().NewIterator();
+        it->Seek(DbTypeToBytes(key2));
+        BOOST_CHECK(it->Valid());
+        it->Next();
+        BOOST_CHECK(it->Valid());
+    }
+    view.GetStorage().TrackReads(nullptr);
+
+    auto changed = [](std::initializer_list<std::string> keys) {
+        std::set<TBytes> result;
+        for (const auto &key : keys) {
+            result.insert(DbTypeToBytes(key));
+        }
+        return result;
+    };
+    BOOST_CHECK_EQUAL(reads.keys.size(), 2U);
+    BOOST_CHECK_EQUAL(reads.ranges.size(), 1U);
+    BOOST_CHECK(reads.Intersects(changed({"readkey1"})));
+    BOOST_CHECK(reads.Intersects(changed({"readkey9"})));
+    BOOST_CHECK(reads.Intersects(changed({"readkey3"})));  // walked by the iterator
+    BOOST_CHECK(!reads.Intersects(changed({"readkey5"}))); // past the iterator
+    BOOST_CHECK(!reads.Intersects(changed({"readkey0", "readkey4"})));
+}
+
+BOOST_AUTO_TEST_CASE(parallelScan)
+{
+    if (!DfTxTaskPool) {
+        InitDfTxGlobalTaskPool();
+    }
+
+    CCustomCSView view(*pcustomcsview);
+    std::vector<BalanceKey> expected;
+    for (int64_t i = 1; i <= 1000; ++i) {
+        const auto owner = CScript() << CScriptNum(i * 7919);
+        BOOST_CHECK(view.AddBalance(owner, {DCT_ID{0}, i}));
+    }
+    view.ForEachBalance([&](const CScript &owner, const CTokenAmount &balance) {
+        expected.push_back({owner, balance.nTokenId});
+        return true;
+    });
+    BOOST_REQUIRE_GE(expected.size(), 1000U);
+
+    BOOST_CHECK_EQUAL(view.SplitRange<CAccountsView::ByBalanceKey>(BalanceKey{}, 1).size(), 1U);
+
+    // Ranges start at existing keys and follow each other
+    const auto ranges = view.SplitRange<CAccountsView::ByBalanceKey>(BalanceKey{}, 8);
+    BOOST_CHECK_GT(ranges.size(), 1U);
+    BOOST_CHECK_LE(ranges.size(), 8U);
+    BOOST_CHECK(!ranges.back().end);
+    for (size_t i = 1; i < ranges.size(); ++i) {
+        BOOST_CHECK(ranges[i - 1].end == DbTypeToBytes(std::make_pair(CAccountsView::ByBalanceKey::prefix(), ranges[i].start)));
+    }
+
+    const auto scan = [&](size_t i, std::vector<BalanceKey> &keys, const std::atomic_bool &stop) {
+        view.ForEachBalance(
+            [&](const CScript &owner, const CTokenAmount &balance) {
+                if (stop || !ranges[i].Contains({owner, balance.nTokenId})) {
+                    return false;
+                }
+                keys.push_back({owner, balance.nTokenId});
+                return true;
+            },
+            ranges[i].start);
+    };
+
+    // Results are merged in key order
+    std::vector<BalanceKey> merged;
+    ParallelScan<std::vector<BalanceKey>>(ranges.size(), scan, [&](std::vector<BalanceKey> &keys) {
+        merged.insert(merged.end(), keys.begin(), keys.end());
+        return true;
+    });
+    BOOST_REQUIRE_EQUAL(merged.size(), expected.size());
+    for (size_t i = 0; i < merged.size(); ++i) {
+        BOOST_CHECK(merged[i].owner == expected[i].owner);
+    }
+
+    // Merging stops at the first range refused
+    size_t merges{};
+    ParallelScan<std::vector<BalanceKey>>(ranges.size(), scan, [&](std::vector<BalanceKey> &) {
+        return ++merges < 2;
+    });
+    BOOST_CHECK_EQUAL(merges, 2U);
+
+    // Errors of a scan are raised to the caller
+    BOOST_CHECK_THROW(ParallelScan<int>(
+                          4,
+                          [](size_t i, int &, const std::atomic_bool &) {
+                              if (i == 2) {
+                                  throw std::runtime_error("scan failed");
+                              }
+                          },
+                          [](int &) { return true; }),
+                      std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(tokenHoldersIndex)
+{
+    const CScript owner1 = CScript() << OP_1, owner2 = CScript() << OP_2, owner3 = CScript() << OP_3;
+    const DCT_ID token1{1}, token2{2};
+
+    auto holders = [](CCustomCSView &view, DCT_ID tokenID) {
+        std::vector<CScript> result;
+        view.ForEachTokenHolder(tokenID, [&](const CScript &owner, const CTokenAmount &balance) {
+            BOOST_CHECK(balance.nTokenId == tokenID && balance.nValue > 0);
+            result.push_back(owner);
+            return true;
+        });
+        return result;
+    };
+    auto applyChanges = [&](CCustomCSView &view) {
+        BOOST_CHECK(view.AddBalance(owner3, {token1, 5}));
+        BOOST_CHECK(view.AddBalance(owner2, {token1, 5}));
+        BOOST_CHECK(view.SubBalance(owner1, {token1, 10}));
+        BOOST_CHECK(view.AddBalance(owner1, {token2, 10}));
+    };
+
+    // balances present before the index is built
+    BOOST_CHECK(pcustomcsview->WriteBy<CAccountsView::ByBalanceKey>(BalanceKey{owner1, token1}, CAmount{10}));
+    pcustomcsview->SetTokenHoldersIndexBuilt(false);
+    pcustomcsview->InitTokenHoldersIndex();
+    BOOST_CHECK(pcustomcsview->IsTokenHoldersIndexBuilt());
+    BOOST_CHECK(holders(*pcustomcsview, token1) == std::vector<CScript>{owner1});
+
+    uint256 rootWithIndex, rootWithoutIndex;
+    {
+        CCustomCSView view(*pcustomcsview);
+        applyChanges(view);
+        rootWithIndex = view.MerkleRoot();
+    }
+    {
+        // same balance changes as a node from before the index writes them
+        CCustomCSView view(*pcustomcsview);
+        BOOST_CHECK(view.WriteBy<CAccountsView::ByBalanceKey>(BalanceKey{owner3, token1}, CAmount{5}));
+        BOOST_CHECK(view.WriteBy<CAccountsView::ByBalanceKey>(BalanceKey{owner2, token1}, CAmount{5}));
+        BOOST_CHECK(view.EraseBy<CAccountsView::ByBalanceKey>(BalanceKey{owner1, token1}));
+        BOOST_CHECK(view.WriteBy<CAccountsView::ByBalanceKey>(BalanceKey{owner1, token2}, CAmount{10}));
+        rootWithoutIndex = view.MerkleRoot();
+    }
+    // index entries stay out of the merkle root
+    BOOST_CHECK(rootWithIndex == rootWithoutIndex);
+
+    CCustomCSView view(*pcustomcsview);
+    applyChanges(view);
+    auto undo = CUndo::Construct(pcustomcsview->GetStorage(), view.GetStorage().GetRaw());
+    BOOST_CHECK(view.Flush());
+    pcustomcsview->SetUndo(UndoKey{10, uint256S("0x10")}, undo);
+
+    BOOST_CHECK(holders(*pcustomcsview, token1) == (std::vector<CScript>{owner2, owner3}));
+    BOOST_CHECK(holders(*pcustomcsview, token2) == std::vector<CScript>{owner1});
+
+    pcustomcsview->OnUndoTx(uint256S("0x10"), 10);
+    BOOST_CHECK(holders(*pcustomcsview, token1) == std::vector<CScript>{owner1});
+    BOOST_CHECK(holders(*pcustomcsview, token2).empty());
+}
+
+BOOST_AUTO_TEST_CASE(accountHistoryCoveringIndex)
+{
+    const CScript owner1 = CScript() << OP_1, owner2 = CScript() << OP_2;
+    CAccountHistoryStorage history(GetDataDir() / "history_covering", 1 << 20, true, true);
+
+    auto value = [](uint8_t category) {
+        return AccountHistoryValue{uint256{}, category, {{DCT_ID{0}, 10}}};
+    };
+    auto listAll = [&]() {
+        std::vector<std::pair<uint32_t, unsigned char>> result;
+        history.ForEachAccountHistory([&](const AccountHistoryKey &key, AccountHistoryValue value) {
+            BOOST_CHECK(history.ReadAccountHistory(key)->category == value.category);
+            result.emplace_back(key.blockHeight, value.category);
+            return true;
+        });
+        return result;
+    };
+    const std::vector<std::pair<uint32_t, unsigned char>> expected{{20, 'c'}, {20, 'b'}, {10, 'a'}};
+
+    history.WriteAccountHistory({owner1, 10, 1}, value('a'));
+    history.WriteAccountHistory({owner2, 20, 0}, value('b'));
+    history.CreateMultiIndexIfNeeded(false);
+    BOOST_CHECK(!history.IsCoveringIndex());
+    history.WriteAccountHistory({owner1, 20, 2}, value('c'));
+    BOOST_CHECK(listAll() == expected);
+
+    // converted index serves the same rows from the index itself
+    history.CreateMultiIndexIfNeeded(true);
+    BOOST_CHECK(history.IsCoveringIndex());
+    BOOST_CHECK(listAll() == expected);
+
+    history.CreateMultiIndexIfNeeded(false);
+    BOOST_CHECK(!history.IsCoveringIndex());
+    BOOST_CHECK(listAll() == expected);
+}
+
+BOOST_AUTO_TEST_CASE(poolRewardHistory)
+{
+    const CScript owner1 = CScript() << OP_1, owner2 = CScript() << OP_2;
+    CAccountHistoryStorage history(GetDataDir() / "history_rewards", 1 << 20, true, true);
+
+    auto settlements = [&](const CScript &owner) {
+        std::vector<std::pair<uint32_t, DCT_ID>> result;
+        history.ForEachPoolRewardHistory(
+            [&](const PoolRewardHistoryKey &key, CLazySerialize<PoolRewardHistoryValue>) {
+                if (key.owner != owner) {
+                    return false;
+                }
+                result.emplace_back(key.blockHeight, key.poolID);
+                return true;
+            },
+            {owner, ~0u, DCT_ID{0}});
+        return result;
+    };
+    const PoolRewardHistoryValue runs{
+        {1, 9, true, {{RewardType::Coinbase, {DCT_ID{0}, 10}}}}
+    };
+
+    BOOST_CHECK(!history.GetPoolRewardHistoryStart());
+    history.InitPoolRewardHistory(true, 5);
+    BOOST_CHECK(*history.GetPoolRewardHistoryStart() == 5);
+
+    history.WritePoolRewardHistory({owner1, 10, DCT_ID{2}}, runs);
+    history.WritePoolRewardHistory({owner1, 10, DCT_ID{1}}, runs);
+    history.WritePoolRewardHistory({owner1, 20, DCT_ID{1}}, runs);
+    history.WritePoolRewardHistory({owner2, 20, DCT_ID{1}}, runs);
+    const std::vector<std::pair<uint32_t, DCT_ID>> expected{
+        {20, DCT_ID{1}},
+        {10, DCT_ID{1}},
+        {10, DCT_ID{2}}
+    };
+    BOOST_CHECK(settlements(owner1) == expected);
+
+    // disconnecting a block drops settlements of all owners at its height
+    history.ErasePoolRewardHistoryHeight(20);
+    BOOST_CHECK(settlements(owner1).size() == 2);
+    BOOST_CHECK(settlements(owner2).empty());
+    uint32_t heights{};
+    history.ForEachPoolRewardHeight(
+        [&](const PoolRewardHeightKey &key, char) {
+            BOOST_CHECK_EQUAL(key.blockHeight, 10U);
+            ++heights;
+            return true;
+        },
+        {~0u, {}});
+    BOOST_CHECK_EQUAL(heights, 1U);
+
+    // settlements of nested views are passed on when the views are flushed
+    {
+        CCustomCSView blockView(*pcustomcsview, &history, nullptr, nullptr);
+        {
+            CCustomCSView txView(blockView);
+            CCustomCSView settleView(txView);
+            settleView.GetHistoryWriters().AddPoolRewards({owner2, 25, DCT_ID{1}}, runs);
+            BOOST_CHECK(settleView.Flush());
+            CCustomCSView failedView(txView);
+            failedView.GetHistoryWriters().AddPoolRewards({owner2, 25, DCT_ID{2}}, runs);
+            BOOST_CHECK(txView.Flush());
+        }
+        BOOST_CHECK(settlements(owner2).empty());
+        blockView.GetHistoryWriters().FlushPoolRewards();
+    }
+    BOOST_CHECK(settlements(owner2) == (std::vector<std::pair<uint32_t, DCT_ID>>{{25, DCT_ID{1}}}));
+
+    history.InitPoolRewardHistory(false, 30);
+    BOOST_CHECK(!history.GetPoolRewardHistoryStart());
+    BOOST_CHECK(settlements(owner1).empty());
+}
+
+BOOST_AUTO_TEST_CASE(attributesCache)
+{
+    CCustomCSView view(*pcustomcsview);
+    const auto attributes = view.GetAttributes();
+    BOOST_CHECK(attributes == view.GetAttributes()); // parsed once
+
+    CCustomCSView child(view);
+    BOOST_CHECK(attributes == child.GetAttributes()); // shared with unchanged nested view
+
+    const CDataStructureV0 activeKey{AttributeTypes::Param, ParamIDs::DFIP2203, DFIPKeys::Active};
+    auto updated = child.GetMutableAttributes();
+    BOOST_CHECK(updated != attributes);
+    updated->SetValue(activeKey, true);
+    BOOST_CHECK(child.SetVariable(*updated));
+
+    BOOST_CHECK(child.GetAttributes()->GetValue(activeKey, false));
+    BOOST_CHECK(!view.GetAttributes()->GetValue(activeKey, false));
+    BOOST_CHECK(!attributes->GetValue(activeKey, false));
+
+    BOOST_CHECK(child.Flush());
+    BOOST_CHECK(view.GetAttributes()->GetValue(activeKey, false));
+}
+
 BOOST_AUTO_TEST_CASE(recipients)
 {
     auto testChain = interfaces::MakeChain();
@@ -443,4 +924,62 @@ BOOST_AUTO_TEST_CASE(LowerBoundTest)
     }
 }
 
+BOOST_AUTO_TEST_CASE(proposalVoteTally)
+{
+    CCustomCSView view(*pcustomcsview);
+    const auto propId = uint256S("0x1");
+    const auto mn1 = uint256S("0x11"), mn2 = uint256S("0x12"), mn3 = uint256S("0x13");
+
+    CCreateProposalMessage msg{};
+    msg.type = CProposalType::VoteOfConfidence;
+    msg.nCycles = 1;
+    BOOST_REQUIRE(view.CreateProposal(propId, 100, msg, COIN));
+
+    auto tally = view.GetProposalVoteTally(propId, 1);
+    BOOST_REQUIRE(tally);
+    BOOST_CHECK_EQUAL(tally->startHeight, 100U);
+    BOOST_CHECK_EQUAL(tally->Total(), 0U);
+
+    // Changed votes are counted once, with the latest vote
+    BOOST_CHECK(view.AddProposalVote(propId, mn1, CProposalVoteType::VoteYes));
+    BOOST_CHECK(view.AddProposalVote(propId, mn2, CProposalVoteType::VoteNo));
+    BOOST_CHECK(view.AddProposalVote(propId, mn3, CProposalVoteType::VoteYes));
+    BOOST_CHECK(view.AddProposalVote(propId, mn3, CProposalVoteType::VoteNeutral));
+
+    tally = view.GetProposalVoteTally(propId, 1);
+    BOOST_CHECK_EQUAL(tally->yes, 1U);
+    BOOST_CHECK_EQUAL(tally->no, 1U);
+    BOOST_CHECK_EQUAL(tally->neutral, 1U);
+    BOOST_CHECK(!view.GetProposalVoteTally(propId, 2));
+
+    // Updated masternodes are listed from the requested height on, changes
+    // before proposals exist are not recorded
+    const auto gcHeight = static_cast<uint32_t>(Params().GetConsensus().DF20GrandCentralHeight);
+    CMasternode node{};
+    view.RemForcedRewardAddress(mn3, node, gcHeight - 1);
+    view.RemForcedRewardAddress(mn2, node, gcHeight + 5);
+    view.RemForcedRewardAddress(mn1, node, gcHeight + 10);
+    auto changesFrom = [&](uint32_t from) {
+        std::vector<std::pair<uint32_t, uint256>> changes;
+        view.ForEachMasternodeStateChange(
+            [&](uint32_t height, const uint256 &mnId) {
+                changes.emplace_back(height, mnId);
+                return true;
+            },
+            from);
+        return changes;
+    };
+    BOOST_CHECK_EQUAL(changesFrom(0).size(), 2U);
+    auto changes = changesFrom(gcHeight + 6);
+    BOOST_REQUIRE_EQUAL(changes.size(), 1U);
+    BOOST_CHECK_EQUAL(changes[0].first, gcHeight + 10);
+    BOOST_CHECK(changes[0].second == mn1);
+
+    // Pruning keeps the changes from the given height on
+    view.EraseMasternodeStateChanges(gcHeight + 10);
+    changes = changesFrom(0);
+    BOOST_REQUIRE_EQUAL(changes.size(), 1U);
+    BOOST_CHECK_EQUAL(changes[0].first, gcHeight + 10);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
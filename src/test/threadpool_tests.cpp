@@ -0,0 +1,130 @@
+#include <dfi/threadpool.h>
+
+#include <test/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(threadpool_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(nested_groups)
+{
+    TaskPool pool{4};
+    TaskGroup g;
+    std::atomic<uint64_t> count{0};
+
+    for (auto i = 0; i < 16; ++i) {
+        pool.Post(g, [&] {
+            // Waiting on a nested group from a worker helps running the queue
+            TaskGroup child{&g};
+            for (auto j = 0; j < 16; ++j) {
+                pool.Post(child, [&] { count.fetch_add(1); });
+            }
+            child.WaitForCompletion();
+            count.fetch_add(1);
+        });
+    }
+    g.WaitForCompletion();
+
+    BOOST_CHECK_EQUAL(count.load(), 16U * 17);
+
+    const auto metrics = pool.GetMetrics();
+    BOOST_CHECK_EQUAL(metrics.threads, 4U);
+    BOOST_CHECK_EQUAL(metrics.posted[static_cast<size_t>(TaskPriority::Consensus)], 16U * 17);
+    pool.Shutdown();
+    BOOST_CHECK_EQUAL(pool.GetMetrics().completed[static_cast<size_t>(TaskPriority::Consensus)], 16U * 17);
+}
+
+BOOST_AUTO_TEST_CASE(wait_runs_own_tasks)
+{
+    TaskPool pool{1};
+    TaskGroup g, other;
+    std::atomic_bool otherRan{false}, ranBeforeWait{true};
+
+    pool.Post(g, [&] {
+        TaskGroup child{&g};
+        pool.Post(child, [] {});
+        // Queued last, so it's the first one the worker would pick up
+        pool.Post(other, [&] { otherRan.store(true); });
+        // The only worker has to run the child task itself, but not the other one
+        child.WaitForCompletion();
+        ranBeforeWait.store(otherRan.load());
+    });
+    g.WaitForCompletion();
+    other.WaitForCompletion();
+
+    BOOST_CHECK(!ranBeforeWait.load());
+    BOOST_CHECK(otherRan.load());
+}
+
+BOOST_AUTO_TEST_CASE(consensus_before_rpc)
+{
+    TaskPool pool{1};
+    TaskGroup g;
+    std::atomic_bool blocked{true};
+    std::mutex m;
+    std::vector<TaskPriority> order;
+
+    // Occupy the only worker until everything is queued
+    pool.Post(g, [&] {
+        while (blocked.load()) {
+            std::this_thread::yield();
+        }
+    });
+
+    const auto record = [&](TaskPriority priority) {
+        return [&, priority] {
+            std::unique_lock l{m};
+            order.push_back(priority);
+        };
+    };
+    for (auto i = 0; i < 3; ++i) {
+        pool.Post(g, record(TaskPriority::RPC), TaskPriority::RPC);
+    }
+    for (auto i = 0; i < 3; ++i) {
+        pool.Post(g, record(TaskPriority::Consensus), TaskPriority::Consensus);
+    }
+    blocked.store(false);
+    g.WaitForCompletion();
+
+    const std::vector<TaskPriority> expected{TaskPriority::Consensus,
+                                             TaskPriority::Consensus,
+                                             TaskPriority::Consensus,
+                                             TaskPriority::RPC,
+                                             TaskPriority::RPC,
+                                             TaskPriority::RPC};
+    BOOST_CHECK(order == expected);
+}
+
+BOOST_AUTO_TEST_CASE(cancel_parent)
+{
+    TaskPool pool{2};
+    TaskGroup parent;
+    TaskGroup child{&parent};
+    std::atomic_bool blocked{true};
+    std::atomic<uint64_t> started{0}, count{0};
+
+    // Occupy both workers, so child tasks are still queued on cancellation
+    for (auto i = 0; i < 2; ++i) {
+        pool.Post(parent, [&] {
+            started.fetch_add(1);
+            while (blocked.load()) {
+                std::this_thread::yield();
+            }
+        });
+    }
+    while (started.load() != 2) {
+        std::this_thread::yield();
+    }
+    for (auto i = 0; i < 8; ++i) {
+        pool.Post(child, [&] { count.fetch_add(1); });
+    }
+
+    parent.MarkCancelled();
+    BOOST_CHECK(child.IsCancelled());
+    blocked.store(false);
+    parent.WaitForCompletion();
+
+    BOOST_CHECK_EQUAL(count.load(), 0U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -22,6 +22,113 @@
 #include <util/time.h>
 #include <validation.h>
 
+static const TBytes &AttributesKey() {
+    static const auto key = DbTypeToBytes(std::make_pair(CGovView::ByName::prefix(), std::string{"ATTRIBUTES"}));
+    return key;
+}
+
+// Live statistics are accumulated by txs and events but never checked against,
+// except for the token lock ratio. Drops them so only changes that can affect
+// tx validity are compared.
+static TBytes AttributesWithoutLiveStats(const std::optional<TBytes> &raw) {
+    if (!raw) {
+        return {};
+    }
+    ATTRIBUTES attributes;
+    if (!BytesToDbType(*raw, attributes)) {
+        return *raw;
+    }
+    std::vector<CAttributeType> liveKeys;
+    for (const auto &[key, value] : attributes.GetAttributesMap()) {
+        const auto attrV0 = std::get_if<CDataStructureV0>(&key);
+        if (attrV0 && attrV0->type == AttributeTypes::Live && attrV0->key != EconomyKeys::TokenLockRatio) {
+            liveKeys.push_back(key);
+        }
+    }
+    for (const auto &key : liveKeys) {
+        attributes.EraseKey(key);
+    }
+    return DbTypeToBytes(attributes);
+}
+
+// Results of these txs don't depend on the block height apart from fork
+// activations and owner reward settlement, they are carried over to the next
+// height when nothing they read or wrote changed. Their ATTRIBUTES writes are
+// dex live statistics.
+static bool IsDeFiTraceReusable(CustomTxType type) {
+    switch (type) {
+        case CustomTxType::None:
+        case CustomTxType::UtxosToAccount:
+        case CustomTxType::AccountToUtxos:
+        case CustomTxType::AccountToAccount:
+        case CustomTxType::AnyAccountsToAccounts:
+        case CustomTxType::PoolSwap:
+        case CustomTxType::PoolSwapV2:
+        case CustomTxType::AddPoolLiquidity:
+        case CustomTxType::RemovePoolLiquidity:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool IsForkActivatedBetween(const Consensus::Params &consensus, int from, int to) {
+    for (const auto height : {consensus.DF1AMKHeight,
+                              consensus.DF2BayfrontHeight,
+                              consensus.DF3BayfrontMarinaHeight,
+                              consensus.DF4BayfrontGardensHeight,
+                              consensus.DF5ClarkeQuayHeight,
+                              consensus.DF6DakotaHeight,
+                              consensus.DF7DakotaCrescentHeight,
+                              consensus.DF8EunosHeight,
+                              consensus.DF9EunosKampungHeight,
+                              consensus.DF10EunosPayaHeight,
+                              consensus.DF11FortCanningHeight,
+                              consensus.DF12FortCanningMuseumHeight,
+                              consensus.DF13FortCanningParkHeight,
+                              consensus.DF14FortCanningHillHeight,
+                              consensus.DF15FortCanningRoadHeight,
+                              consensus.DF16FortCanningCrunchHeight,
+                              consensus.DF17FortCanningSpringHeight,
+                              consensus.DF18FortCanningGreatWorldHeight,
+                              consensus.DF19FortCanningEpilogueHeight,
+                              consensus.DF20GrandCentralHeight,
+                              consensus.DF21GrandCentralEpilogueHeight,
+                              consensus.DF22MetachainHeight,
+                              consensus.DF23Height,
+                              consensus.DF24Height}) {
+        if (height > from && height <= to) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Owners debited or credited get their pool rewards paid up to the height the
+// entry was applied at, the rewards are read by height and not covered by the
+// read set. Entries settling rewards of a pool share holder are height bound.
+static bool SettlesPoolRewards(CCustomCSView &view, const MapKV &writes) {
+    for (const auto &[key, _] : writes) {
+        std::pair<uint8_t, CScript> owner;
+        if (key.empty() || key[0] != CAccountsView::ByHeightKey::prefix() || !BytesToDbType(key, owner)) {
+            continue;
+        }
+        bool hasShare{};
+        view.ForEachPoolId([&](DCT_ID const &poolId) {
+            hasShare = view.GetShare(poolId, owner.second).has_value();
+            return !hasShare;
+        });
+        if (hasShare) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static size_t DeFiTraceUsage(const CStorageReadSet &reads, const MapKV &writes) {
+    return memusage::DynamicUsage(reads.keys) + memusage::DynamicUsage(reads.ranges) + memusage::DynamicUsage(writes);
+}
+
 CTxMemPoolEntry::CTxMemPoolEntry(const CTransactionRef &_tx,
                                  const CAmount &_nFee,
                                  int64_t _nTime,
@@ -448,6 +555,7 @@ void CTxMemPool::removeUnchecked(txiter it, MemPoolRemovalReason reason) {
         vTxHashes.clear();
     }
 
+    eraseDeFiTrace(hash, txType);
     totalTxSize -= it->GetTxSize();
     cachedInnerUsage -= it->DynamicMemoryUsage();
     cachedInnerUsage -= memusage::DynamicUsage(mapLinks[it].parents) + memusage::DynamicUsage(mapLinks[it].children);
@@ -680,6 +788,7 @@ void CTxMemPool::rebuildViews() {
     view.SetBackend(viewMemPool);
 
     setAccountViewDirty();
+    defiChangesUnknown = true;
     rebuildAccountsView(::ChainActive().Tip()->nHeight, view);
 }
 
@@ -697,6 +806,11 @@ void CTxMemPool::_clear() {
     rollingMinimumFeeRate = 0;
     accountsViewDirty = false;
     forceRebuildForReorg = false;
+    defiTraces.clear();
+    defiTracesUsage = 0;
+    defiChangedKeys.clear();
+    defiChangesUnknown = false;
+    defiAttributesChanged = false;
     ++nTransactionsUpdated;
 }
 
@@ -1216,6 +1330,60 @@ bool CTxMemPool::getAccountViewDirty() const {
     return accountsViewDirty;
 }
 
+void CTxMemPool::setDeFiTrace(const uint256 &hash, CStorageReadSet reads, const MapKV &writes, int height) {
+    AssertLockHeld(cs);
+    if (auto it = defiTraces.find(hash); it != defiTraces.end()) {
+        defiTracesUsage -= DeFiTraceUsage(it->second.reads, it->second.writes);
+        defiTraces.erase(it);
+    }
+    defiTracesUsage += DeFiTraceUsage(reads, writes);
+    defiTraces.emplace(hash, DeFiTrace{std::move(reads), writes, height});
+}
+
+void CTxMemPool::eraseDeFiTrace(const uint256 &hash, CustomTxType type) {
+    auto it = defiTraces.find(hash);
+    if (it == defiTraces.end()) {
+        return;
+    }
+    // Writes of the entry are gone from the accounts view with it
+    for (const auto &[key, _] : it->second.writes) {
+        defiChangedKeys.insert(key);
+    }
+    if (!IsDeFiTraceReusable(type) && it->second.writes.count(AttributesKey())) {
+        defiAttributesChanged = true;
+    }
+    defiTracesUsage -= DeFiTraceUsage(it->second.reads, it->second.writes);
+    defiTraces.erase(it);
+}
+
+void CTxMemPool::trackBlockChanges(CCustomCSView &blockView, CCustomCSView &base) {
+    LOCK(cs);
+    if (mapTx.empty()) {
+        return;
+    }
+    const auto &changes = blockView.GetStorage().GetRaw();
+    for (const auto &[key, value] : changes) {
+        defiChangedKeys.insert(key);
+    }
+    if (const auto it = changes.find(AttributesKey()); it != changes.end() && !defiAttributesChanged) {
+        TBytes before;
+        const auto hasBefore = base.GetStorage().Read(it->first, before);
+        defiAttributesChanged = AttributesWithoutLiveStats(hasBefore ? std::optional{before} : std::nullopt) !=
+                                AttributesWithoutLiveStats(it->second);
+    }
+    accountsViewDirty |= !changes.empty();
+}
+
+std::pair<uint64_t, uint64_t> CTxMemPool::getDeFiRevalidationStats() const {
+    LOCK(cs);
+    return {defiRevalidated, defiSkipped};
+}
+
+size_t CTxMemPool::getDeFiTracesUsage() const {
+    LOCK(cs);
+    return defiTracesUsage;
+}
+
 bool CTxMemPool::checkAddressNonceAndFee(const CTxMemPoolEntry &pendingEntry,
                                          const uint64_t &entryFee,
                                          const EvmAddressData &txSender,
@@ -1273,12 +1441,51 @@ void CTxMemPool::rebuildAccountsView(int height, const CCoinsViewCache &coinsCac
     std::vector<CTransactionRef> vtx;
 
     const auto isEvmEnabledForBlock = IsEVMEnabled(viewDuplicate);
+    const auto &consensus = Params().GetConsensus();
+
+    // Entries are re-applied in entry time order. One that read or wrote nothing
+    // changed since it was last applied gets its writes copied over, the rest is
+    // validated again and their writes count as changed for the entries after them.
+    const auto incremental = !defiChangesUnknown && !forceRebuildForReorg;
+    auto &changedKeys = defiChangedKeys;
+    auto attributesChanged = defiAttributesChanged;
+    setEntries revalidated;
+    uint64_t revalidatedCount{}, skippedCount{};
+
+    const auto mustRevalidate = [&](txiter entry, const DeFiTrace &trace) {
+        if (!IsDeFiTraceReusable(entry->GetCustomTxType()) ||
+            IsForkActivatedBetween(consensus, trace.height, height) ||
+            SettlesPoolRewards(viewDuplicate, trace.writes)) {
+            return true;
+        }
+        for (const auto &parent : GetMemPoolParents(entry)) {
+            if (revalidated.count(parent)) {
+                return true;
+            }
+        }
+        for (const auto &[key, _] : trace.writes) {
+            if (changedKeys.count(key)) {
+                return true;
+            }
+        }
+        if (!trace.reads.Intersects(changedKeys)) {
+            return false;
+        }
+        if (attributesChanged || !changedKeys.count(AttributesKey())) {
+            return true;
+        }
+        // ATTRIBUTES changed only in live statistics, check the rest without it
+        auto reads = trace.reads;
+        reads.keys.erase(AttributesKey());
+        return reads.Intersects(changedKeys);
+    };
 
     // Check custom TX consensus types are now not in conflict with account layer
     auto &txsByEntryTime = mapTx.get<entry_time>();
     for (auto it = txsByEntryTime.begin(); it != txsByEntryTime.end(); ++it) {
         CValidationState state;
         const auto &tx = it->GetTx();
+        const auto entry = mapTx.project<0>(it);
         const auto removeTxBackToStage = [&it](const indexed_transaction_set &mapTx,
                                                CTxMemPool::setEntries &staged,
                                                std::vector<CTransactionRef> &vtx,
@@ -1288,15 +1495,38 @@ void CTxMemPool::rebuildAccountsView(int height, const CCoinsViewCache &coinsCac
             vtx.push_back(it->GetSharedTx());
         };
 
-        if (!Consensus::CheckTxInputs(tx, state, coinsCache, viewDuplicate, height, txfee, Params())) {
+        auto trace = defiTraces.find(tx.GetHash());
+        if (incremental && trace != defiTraces.end() && !mustRevalidate(entry, trace->second)) {
+            auto &storage = viewDuplicate.GetStorage();
+            for (const auto &[key, value] : trace->second.writes) {
+                value ? storage.Write(key, *value) : storage.Erase(key);
+            }
+            trace->second.height = height;
+            ++skippedCount;
+            continue;
+        }
+
+        ++revalidatedCount;
+        revalidated.insert(entry);
+        if (trace != defiTraces.end()) {
+            for (const auto &[key, _] : trace->second.writes) {
+                changedKeys.insert(key);
+            }
+        }
+
+        CStorageReadSet reads;
+        CCustomCSView txView(viewDuplicate);
+        txView.GetStorage().TrackReads(&reads);
+
+        if (!Consensus::CheckTxInputs(tx, state, coinsCache, txView, height, txfee, Params())) {
             removeTxBackToStage(mapTx, staged, vtx, tx);
             continue;
         }
         auto blockCtx = BlockContext{
             static_cast<uint32_t>(height),
             static_cast<uint64_t>(it->GetTime()),
-            Params().GetConsensus(),
-            &viewDuplicate,
+            consensus,
+            &txView,
             isEvmEnabledForBlock,
             {},
             true,
@@ -1310,7 +1540,19 @@ void CTxMemPool::rebuildAccountsView(int height, const CCoinsViewCache &coinsCac
 
         if (!res && (res.code & CustomTxErrCodes::Fatal)) {
             removeTxBackToStage(mapTx, staged, vtx, tx);
+            continue;
         }
+
+        txView.GetStorage().TrackReads(nullptr);
+        const auto &writes = txView.GetStorage().GetRaw();
+        for (const auto &[key, _] : writes) {
+            changedKeys.insert(key);
+        }
+        if (!IsDeFiTraceReusable(it->GetCustomTxType()) && writes.count(AttributesKey())) {
+            attributesChanged = true;
+        }
+        setDeFiTrace(tx.GetHash(), std::move(reads), writes, height);
+        txView.Flush();
     }
 
     RemoveStaged(staged, true, MemPoolRemovalReason::BLOCK);
@@ -1323,6 +1565,17 @@ void CTxMemPool::rebuildAccountsView(int height, const CCoinsViewCache &coinsCac
     viewDuplicate.Flush();
     accountsViewDirty = false;
     forceRebuildForReorg = false;
+    defiChangedKeys.clear();
+    defiChangesUnknown = false;
+    defiAttributesChanged = false;
+    defiRevalidated += revalidatedCount;
+    defiSkipped += skippedCount;
+    LogPrint(BCLog::MEMPOOL,
+             "%s: height %d, revalidated %d, skipped %d\n",
+             __func__,
+             height,
+             revalidatedCount,
+             skippedCount);
 }
 
 void CTxMemPool::AddToStaged(setEntries &staged,
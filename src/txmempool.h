@@ -18,6 +18,7 @@
 #include <coins.h>
 #include <crypto/siphash.h>
 #include <dfi/customtx.h>
+#include <flushablestorage.h>
 #include <indirectmap.h>
 #include <key.h>
 #include <policy/feerate.h>
@@ -569,6 +570,25 @@ private:
     bool forceRebuildForReorg;
     std::unique_ptr<CCustomCSView> acview;
 
+    // What an entry read from and wrote to the accounts view when last validated
+    struct DeFiTrace {
+        CStorageReadSet reads;
+        MapKV writes;
+        int height{};
+    };
+    std::map<uint256, DeFiTrace> defiTraces;
+    size_t defiTracesUsage{};
+    // Keys changed underneath the accounts view since it was last rebuilt
+    std::set<TBytes> defiChangedKeys;
+    // Whether some of the changed keys are unknown, entries can't be skipped then
+    bool defiChangesUnknown{};
+    // Whether ATTRIBUTES changed in more than live statistics
+    bool defiAttributesChanged{};
+    uint64_t defiRevalidated{};
+    uint64_t defiSkipped{};
+
+    void eraseDeFiTrace(const uint256 &hash, CustomTxType type);
+
     static void AddToStaged(setEntries &staged,
                             std::vector<CTransactionRef> &vtx,
                             const CTransactionRef tx,
@@ -751,6 +771,16 @@ public:
     void setAccountViewDirty();
     bool getAccountViewDirty() const;
 
+    // Stores what tx read and wrote when it was applied on top of accountsView
+    void setDeFiTrace(const uint256 &hash, CStorageReadSet reads, const MapKV &writes, int height);
+    // Records DeFi state changes of a connected or disconnected block, entries
+    // not depending on them are carried over on the next accounts view rebuild.
+    // Must be called before changes are flushed into base view.
+    void trackBlockChanges(CCustomCSView &blockView, CCustomCSView &base);
+    std::pair<uint64_t, uint64_t> getDeFiRevalidationStats() const;
+    // Memory held by the DeFi traces, not part of DynamicMemoryUsage() and -maxmempool
+    size_t getDeFiTracesUsage() const;
+
     bool checkAddressNonceAndFee(const CTxMemPoolEntry &pendingEntry,
                                  const uint64_t &entryFee,
                                  const EvmAddressData &txSender,
@@ -151,6 +151,9 @@ std::atomic_bool fImporting(false);
 std::atomic_bool fReindex(false);
 bool fHavePruned = false;
 bool fPruneMode = false;
+uint32_t nUndoRetention = DEFAULT_UNDO_RETENTION;
+// Highest tip minus the retention window seen, undo data below it may be gone
+static std::atomic<uint32_t> nUndoPrunedHeight{0};
 bool fRequireStandard = true;
 bool fCheckBlockIndex = false;
 
@@ -693,7 +696,9 @@ static bool AcceptToMemoryPoolWorker(const CChainParams &chainparams,
         pool.rebuildAccountsView(height, view);
 
         // Get view after we rebuild account view
+        CStorageReadSet defiReads;
         CCustomCSView mnview(pool.accountsView());
+        mnview.GetStorage().TrackReads(&defiReads);
 
         CAmount nFees = 0;
         if (!Consensus::CheckTxInputs(tx, state, view, mnview, height, nFees, chainparams)) {
@@ -1048,19 +1053,20 @@ static bool AcceptToMemoryPoolWorker(const CChainParams &chainparams,
                     ValidationInvalidReason::TX_NOT_STANDARD, false, "failed-to-parse-evm-tx-metadata");
             }
 
-            std::string rawEVMTx;
+            // Raw tx bytes are passed as a slice into txMessage, no hex encoding on the way
+            rust::slice<const uint8_t> rawEVMTx;
 
             if (isEVMTx) {
-                const auto obj = std::get<CEvmTxMessage>(txMessage);
-                rawEVMTx = HexStr(obj.evmTx);
+                const auto &obj = std::get<CEvmTxMessage>(txMessage);
+                rawEVMTx = ffi_from_bytes_to_slice(obj.evmTx);
             } else {
-                const auto obj = std::get<CTransferDomainMessage>(txMessage);
+                const auto &obj = std::get<CTransferDomainMessage>(txMessage);
                 if (obj.transfers[0].first.domain == static_cast<uint8_t>(VMDomain::DVM) &&
                     obj.transfers[0].second.domain == static_cast<uint8_t>(VMDomain::EVM)) {
-                    rawEVMTx = HexStr(obj.transfers[0].second.data);
+                    rawEVMTx = ffi_from_bytes_to_slice(obj.transfers[0].second.data);
                 } else if (obj.transfers[0].first.domain == static_cast<uint8_t>(VMDomain::EVM) &&
                            obj.transfers[0].second.domain == static_cast<uint8_t>(VMDomain::DVM)) {
-                    rawEVMTx = HexStr(obj.transfers[0].first.data);
+                    rawEVMTx = ffi_from_bytes_to_slice(obj.transfers[0].first.data);
                 }
             }
 
@@ -1139,6 +1145,8 @@ static bool AcceptToMemoryPoolWorker(const CChainParams &chainparams,
 
         // Store transaction in memory
         pool.addUnchecked(entry, setAncestors, validForFeeEstimation, ethSender);
+        mnview.GetStorage().TrackReads(nullptr);
+        pool.setDeFiTrace(hash, std::move(defiReads), mnview.GetStorage().GetRaw(), height);
         mnview.Flush();
 
         // trim mempool and check if tx was trimmed
@@ -3019,7 +3027,7 @@ bool CChainState::ConnectBlock(const CBlock &block,
     auto isEvmEnabledForBlock = blockCtx.GetEVMEnabledForBlock();
     auto &evmTemplate = blockCtx.GetEVMTemplate();
 
-    // Note: TaskGroup needs to be alive until the end of the boost IO pool completion.
+    // Note: TaskGroup needs to be alive until the end of the task pool completion.
     // So, we allocate it outside of the pre-cache scope, and ensure it's cancelled on
     // all return paths.
     TaskGroup evmEccPreCacheTaskPool;
@@ -3049,7 +3057,6 @@ bool CChainState::ConnectBlock(const CBlock &block,
         auto isEccPreCacheEnabled = eccPreCacheControl == -1 || eccPreCacheControl > 0;
         if (isEccPreCacheEnabled) {
             // Pre-warm validation cache
-            auto &pool = DfTxTaskPool->pool;
 
             auto isFirstTx = true;
             for (uint32_t i{}; i < block.vtx.size(); i++) {
@@ -3085,18 +3092,14 @@ bool CChainState::ConnectBlock(const CBlock &block,
                         continue;
                     }
 
-                    evmEccPreCacheTaskPool.AddTask();
-                    boost::asio::post(pool, [&evmEccPreCacheTaskPool, evmMsg = std::move(txMessage)] {
-                        if (!evmEccPreCacheTaskPool.IsCancelled()) {
-                            const auto obj = std::get<CEvmTxMessage>(evmMsg);
+                    DfTxTaskPool->Post(evmEccPreCacheTaskPool, [evmMsg = std::move(txMessage)] {
+                        const auto &obj = std::get<CEvmTxMessage>(evmMsg);
 
-                            const auto rawEvmTx = HexStr(obj.evmTx);
-                            auto v = XResultValueLogged(evm_try_unsafe_make_signed_tx(result, rawEvmTx));
-                            if (v) {
-                                XResultStatusLogged(evm_try_unsafe_cache_signed_tx(result, rawEvmTx, *v));
-                            }
+                        const auto rawEvmTx = ffi_from_bytes_to_slice(obj.evmTx);
+                        auto v = XResultValueLogged(evm_try_unsafe_make_signed_tx(result, rawEvmTx));
+                        if (v) {
+                            XResultStatusLogged(evm_try_unsafe_cache_signed_tx(result, rawEvmTx, *v));
                         }
-                        evmEccPreCacheTaskPool.RemoveTask();
                     });
                 }
             }
@@ -3394,6 +3397,9 @@ bool CChainState::ConnectBlock(const CBlock &block,
 
     ProcessDeFiEvent(block, pindex, view, creationTxs, blockCtx);
 
+    // Record rewards settled in block views outside of a tx history writer
+    mnview.GetHistoryWriters().FlushPoolRewards();
+
     // Write any UTXO burns
     for (const auto &[key, value] : writeBurnEntries) {
         mnview.GetHistoryWriters().WriteAccountHistory(key, value);
@@ -3415,29 +3421,40 @@ bool CChainState::ConnectBlock(const CBlock &block,
 
     auto &checkpoints = chainparams.Checkpoints().mapCheckpoints;
     auto it = checkpoints.lower_bound(pindex->nHeight);
+
+    // Undo data is pruned below the last checkpoint, or the retention window if shorter.
+    // Pruning runs inline here, spread over blocks a bounded batch per block instead of a single sweep.
+    uint32_t undoPruneHeight{};
     if (it != checkpoints.begin()) {
-        --it;
-        bool pruneStarted = false;
+        undoPruneHeight = static_cast<uint32_t>(std::prev(it)->first);  // don't erase checkpoint height
+    }
+    if (nUndoRetention && static_cast<uint32_t>(pindex->nHeight) > nUndoRetention) {
+        UpdateUndoPrunedHeight(pindex->nHeight);
+        undoPruneHeight = std::max(undoPruneHeight, static_cast<uint32_t>(pindex->nHeight) - nUndoRetention);
+    }
+    if (undoPruneHeight) {
         auto time = GetTimeMillis();
         CCustomCSView pruned(mnview);
-        mnview.ForEachUndo([&](const UndoKey &key, CLazySerialize<CUndo>) {
-            if (key.height >= static_cast<uint32_t>(it->first)) {  // don't erase checkpoint height
-                return false;
+        if (const auto count = pruned.PruneUndos(undoPruneHeight, UNDO_PRUNE_BATCH)) {
+            // Widen the range compacted on the next flush
+            auto &map = pruned.GetStorage().GetRaw();
+            if (compactBegin.empty() || map.begin()->first < compactBegin) {
+                compactBegin = map.begin()->first;
             }
-            if (!pruneStarted) {
-                pruneStarted = true;
-                LogPrintf("Pruning undo data prior %d, it can take a while...\n", it->first);
+            if (compactEnd.empty() || map.rbegin()->first > compactEnd) {
+                compactEnd = map.rbegin()->first;
             }
-            return pruned.DelUndo(key).ok;
-        });
-        if (pruneStarted) {
-            auto &map = pruned.GetStorage().GetRaw();
-            compactBegin = map.begin()->first;
-            compactEnd = map.rbegin()->first;
             pruned.Flush();
-            LogPrintf("Pruning undo data finished.\n");
-            LogPrint(BCLog::BENCH, "    - Pruning undo data takes: %dms\n", GetTimeMillis() - time);
+            LogPrint(BCLog::BENCH,
+                     "    - Pruning %d undo records prior %d takes: %dms\n",
+                     count,
+                     undoPruneHeight,
+                     GetTimeMillis() - time);
         }
+    }
+
+    if (it != checkpoints.begin()) {
+        --it;
         // we can safety delete old interest keys
         if (it->first > consensus.DF14FortCanningHillHeight) {
             CCustomCSView view(mnview);
@@ -3739,9 +3756,16 @@ static bool BlockchainNearTip(const int64_t blockTime) {
 bool CChainState::DisconnectTip(CValidationState &state,
                                 const CChainParams &chainparams,
                                 DisconnectedBlockTransactions *disconnectpool) {
-    m_disconnectTip = true;
     CBlockIndex *pindexDelete = m_chain.Tip();
     assert(pindexDelete);
+    // Without its undo data the DeFi state of the block can't be reverted
+    if (nUndoRetention && static_cast<uint32_t>(pindexDelete->nHeight) <= GetUndoPrunedHeight()) {
+        return state.Error(strprintf("Cannot disconnect block %d, its undo data is beyond -undoretention=%d. "
+                                     "Reindex to reorganize deeper.",
+                                     pindexDelete->nHeight,
+                                     nUndoRetention));
+    }
+    m_disconnectTip = true;
     // Read block from disk.
     std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
     CBlock &block = *pblock;
@@ -3751,6 +3775,8 @@ bool CChainState::DisconnectTip(CValidationState &state,
     }
     // Apply the block atomically to the chain state.
     int64_t nStart = GetTimeMicros();
+    // Storage prefixes the block changes, for RPC result cache invalidation
+    RPCResultCache::Prefixes changedPrefixes;
     {
         CCoinsViewCache view(&CoinsTip());
         CCustomCSView mnview(*pcustomcsview, paccountHistoryDB.get(), pburnHistoryDB.get(), pvaultHistoryDB.get());
@@ -3765,6 +3791,8 @@ bool CChainState::DisconnectTip(CValidationState &state,
             XResultThrowOnErr(evm_try_disconnect_latest_block(result));
         }
 
+        mempool.trackBlockChanges(mnview, *pcustomcsview);
+        changedPrefixes = RPCResultCache::ChangedPrefixes(mnview.GetStorage().GetRaw());
         bool flushed = view.Flush() && mnview.Flush();
         assert(flushed);
         mnview.GetHistoryWriters().FlushDB();
@@ -3804,8 +3832,6 @@ bool CChainState::DisconnectTip(CValidationState &state,
 
     UpdateTip(pindexDelete->pprev, chainparams);
 
-    SetLastValidatedHeight(pindexDelete->pprev->nHeight);
-
     // DisconnectTip might be called before psnapshotManager has been initialised
     // as part of start-up so check psnapshotManager before using it.
     if (psnapshotManager) {
@@ -3816,6 +3842,9 @@ bool CChainState::DisconnectTip(CValidationState &state,
                                             BlockchainNearTip(pindexDelete->pprev->GetBlockTime()));
     }
 
+    // After the snapshots, so results cached from then on are never computed on older ones
+    SetLastValidatedHeight(pindexDelete->pprev->nHeight, changedPrefixes);
+
     // Let wallets know transactions went from 1-confirmed to
     // 0-confirmed or conflicted:
     GetMainSignals().BlockDisconnected(pblock);
@@ -3929,6 +3958,8 @@ bool CChainState::ConnectTip(CValidationState &state,
              "  - Load block from disk: %.2fms [%.2fs]\n",
              (nTime2 - nTime1) * MILLI,
              nTimeReadFromDisk * MICRO);
+    // Storage prefixes the block changes, for RPC result cache invalidation
+    std::optional<RPCResultCache::Prefixes> changedPrefixes;
     {
         CCoinsViewCache view(&CoinsTip());
         CCustomCSView mnview(*pcustomcsview, paccountHistoryDB.get(), pburnHistoryDB.get(), pvaultHistoryDB.get());
@@ -3954,6 +3985,8 @@ bool CChainState::ConnectTip(CValidationState &state,
                  nTimeConnectTotal * MICRO,
                  nTimeConnectTotal * MILLI / nBlocksTotal);
 
+        mempool.trackBlockChanges(mnview, *pcustomcsview);
+        changedPrefixes = RPCResultCache::ChangedPrefixes(mnview.GetStorage().GetRaw());
         bool flushed = view.Flush() && mnview.Flush();
         assert(flushed);
         mnview.GetHistoryWriters().FlushDB();
@@ -4000,6 +4033,8 @@ bool CChainState::ConnectTip(CValidationState &state,
     if (pindexNew->nHeight >= Params().GetConsensus().DF6DakotaHeight &&
         pindexNew->nHeight % Params().GetConsensus().mn.anchoringTeamChange == 0) {
         pcustomcsview->CalcAnchoringTeams(blockConnecting.stakeModifier, pindexNew);
+        // Written outside of the block view
+        changedPrefixes.reset();
 
         // Delete old and now invalid anchor confirms
         panchorAwaitingConfirms->Clear();
@@ -4010,8 +4045,6 @@ bool CChainState::ConnectTip(CValidationState &state,
         }
     }
 
-    SetLastValidatedHeight(pindexNew->nHeight);
-
     // ConnectTip might be called before psnapshotManager has been initialised
     // as part of start-up so check psnapshotManager before using it.
     if (psnapshotManager) {
@@ -4022,6 +4055,9 @@ bool CChainState::ConnectTip(CValidationState &state,
                                             BlockchainNearTip(pindexNew->GetBlockTime()));
     }
 
+    // After the snapshots, so results cached from then on are never computed on older ones
+    SetLastValidatedHeight(pindexNew->nHeight, changedPrefixes);
+
     int64_t nTime6 = GetTimeMicros();
     nTimePostConnect += nTime6 - nTime5;
     nTimeTotal += nTime6 - nTime1;
@@ -4150,6 +4186,16 @@ bool CChainState::ActivateBestChainStep(CValidationState &state,
     const CBlockIndex *pindexOldTip = m_chain.Tip();
     const CBlockIndex *pindexFork = m_chain.FindFork(pindexMostWork);
 
+    // Reverting blocks past the undo retention window would corrupt the DeFi state
+    if (nUndoRetention && pindexOldTip && pindexFork && pindexOldTip != pindexFork &&
+        static_cast<uint32_t>(pindexFork->nHeight + 1) <= GetUndoPrunedHeight()) {
+        return AbortNode(state,
+                         strprintf("Reorganization to block %d is beyond -undoretention=%d. "
+                                   "Reindex to follow the new chain.",
+                                   pindexFork->nHeight,
+                                   nUndoRetention));
+    }
+
     // Disconnect active blocks which are no longer in the best chain.
     bool fBlocksDisconnected = false;
     DisconnectedBlockTransactions disconnectpool;
@@ -4510,6 +4556,12 @@ bool CChainState::InvalidateBlock(CValidationState &state, const CChainParams &c
                                  error("Cannot invalidate block prior last checkpoint height %d", pcheckpoint->nHeight),
                                  "");
         }
+        if (nUndoRetention && static_cast<uint32_t>(pindex->nHeight) <= GetUndoPrunedHeight()) {
+            return state.Error(strprintf("Cannot invalidate block %d, its undo data is beyond -undoretention=%d. "
+                                         "Reindex to reorganize deeper.",
+                                         pindex->nHeight,
+                                         nUndoRetention));
+        }
 
         for (const auto &entry : m_blockman.m_block_index) {
             CBlockIndex *candidate = entry.second;
@@ -6125,6 +6177,20 @@ bool static LoadBlockIndexDB(const CChainParams &chainparams) EXCLUSIVE_LOCKS_RE
     return true;
 }
 
+uint32_t GetUndoPrunedHeight() {
+    return nUndoPrunedHeight.load(std::memory_order_relaxed);
+}
+
+void UpdateUndoPrunedHeight(int tipHeight) {
+    if (!nUndoRetention || tipHeight <= 0 || static_cast<uint32_t>(tipHeight) <= nUndoRetention) {
+        return;
+    }
+    const auto height = static_cast<uint32_t>(tipHeight) - nUndoRetention;
+    auto current = nUndoPrunedHeight.load(std::memory_order_relaxed);
+    while (current < height && !nUndoPrunedHeight.compare_exchange_weak(current, height, std::memory_order_relaxed)) {
+    }
+}
+
 bool LoadChainTip(const CChainParams &chainparams) {
     AssertLockHeld(cs_main);
     const CCoinsViewCache &coins_cache = ::ChainstateActive().CoinsTip();
@@ -6140,6 +6206,8 @@ bool LoadChainTip(const CChainParams &chainparams) {
         return false;
     }
     ::ChainActive().SetTip(pindex);
+    // Earlier runs pruned undo data up to the retention window of this tip at least
+    UpdateUndoPrunedHeight(pindex->nHeight);
 
     ::ChainstateActive().PruneBlockIndexCandidates();
 
@@ -148,6 +148,13 @@ static const unsigned int MAX_BLOCKS_TO_ANNOUNCE = 8;
 /** Maximum number of unconnecting headers announcements before DoS score */
 static const int MAX_UNCONNECTING_HEADERS = 10;
 
+/** Default for -undoretention, undo data is kept down to the last checkpoint */
+static const uint32_t DEFAULT_UNDO_RETENTION = 0;
+/** Minimum number of blocks undo data is kept for when -undoretention is set */
+static const uint32_t MIN_UNDO_RETENTION = 288;
+/** Maximum number of undo records pruned while connecting a block */
+static const size_t UNDO_PRUNE_BATCH = 10000;
+
 /** Default for -stopatheight */
 static const int DEFAULT_STOPATHEIGHT = 0;
 
@@ -202,6 +209,12 @@ extern bool fHavePruned;
 extern bool fPruneMode;
 /** Number of MiB of block files that we're trying to stay below. */
 extern uint64_t nPruneTarget;
+/** Number of blocks undo data is kept for, 0 to keep it down to the last checkpoint */
+extern uint32_t nUndoRetention;
+/** Blocks at or below this height may have lost their DeFi undo data to -undoretention */
+uint32_t GetUndoPrunedHeight();
+/** Moves the pruned height along with the tip, when -undoretention is set */
+void UpdateUndoPrunedHeight(int tipHeight);
 /** Flag to skip PoS-related checks (regtest only) */
 extern bool fIsFakeNet;
 
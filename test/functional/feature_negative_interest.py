@@ -1199,6 +1199,15 @@ class NegativeInterestTest(DefiTestFramework):
             Decimal(balanceDUSDbefore) - Decimal("1.00000000"),
         )
 
+    def check_interest_tally(self):
+        # Running interest tally matches a full scan of the stored interests
+        result = self.nodes[0].checkinteresttally()
+        assert_equal(result["match"], True)
+        assert len(result["tokens"]) > 0
+
+        # Tally is reported per loan token in getloaninfo
+        assert "interest" in self.nodes[0].getloaninfo()
+
     def run_test(self):
         self.setup()
         self.vault_interest_zero()
@@ -1218,6 +1227,7 @@ class NegativeInterestTest(DefiTestFramework):
         self.payback_interests_and_continue_with_negative_interest()
         self.let_loan_be_paid_by_negative_interests()
         self.various_payback_tests()
+        self.check_interest_tally()
 
 
 if __name__ == "__main__":
@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+# Copyright (c) DeFi Blockchain Developers
+# Distributed under the MIT software license, see the accompanying
+# file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+"""Test pool rewards listed from the reward history index."""
+
+from test_framework.test_framework import DefiTestFramework
+from test_framework.util import assert_equal
+
+from decimal import Decimal
+
+
+class RewardHistoryIndexTest(DefiTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 2
+        self.setup_clean_chain = True
+        args = [
+            "-txnotokens=0",
+            "-amkheight=50",
+            "-bayfrontheight=50",
+            "-bayfrontgardensheight=50",
+            "-clarkequayheight=50",
+        ]
+        # Node 0 reads rewards from the index, node 1 recalculates them
+        self.extra_args = [args + ["-rewardhistoryindex=1"], args]
+
+    def run_test(self):
+        self.setup_pool()
+
+        # Rewards of the swapping account are settled while applying the swap
+        swap_height = self.swap()
+        self.nodes[0].generate(5)
+        self.sync_blocks()
+
+        self.check_rewards(swap_height)
+
+    def setup_pool(self):
+        node = self.nodes[0]
+        node.generate(101)
+
+        self.address = node.getnewaddress("", "legacy")
+        node.utxostoaccount({self.address: "1000@DFI"})
+        node.createtoken(
+            {
+                "symbol": "BTC",
+                "name": "BTC token",
+                "isDAT": True,
+                "collateralAddress": self.address,
+            }
+        )
+        node.generate(1)
+
+        node.minttokens(["1000@BTC"])
+        node.createpoolpair(
+            {
+                "tokenA": "BTC",
+                "tokenB": "DFI",
+                "commission": Decimal("0.002"),
+                "status": True,
+                "ownerAddress": self.address,
+                "pairSymbol": "BTC-DFI",
+            }
+        )
+        node.generate(1)
+
+        pool_id = list(node.getpoolpair("BTC-DFI").keys())[0]
+        node.setgov({"LP_SPLITS": {pool_id: 1}, "LP_DAILY_DFI_REWARD": 100})
+        node.addpoolliquidity({self.address: ["100@BTC", "100@DFI"]}, self.address)
+        node.generate(10)
+        self.sync_blocks()
+
+    def swap(self):
+        node = self.nodes[0]
+        node.poolswap(
+            {
+                "from": self.address,
+                "tokenFrom": "DFI",
+                "amountFrom": 1,
+                "to": self.address,
+                "tokenTo": "BTC",
+            }
+        )
+        node.generate(1)
+        return node.getblockcount()
+
+    def rewards(self, node):
+        totals = {}
+        heights = []
+        for entry in node.listaccounthistory(
+            self.address, {"depth": 10000, "limit": 10000}
+        ):
+            if entry["type"] not in ("Rewards", "Commission"):
+                continue
+            heights.append(entry["blockHeight"])
+            for amount in entry["amounts"]:
+                value, token = amount.split("@")
+                totals[token] = totals.get(token, Decimal(0)) + Decimal(value)
+        return totals, heights
+
+    def check_rewards(self, swap_height):
+        indexed, heights = self.rewards(self.nodes[0])
+        recalculated, _ = self.rewards(self.nodes[1])
+
+        assert indexed["DFI"] > 0
+        # Rewards settled by the swap are recorded in the index
+        assert min(heights) <= swap_height
+        assert_equal(indexed, recalculated)
+
+
+if __name__ == "__main__":
+    RewardHistoryIndexTest().main()
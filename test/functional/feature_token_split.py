@@ -756,6 +756,14 @@ class TokenSplitTest(DefiTestFramework):
         )
         self.nodes[0].generate(2)
 
+        # Rewards of the pool's liquidity providers were consolidated at the split
+        stats = self.nodes[0].getrewardconsolidationstats()
+        assert_equal(stats["running"], False)
+        assert_equal(stats["height"], self.nodes[0].getblockcount())
+        assert stats["owners"] > 0
+        assert_equal(stats["completed"], stats["owners"])
+        assert stats["shards"] > 0
+
         # Check token split correctly
         self.check_token_split(
             self.idGOOGL,
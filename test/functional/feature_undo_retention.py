@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+# Copyright (c) DeFi Blockchain Developers
+# Distributed under the MIT software license, see the accompanying
+# file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+"""Test blocks past the -undoretention window can't be disconnected."""
+
+from test_framework.test_framework import DefiTestFramework
+from test_framework.util import assert_equal, assert_raises_rpc_error
+
+RETENTION = 288
+
+
+class UndoRetentionTest(DefiTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 1
+        self.setup_clean_chain = True
+        self.extra_args = [
+            ["-txnotokens=0", "-amkheight=50", f"-undoretention={RETENTION}"]
+        ]
+
+    def run_test(self):
+        node = self.nodes[0]
+        node.generate(101)
+
+        address = node.getnewaddress("", "legacy")
+        node.utxostoaccount({address: "10@DFI"})
+        node.generate(1)
+        account_height = node.getblockcount()
+
+        node.generate(RETENTION + 50)
+        tip = node.getbestblockhash()
+        tip_height = node.getblockcount()
+        pruned_height = tip_height - RETENTION
+
+        # Undo data of the account change is gone, the block can't be reverted
+        assert account_height <= pruned_height
+        assert_raises_rpc_error(
+            -20,
+            "its undo data is beyond -undoretention",
+            node.invalidateblock,
+            node.getblockhash(account_height),
+        )
+        assert_raises_rpc_error(
+            -20,
+            "its undo data is beyond -undoretention",
+            node.invalidateblock,
+            node.getblockhash(pruned_height),
+        )
+        assert_equal(node.getbestblockhash(), tip)
+        assert_equal(node.getaccount(address), ["10.00000000@DFI"])
+
+        # Blocks within the window are still disconnected and reconnected
+        block = node.getblockhash(pruned_height + 1)
+        node.invalidateblock(block)
+        assert_equal(node.getblockcount(), pruned_height)
+        node.reconsiderblock(block)
+        assert_equal(node.getbestblockhash(), tip)
+        assert_equal(node.getaccount(address), ["10.00000000@DFI"])
+
+
+if __name__ == "__main__":
+    UndoRetentionTest().main()
@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+# Copyright (c) DeFi Blockchain Developers
+# Distributed under the MIT software license, see the accompanying
+# file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+"""Test streamed replies of list RPCs."""
+
+from test_framework.test_framework import DefiTestFramework
+from test_framework.util import assert_equal, str_to_b64str
+
+import http.client
+import json
+import urllib.parse
+
+
+class HTTPStreamTest(DefiTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 1
+        self.setup_clean_chain = True
+        self.extra_args = [
+            [
+                "-txnotokens=0",
+                "-amkheight=50",
+                "-bayfrontheight=50",
+                "-rpccache=0",
+            ]
+        ]
+
+    def run_test(self):
+        node = self.nodes[0]
+        node.generate(101)
+
+        self.accounts = [node.getnewaddress("", "legacy") for _ in range(20)]
+        node.utxostoaccount({account: "1@0" for account in self.accounts})
+        node.generate(1)
+
+        self.test_json_stream()
+        self.test_ndjson_stream()
+        self.test_stream_errors()
+        self.test_not_streamed()
+
+    def post(self, body, stream=None):
+        url = urllib.parse.urlparse(self.nodes[0].url)
+        headers = {
+            "Authorization": "Basic "
+            + str_to_b64str(url.username + ":" + url.password),
+        }
+        if stream is not None:
+            headers["x-rpcstream"] = stream
+
+        conn = http.client.HTTPConnection(url.hostname, url.port)
+        conn.request("POST", "/", json.dumps(body), headers)
+        res = conn.getresponse()
+        data = res.read().decode()
+        conn.close()
+        return res, data
+
+    def test_json_stream(self):
+        request = {"method": "listaccounts", "params": [{"limit": 0}, False], "id": 1}
+        plain, expected = self.post(request)
+        res, data = self.post(request, "1")
+
+        assert_equal(res.status, http.client.OK)
+        assert_equal(res.getheader("Transfer-Encoding"), "chunked")
+        assert_equal(res.getheader("Content-Type"), "application/json")
+        # Same bytes as the buffered reply
+        assert_equal(data, expected)
+        assert_equal(len(json.loads(data)["result"]), len(self.accounts))
+
+        # Object results keep their keys
+        request = {"method": "listpoolshares", "params": [], "id": "shares"}
+        _, expected = self.post(request)
+        _, data = self.post(request, "json")
+        assert_equal(data, expected)
+
+    def test_ndjson_stream(self):
+        request = {"method": "listaccounts", "params": [{"limit": 0}, False], "id": 1}
+        res, data = self.post(request, "ndjson")
+
+        assert_equal(res.status, http.client.OK)
+        assert_equal(res.getheader("Content-Type"), "application/x-ndjson")
+        lines = data.splitlines()
+        assert_equal(
+            [json.loads(line) for line in lines],
+            self.nodes[0].listaccounts({"limit": 0}, False),
+        )
+
+    def test_stream_errors(self):
+        # Errors raised before any record is written keep their status
+        request = {"method": "listvaults", "params": [{}, {"start": "zz"}], "id": 1}
+        res, data = self.post(request, "1")
+        assert_equal(res.status, http.client.INTERNAL_SERVER_ERROR)
+        assert json.loads(data)["error"] is not None
+
+    def test_not_streamed(self):
+        # Other methods reply as usual, in NDJSON as a single line
+        request = {"method": "getblockcount", "params": [], "id": 1}
+        res, data = self.post(request, "1")
+        assert_equal(res.getheader("Transfer-Encoding"), None)
+        assert_equal(json.loads(data)["result"], self.nodes[0].getblockcount())
+
+        res, data = self.post(request, "ndjson")
+        assert_equal(data, "{}\n".format(self.nodes[0].getblockcount()))
+
+
+if __name__ == "__main__":
+    HTTPStreamTest().main()
@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+# Copyright (c) DeFi Blockchain Developers
+# Distributed under the MIT software license, see the accompanying
+# file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+"""Test the mempool accounts view rebuild on new blocks.
+
+Entries reading state changed by the block are validated again,
+the others are carried over unchanged. Entries paying out pool rewards
+are validated again on every block.
+"""
+
+from test_framework.test_framework import DefiTestFramework
+from test_framework.util import assert_equal
+
+
+class MempoolAccountsRebuildTest(DefiTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 1
+        self.setup_clean_chain = True
+        self.extra_args = [["-txnotokens=0", "-amkheight=50", "-bayfrontheight=50"]]
+
+    def run_test(self):
+        node = self.nodes[0]
+        node.generate(101)
+
+        self.owner_a = node.getnewaddress("", "legacy")
+        self.owner_c = node.getnewaddress("", "legacy")
+        node.utxostoaccount({self.owner_a: "10@DFI", self.owner_c: "10@DFI"})
+        # Separate auth inputs keep the txs of owner A independent in the mempool
+        for _ in range(2):
+            node.sendtoaddress(self.owner_a, 1)
+        node.sendtoaddress(self.owner_c, 1)
+        node.generate(1)
+
+        self.test_carry_over()
+        self.test_pool_share_holder()
+
+    def auth_inputs(self, owner):
+        return [
+            {"txid": utxo["txid"], "vout": utxo["vout"]}
+            for utxo in self.nodes[0].listunspent(1, 9999999, [owner])
+        ]
+
+    def transfer(self, owner, amount, auth):
+        node = self.nodes[0]
+        return node.accounttoaccount(
+            owner, {node.getnewaddress("", "legacy"): f"{amount}@DFI"}, [auth]
+        )
+
+    def hold_back(self, txid):
+        # Keeps the tx in the mempool while blocks are mined
+        self.nodes[0].prioritisetransaction(txid=txid, fee_delta=-100000000)
+
+    def test_carry_over(self):
+        node = self.nodes[0]
+        auth_a = self.auth_inputs(self.owner_a)
+        auth_c = self.auth_inputs(self.owner_c)
+
+        # Both entries stay in the mempool, the block only spends from A
+        tx_a = self.transfer(self.owner_a, 3, auth_a[0])
+        tx_c = self.transfer(self.owner_c, 3, auth_c[0])
+        self.hold_back(tx_a)
+        self.hold_back(tx_c)
+        tx_block = self.transfer(self.owner_a, 3, auth_a[1])
+
+        before = node.getmempoolinfo()
+        block = node.generate(1)[0]
+        after = node.getmempoolinfo()
+
+        assert tx_block in node.getblock(block)["tx"]
+        assert_equal(sorted(node.getrawmempool()), sorted([tx_a, tx_c]))
+
+        # The entry of A read the balance the block changed, the one of C did not
+        assert_equal(after["defirevalidated"] - before["defirevalidated"], 1)
+        assert_equal(after["defiskipped"] - before["defiskipped"], 1)
+
+        # Carried over and revalidated entries both still apply on top of the block
+        node.prioritisetransaction(txid=tx_a, fee_delta=100000000)
+        node.prioritisetransaction(txid=tx_c, fee_delta=100000000)
+        node.generate(1)
+        assert_equal(node.getrawmempool(), [])
+        assert_equal(node.getaccount(self.owner_a), ["4.00000000@DFI"])
+        assert_equal(node.getaccount(self.owner_c), ["7.00000000@DFI"])
+
+    def test_pool_share_holder(self):
+        node = self.nodes[0]
+        collateral = node.getnewaddress("", "legacy")
+        node.createtoken(
+            {"symbol": "GOLD", "name": "gold", "collateralAddress": collateral}
+        )
+        node.generate(1)
+        token_id = next(
+            idx for idx, token in node.listtokens().items() if token["symbol"] == "GOLD"
+        )
+        gold = "GOLD#" + token_id
+        node.minttokens(["100@" + gold])
+        node.generate(1)
+        node.createpoolpair(
+            {
+                "tokenA": gold,
+                "tokenB": "DFI",
+                "commission": 0,
+                "status": True,
+                "ownerAddress": collateral,
+            }
+        )
+        node.generate(1)
+
+        owner_s = node.getnewaddress("", "legacy")
+        node.accounttoaccount(collateral, {owner_s: "10@" + gold})
+        node.utxostoaccount({owner_s: "10@DFI"})
+        node.generate(1)
+        node.addpoolliquidity({owner_s: ["5@" + gold, "5@DFI"]}, owner_s)
+        node.sendtoaddress(owner_s, 1)
+        node.sendtoaddress(self.owner_a, 1)
+        node.generate(1)
+        assert_equal(node.getmempoolinfo()["size"], 0)
+
+        # The block doesn't touch the share holder, its rewards move with the height
+        tx_s = self.transfer(owner_s, 1, self.auth_inputs(owner_s)[0])
+        self.hold_back(tx_s)
+        self.transfer(self.owner_a, 1, self.auth_inputs(self.owner_a)[0])
+
+        before = node.getmempoolinfo()
+        node.generate(1)
+        after = node.getmempoolinfo()
+
+        assert_equal(node.getrawmempool(), [tx_s])
+        assert_equal(after["defirevalidated"] - before["defirevalidated"], 1)
+        assert_equal(after["defiskipped"] - before["defiskipped"], 0)
+
+        node.prioritisetransaction(txid=tx_s, fee_delta=100000000)
+        node.generate(1)
+        assert_equal(node.getrawmempool(), [])
+
+
+if __name__ == "__main__":
+    MempoolAccountsRebuildTest().main()
@@ -34,6 +34,20 @@ class RpcMiscTest(DefiTestFramework):
         assert_greater_than(memory["chunks_free"], 0)
         assert_equal(memory["used"] + memory["free"], memory["total"])
 
+        snapshots = node.getmemoryinfo()["snapshots"]
+        assert_greater_than_or_equal(snapshots["layers"], 0)
+        assert_greater_than_or_equal(snapshots["used"], 0)
+        assert_equal(
+            sorted(snapshots["checkedout"].keys()), ["history", "vault", "view"]
+        )
+
+        self.log.info("test getthreadpoolstats")
+        stats = node.getthreadpoolstats()
+        assert_greater_than(stats["threads"], 0)
+        for priority in ["consensus", "rpc"]:
+            assert_equal(sorted(stats[priority].keys()), ["completed", "posted"])
+        assert_greater_than_or_equal(stats["stolen"], 0)
+
         self.log.info("test mallocinfo")
         try:
             mallocinfo = node.getmemoryinfo(mode="mallocinfo")
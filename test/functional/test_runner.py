@@ -204,13 +204,17 @@ BASE_SCRIPTS = [
     "feature_future_swap_limitation.py",
     "feature_poolswap_mechanism.py",
     "feature_poolswap_mainnet.py",
+    "feature_reward_history_index.py",
     "feature_prevent_bad_tx_propagation.py",
     "feature_masternode_operator.py",
     "feature_mine_cached.py",
     "feature_mempool_dakota.py",
+    "mempool_accounts_rebuild.py",
+    "feature_undo_retention.py",
     "interface_http.py",
     "interface_http_cors.py",
     "interface_http_cors_wildcard.py",
+    "interface_http_stream.py",
     "interface_rpc.py",
     "rpc_psbt.py",
     "rpc_users.py",